@@ -4,6 +4,14 @@ set -xe
 
 CC=cc
 CFLAGS="-Wall -Wextra -std=c11 -pedantic -ggdb -I./include/"
-LIBS="-lglfw -lGL -lm"
+LIBS="-lglfw -lGL -lm -lpthread"
 
 $CC $CFLAGS -o main main.c $LIBS
+$CC $CFLAGS -DBENCH -o bench main.c $LIBS
+$CC $CFLAGS -DSTRESS -o stress main.c $LIBS
+$CC $CFLAGS -O2 -ffp-contract=off -o la_bench la_bench.c -lm
+$CC $CFLAGS -O2 -ffp-contract=off -DLA_SIMD -march=native -o la_bench_simd la_bench.c -lm
+$CC $CFLAGS -O2 -o conf_bench conf_bench.c
+$CC $CFLAGS -O2 -DSV_SIMD -march=native -o conf_bench_simd conf_bench.c
+$CC $CFLAGS -O2 -o sv_check sv_check.c
+$CC $CFLAGS -O2 -DSV_SIMD -march=native -o sv_check_simd sv_check.c
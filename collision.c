@@ -0,0 +1,121 @@
+// Collision detection between the entries of a Grid.
+//
+// Broad phase: for every entry only the 3x3 neighbourhood of its cell is
+// visited, which finds all of the overlapping pairs as long as the cell size
+// is not smaller than the size of the boxes. The cost is linear in the
+// amount of entries (plus the amount of candidate pairs).
+//
+// Narrow phase: the candidate pairs are tested against the actual boxes 4 at
+// a time with SSE when it is available and compacted in place.
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define COLLISION_SSE2
+#include <emmintrin.h>
+#endif
+
+typedef struct {
+    uint32_t a, b;
+} Collision_Pair;
+
+typedef struct {
+    Collision_Pair *items;
+    size_t count;
+    size_t capacity;
+} Collision_Pairs;
+
+typedef struct {
+    size_t candidates;
+    size_t hits;
+    double broad_phase_secs;
+    double narrow_phase_secs;
+} Collision_Stats;
+
+static void collision_pairs_push(Collision_Pairs *pairs, uint32_t a, uint32_t b)
+{
+    if (pairs->count >= pairs->capacity) {
+        size_t capacity = pairs->capacity == 0 ? 1024 : pairs->capacity * 2;
+        Collision_Pair *items = realloc(pairs->items, capacity * sizeof(*pairs->items));
+        if (items == NULL) {
+            fprintf(stderr, "ERROR: could not allocate %zu collision pairs: %s\n",
+                    capacity, strerror(errno));
+            exit(1);
+        }
+        pairs->items = items;
+        pairs->capacity = capacity;
+    }
+    pairs->items[pairs->count].a = a;
+    pairs->items[pairs->count].b = b;
+    pairs->count += 1;
+}
+
+// Collects every pair of entries (a < b) that share a cell or live in
+// adjacent cells. The grid cell size must be at least the full size of the
+// boxes for this to not miss anything.
+void collision_broad_phase(const Grid *g, Collision_Pairs *candidates)
+{
+    candidates->count = 0;
+    for (uint32_t a = 0; a < g->entries_count; ++a) {
+        const Grid_Entry *ea = &g->entries[a];
+        if (ea->bucket == GRID_NIL) continue;
+
+        for (int32_t dy = -1; dy <= 1; ++dy) {
+            for (int32_t dx = -1; dx <= 1; ++dx) {
+                int32_t cx = ea->cx + dx;
+                int32_t cy = ea->cy + dy;
+                uint32_t bucket = grid_cell_hash(g, cx, cy);
+                for (uint32_t b = g->buckets[bucket]; b != GRID_NIL; b = g->entries[b].next) {
+                    const Grid_Entry *eb = &g->entries[b];
+                    if (b <= a || eb->cx != cx || eb->cy != cy) continue;
+                    collision_pairs_push(candidates, a, b);
+                }
+            }
+        }
+    }
+}
+
+static bool collision_test_pair(const Grid *g, Collision_Pair pair, float size)
+{
+    const Grid_Entry *ea = &g->entries[pair.a];
+    const Grid_Entry *eb = &g->entries[pair.b];
+    return fabsf(ea->x - eb->x) < size && fabsf(ea->y - eb->y) < size;
+}
+
+// Keeps only the pairs whose boxes actually overlap. All the boxes have the
+// same half-extent `half_size` around the centers stored in the grid.
+// Returns the amount of the remaining pairs.
+size_t collision_narrow_phase(const Grid *g, float half_size, Collision_Pairs *pairs)
+{
+    float size = half_size * 2.0f;
+    size_t hits = 0;
+    size_t i = 0;
+
+#ifdef COLLISION_SSE2
+    const __m128 sizes = _mm_set1_ps(size);
+    const __m128 abs_mask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+    for (; i + 4 <= pairs->count; i += 4) {
+        const Collision_Pair *p = &pairs->items[i];
+        __m128 ax = _mm_setr_ps(g->entries[p[0].a].x, g->entries[p[1].a].x, g->entries[p[2].a].x, g->entries[p[3].a].x);
+        __m128 ay = _mm_setr_ps(g->entries[p[0].a].y, g->entries[p[1].a].y, g->entries[p[2].a].y, g->entries[p[3].a].y);
+        __m128 bx = _mm_setr_ps(g->entries[p[0].b].x, g->entries[p[1].b].x, g->entries[p[2].b].x, g->entries[p[3].b].x);
+        __m128 by = _mm_setr_ps(g->entries[p[0].b].y, g->entries[p[1].b].y, g->entries[p[2].b].y, g->entries[p[3].b].y);
+        __m128 dx = _mm_and_ps(_mm_sub_ps(ax, bx), abs_mask);
+        __m128 dy = _mm_and_ps(_mm_sub_ps(ay, by), abs_mask);
+        int mask = _mm_movemask_ps(_mm_and_ps(_mm_cmplt_ps(dx, sizes), _mm_cmplt_ps(dy, sizes)));
+
+        // Compacting in place is safe: hits never overtakes i
+        Collision_Pair batch[4] = {p[0], p[1], p[2], p[3]};
+        for (int k = 0; k < 4; ++k) {
+            if (mask & (1 << k)) pairs->items[hits++] = batch[k];
+        }
+    }
+#endif // COLLISION_SSE2
+
+    for (; i < pairs->count; ++i) {
+        if (collision_test_pair(g, pairs->items[i], size)) {
+            pairs->items[hits++] = pairs->items[i];
+        }
+    }
+
+    pairs->count = hits;
+    return hits;
+}
@@ -0,0 +1,274 @@
+// Two-stage tokenizer of render.conf, after simdjson.
+//
+// Stage 1 classifies the input 64 bytes at a time into the bitmasks of the
+// newlines, the `=` and the whitespace (SSE2 or AVX2 when SV_SIMD is
+// defined, see sv.h, 8 bytes at a time in a 64-bit register otherwise). The
+// first non-whitespace character after every newline and `=` is found without
+// looking at the bytes again: adding 1 right after the newline or `=` to the
+// whitespace mask carries through the run of the whitespace that follows and
+// stops at the first bit that is not set. All of these positions are
+// flattened into an array of indices.
+//
+// Stage 2 walks only the indices. Every line starts at the index of its first
+// non-whitespace character, which tells whether it is empty or a comment (`#`).
+// The key ends at the next index (`=` or the newline), the value starts at the
+// one after it and ends at the next newline. Only the trailing whitespace of
+// the key and the value is trimmed by looking at the bytes.
+//
+// The entries are exactly the same as splitting the input by '\n', trimming
+// the lines, skipping the empty ones and the ones starting with `#`, and then
+// splitting them by the first `=` and trimming both sides.
+
+typedef struct {
+    String_View key;
+    String_View value;
+    // Line of the entry starting from 0 and the beginning of that line
+    int row;
+    const char *line_start;
+} Conf_Entry;
+
+typedef struct {
+    Conf_Entry *entries;
+    size_t entries_count;
+    size_t entries_capacity;
+
+    // Output of the stage 1, the last index is the size of the input
+    uint32_t *indices;
+    size_t indices_count;
+    size_t indices_capacity;
+} Conf;
+
+typedef struct {
+    uint64_t newline;
+    uint64_t equals;
+    // Whitespace as in isspace() without the newline
+    uint64_t space;
+} Conf_Block;
+
+#define CONF_BLOCK_SIZE 64
+
+static bool conf_is_space(char c)
+{
+    return c == ' ' || c == '\t' || c == '\v' || c == '\f' || c == '\r';
+}
+
+static size_t conf_ctz64(uint64_t x)
+{
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward64(&index, x);
+    return index;
+#else
+    return (size_t) __builtin_ctzll(x);
+#endif // _MSC_VER
+}
+
+#if !SV_SSE2 && SV__LITTLE_ENDIAN
+#define CONF_SWAR_ONES 0x0101010101010101ULL
+#define CONF_SWAR_LOW7 0x7F7F7F7F7F7F7F7FULL
+
+// 0x80 in the bytes of `word` that are equal to `c`
+static uint64_t conf_swar_eq(uint64_t word, char c)
+{
+    uint64_t x = word ^ (CONF_SWAR_ONES * (unsigned char) c);
+    return ~(((x & CONF_SWAR_LOW7) + CONF_SWAR_LOW7) | x | CONF_SWAR_LOW7);
+}
+
+// The high bits of the 8 bytes as 8 bits
+static uint64_t conf_swar_movemask(uint64_t bytes)
+{
+    return (((bytes >> 7) & CONF_SWAR_ONES) * 0x0102040810204080ULL) >> 56;
+}
+#endif // !SV_SSE2 && SV__LITTLE_ENDIAN
+
+static void conf_classify(const char *block, Conf_Block *masks)
+{
+    memset(masks, 0, sizeof(*masks));
+#if SV_AVX2
+    for (size_t i = 0; i < CONF_BLOCK_SIZE; i += 32) {
+        __m256i chunk = _mm256_loadu_si256((const __m256i*) (block + i));
+        __m256i newline = _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('\n'));
+        __m256i equals = _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('='));
+        // '\t'..'\r' are the only bytes whose distance from '\t' is at most 4
+        __m256i distance = _mm256_sub_epi8(chunk, _mm256_set1_epi8('\t'));
+        __m256i control = _mm256_cmpeq_epi8(_mm256_min_epu8(distance, _mm256_set1_epi8(4)), distance);
+        __m256i space = _mm256_or_si256(_mm256_cmpeq_epi8(chunk, _mm256_set1_epi8(' ')),
+                                        _mm256_andnot_si256(newline, control));
+        masks->newline |= (uint64_t) (uint32_t) _mm256_movemask_epi8(newline) << i;
+        masks->equals |= (uint64_t) (uint32_t) _mm256_movemask_epi8(equals) << i;
+        masks->space |= (uint64_t) (uint32_t) _mm256_movemask_epi8(space) << i;
+    }
+#elif SV_SSE2
+    for (size_t i = 0; i < CONF_BLOCK_SIZE; i += 16) {
+        __m128i chunk = _mm_loadu_si128((const __m128i*) (block + i));
+        __m128i newline = _mm_cmpeq_epi8(chunk, _mm_set1_epi8('\n'));
+        __m128i equals = _mm_cmpeq_epi8(chunk, _mm_set1_epi8('='));
+        // '\t'..'\r' are the only bytes whose distance from '\t' is at most 4
+        __m128i distance = _mm_sub_epi8(chunk, _mm_set1_epi8('\t'));
+        __m128i control = _mm_cmpeq_epi8(_mm_min_epu8(distance, _mm_set1_epi8(4)), distance);
+        __m128i space = _mm_or_si128(_mm_cmpeq_epi8(chunk, _mm_set1_epi8(' ')),
+                                     _mm_andnot_si128(newline, control));
+        masks->newline |= (uint64_t) (uint32_t) _mm_movemask_epi8(newline) << i;
+        masks->equals |= (uint64_t) (uint32_t) _mm_movemask_epi8(equals) << i;
+        masks->space |= (uint64_t) (uint32_t) _mm_movemask_epi8(space) << i;
+    }
+#elif SV__LITTLE_ENDIAN
+    for (size_t i = 0; i < CONF_BLOCK_SIZE; i += 8) {
+        uint64_t word;
+        memcpy(&word, block + i, sizeof(word));
+        uint64_t space = conf_swar_eq(word, ' ') | conf_swar_eq(word, '\t') | conf_swar_eq(word, '\v')
+            | conf_swar_eq(word, '\f') | conf_swar_eq(word, '\r');
+        masks->newline |= conf_swar_movemask(conf_swar_eq(word, '\n')) << i;
+        masks->equals |= conf_swar_movemask(conf_swar_eq(word, '=')) << i;
+        masks->space |= conf_swar_movemask(space) << i;
+    }
+#else
+    for (size_t i = 0; i < CONF_BLOCK_SIZE; ++i) {
+        masks->newline |= (uint64_t) (block[i] == '\n') << i;
+        masks->equals |= (uint64_t) (block[i] == '=') << i;
+        masks->space |= (uint64_t) conf_is_space(block[i]) << i;
+    }
+#endif // SV_AVX2
+}
+
+static bool conf_reserve_indices(Conf *conf, size_t count)
+{
+    if (count <= conf->indices_capacity) return true;
+    size_t capacity = conf->indices_capacity > 0 ? conf->indices_capacity : 1024;
+    while (capacity < count) capacity *= 2;
+    uint32_t *indices = realloc(conf->indices, capacity * sizeof(*indices));
+    if (indices == NULL) return false;
+    conf->indices = indices;
+    conf->indices_capacity = capacity;
+    return true;
+}
+
+// Stage 1: the offsets of the newlines, the `=` and the first non-whitespace
+// characters after them (and at the beginning of the input) in increasing order
+static bool conf_find_indices(Conf *conf, String_View input)
+{
+    conf->indices_count = 0;
+    // The first line starts just like the ones after a newline
+    uint64_t start_carry = 1;
+    uint64_t add_carry = 0;
+    for (size_t offset = 0; offset < input.count; offset += CONF_BLOCK_SIZE) {
+        const char *block = input.data + offset;
+        size_t size = input.count - offset;
+        char tail[CONF_BLOCK_SIZE];
+        if (size < CONF_BLOCK_SIZE) {
+            memset(tail, 0, sizeof(tail));
+            memcpy(tail, block, size);
+            block = tail;
+        }
+
+        Conf_Block masks;
+        conf_classify(block, &masks);
+
+        uint64_t markers = masks.newline | masks.equals;
+        uint64_t starts = (markers << 1) | start_carry;
+        start_carry = markers >> 63;
+        uint64_t sum = masks.space + starts;
+        uint64_t carry = sum < starts;
+        sum += add_carry;
+        carry |= sum < add_carry;
+        add_carry = carry;
+        uint64_t structurals = markers | (sum & ~masks.space);
+        if (size < CONF_BLOCK_SIZE) structurals &= ((uint64_t) 1 << size) - 1;
+
+        if (!conf_reserve_indices(conf, conf->indices_count + CONF_BLOCK_SIZE + 1)) return false;
+        while (structurals != 0) {
+            conf->indices[conf->indices_count++] = (uint32_t) (offset + conf_ctz64(structurals));
+            structurals &= structurals - 1;
+        }
+    }
+
+    if (!conf_reserve_indices(conf, conf->indices_count + 1)) return false;
+    conf->indices[conf->indices_count++] = (uint32_t) input.count;
+    return true;
+}
+
+static bool conf_push_entry(Conf *conf, Conf_Entry entry)
+{
+    if (conf->entries_count >= conf->entries_capacity) {
+        size_t capacity = conf->entries_capacity > 0 ? conf->entries_capacity * 2 : 64;
+        Conf_Entry *entries = realloc(conf->entries, capacity * sizeof(*entries));
+        if (entries == NULL) return false;
+        conf->entries = entries;
+        conf->entries_capacity = capacity;
+    }
+    conf->entries[conf->entries_count++] = entry;
+    return true;
+}
+
+static String_View conf_trim_right(const char *data, size_t begin, size_t end)
+{
+    while (end > begin && conf_is_space(data[end - 1])) end -= 1;
+    return sv_from_parts(data + begin, end - begin);
+}
+
+// Tokenizes `input` into `conf->entries`. The entries point into `input`.
+bool conf_parse(Conf *conf, String_View input)
+{
+    conf->entries_count = 0;
+    if (input.count >= UINT32_MAX) {
+        fprintf(stderr, "ERROR: the config is too large: %zu bytes\n", input.count);
+        return false;
+    }
+    if (!conf_find_indices(conf, input)) {
+        fprintf(stderr, "ERROR: could not allocate memory for the config indices: %s\n", strerror(errno));
+        return false;
+    }
+
+    // Stage 2
+    const char *data = input.data;
+    const uint32_t *index = conf->indices;
+    size_t n = input.count;
+    int row = 0;
+    // The indices can only end with the newlines or the end of the input
+#define CONF_LINE_END(i) ((i) == n || data[i] == '\n')
+    for (size_t line_start = 0; line_start < n; row++) {
+        size_t first = *index++;
+        if (CONF_LINE_END(first)) {
+            line_start = first + 1;
+            continue;
+        }
+        if (data[first] == '#') {
+            while (!CONF_LINE_END(*index)) index++;
+            line_start = *index++ + 1;
+            continue;
+        }
+
+        Conf_Entry entry = {0};
+        entry.row = row;
+        entry.line_start = data + line_start;
+
+        // A line may start with `=`, then it is both the first character and the end of the key
+        size_t key_end = data[first] == '=' ? first : *index++;
+        entry.key = conf_trim_right(data, first, key_end);
+        size_t line_end = key_end;
+        if (!CONF_LINE_END(key_end)) {
+            size_t value_start = *index++;
+            line_end = value_start;
+            while (!CONF_LINE_END(line_end)) line_end = *index++;
+            entry.value = conf_trim_right(data, value_start, line_end);
+        } else {
+            entry.value = sv_from_parts(data + key_end, 0);
+        }
+
+        if (!conf_push_entry(conf, entry)) {
+            fprintf(stderr, "ERROR: could not allocate memory for the config entries: %s\n", strerror(errno));
+            return false;
+        }
+        line_start = line_end + 1;
+    }
+#undef CONF_LINE_END
+
+    return true;
+}
+
+void conf_free(Conf *conf)
+{
+    free(conf->entries);
+    free(conf->indices);
+    memset(conf, 0, sizeof(*conf));
+}
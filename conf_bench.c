@@ -0,0 +1,246 @@
+// Checks and throughput of the render.conf tokenizer (conf.c).
+//
+// The entries of the tokenizer are compared against the line by line
+// splitting that reload_render_conf() used before it over the edge cases
+// below, random inputs made of the structural characters and a generated
+// config with the lines of all the kinds render.conf has. Any mismatch is
+// reported and conf_bench exits with 1 before measuring anything. Then both
+// are timed on the generated config of the given size.
+//
+// Build it with and without -DSV_SIMD to check and measure both paths.
+//
+// Usage: ./conf_bench [megabytes], 0 megabytes only runs the checks.
+
+#include <errno.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define SV_IMPLEMENTATION
+#include "sv.h"
+#include "conf.c"
+
+#define ARRAY_LEN(xs) (sizeof(xs) / sizeof((xs)[0]))
+#define DEFAULT_MEGABYTES 16
+#define REPETITIONS 5
+#define RANDOM_INPUTS 100000
+#define FAILURES_PRINTED 20
+
+static const char *edge_cases[] = {
+    "",
+    "\n",
+    "\n\n\n",
+    "a",
+    "=",
+    "a=",
+    "=b",
+    "a = b",
+    " \t a \t = \t b \t ",
+    "a = b = c",
+    "a == b",
+    "a =\n",
+    "a = \r\n",
+    "# a = b\n  # c\nd = e",
+    "a # b = c # d",
+    "   \n \t \n",
+    "key\r\nkey = value\r\n",
+    "\v\f a \v\f = \v\f b \v\f",
+    // Whitespace runs across the blocks of 64 bytes
+    "a =                                                              b\n"
+    "                                                                                c = d",
+    "                                                               =",
+    "                                                                =",
+    "                                                               \n                                                                x",
+};
+
+// The reference: reload_render_conf() before the tokenizer
+static void reference_parse(String_View content, Conf_Entry **entries, size_t *count, size_t *capacity)
+{
+    *count = 0;
+    for (int row = 0; content.count > 0; row++) {
+        String_View line = sv_chop_by_delim(&content, '\n');
+        const char *line_start = line.data;
+        line = sv_trim_left(line);
+
+        if (line.count > 0 && line.data[0] != '#') {
+            String_View key = sv_trim(sv_chop_by_delim(&line, '='));
+            String_View value = sv_trim(line);
+            if (*count >= *capacity) {
+                *capacity = *capacity > 0 ? *capacity * 2 : 64;
+                *entries = realloc(*entries, *capacity * sizeof(**entries));
+                if (*entries == NULL) {
+                    fprintf(stderr, "ERROR: could not allocate memory for the reference entries\n");
+                    exit(1);
+                }
+            }
+            (*entries)[(*count)++] = (Conf_Entry) {key, value, row, line_start};
+        }
+    }
+}
+
+static size_t failures = 0;
+static Conf conf = {0};
+static Conf_Entry *expected = NULL;
+static size_t expected_count = 0;
+static size_t expected_capacity = 0;
+
+static bool same_sv(String_View a, String_View b)
+{
+    return a.data == b.data && a.count == b.count;
+}
+
+static void check_input(const char *name, String_View input)
+{
+    reference_parse(input, &expected, &expected_count, &expected_capacity);
+    if (!conf_parse(&conf, input)) exit(1);
+
+    bool ok = conf.entries_count == expected_count;
+    size_t i = 0;
+    for (; ok && i < expected_count; ++i) {
+        const Conf_Entry *a = &conf.entries[i];
+        const Conf_Entry *b = &expected[i];
+        ok = same_sv(a->key, b->key) && same_sv(a->value, b->value)
+            && a->row == b->row && a->line_start == b->line_start;
+    }
+    if (ok) return;
+
+    if (failures < FAILURES_PRINTED) {
+        fprintf(stderr, "FAIL: %s: %zu entries, expected %zu", name, conf.entries_count, expected_count);
+        if (i > 0 && i <= expected_count && i <= conf.entries_count) {
+            const Conf_Entry *a = &conf.entries[i - 1];
+            const Conf_Entry *b = &expected[i - 1];
+            fprintf(stderr, ", entry %zu is %d:`"SV_Fmt"`=`"SV_Fmt"`, expected %d:`"SV_Fmt"`=`"SV_Fmt"`",
+                    i - 1, a->row, SV_Arg(a->key), SV_Arg(a->value), b->row, SV_Arg(b->key), SV_Arg(b->value));
+        }
+        fprintf(stderr, "\n");
+    }
+    failures += 1;
+}
+
+static uint64_t random_state = 0x9E3779B97F4A7C15ULL;
+
+static uint64_t random_next(void)
+{
+    random_state ^= random_state << 13;
+    random_state ^= random_state >> 7;
+    random_state ^= random_state << 17;
+    return random_state;
+}
+
+static void check_random(void)
+{
+    static const char alphabet[] = {' ', ' ', '\t', '\r', '\n', '\n', '=', '#', 'a', 'b'};
+    char buffer[300];
+    for (size_t i = 0; i < RANDOM_INPUTS; ++i) {
+        size_t size = random_next() % sizeof(buffer);
+        for (size_t j = 0; j < size; ++j) {
+            buffer[j] = alphabet[random_next() % ARRAY_LEN(alphabet)];
+        }
+        check_input("random", sv_from_parts(buffer, size));
+    }
+}
+
+// Lines like the ones of render.conf and bench/*.conf
+static char *generate_config(size_t size)
+{
+    static const char *lines[] = {
+        "# Objects\n",
+        "\n",
+        "vert[POST%zu] = shaders/screen.vert\n",
+        "frag[POST%zu] = shaders/blur.frag\n",
+        "input[COMPOSE%zu] = SCENE BRIGHT BLOOM\n",
+        "output[BLOOM%zu] = BRIGHT\n",
+        "object_size = %zu.25\n",
+        "    rotate_speed   =   1.%zu  \r\n",
+        "objects_count = %zu\n",
+        "\ttexture = assets/tsodinW-345.png # %zu\n",
+        "resolution_min_scale=0.%zu\n",
+    };
+
+    char *config = malloc(size + 1);
+    if (config == NULL) {
+        fprintf(stderr, "ERROR: could not allocate %zu bytes for the config\n", size);
+        exit(1);
+    }
+    size_t count = 0;
+    for (size_t i = 0; count < size; ++i) {
+        char line[128];
+        int n = snprintf(line, sizeof(line), lines[i % ARRAY_LEN(lines)], i);
+        size_t copied = (size_t) n < size - count ? (size_t) n : size - count;
+        memcpy(config + count, line, copied);
+        count += copied;
+    }
+    config[size] = '\0';
+    return config;
+}
+
+static double now_secs(void)
+{
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double) ts.tv_sec + (double) ts.tv_nsec * 1e-9;
+}
+
+// The best of REPETITIONS runs
+static void bench(const char *name, String_View input, bool tokenizer)
+{
+    double best = 0.0;
+    size_t entries = 0;
+    for (size_t i = 0; i < REPETITIONS; ++i) {
+        double start = now_secs();
+        if (tokenizer) {
+            if (!conf_parse(&conf, input)) exit(1);
+            entries = conf.entries_count;
+        } else {
+            reference_parse(input, &expected, &expected_count, &expected_capacity);
+            entries = expected_count;
+        }
+        double secs = now_secs() - start;
+        if (i == 0 || secs < best) best = secs;
+    }
+    printf("%-24s %9.1f MB/s %9.2f ms %9zu entries\n",
+           name, (double) input.count / best / 1e6, best * 1e3, entries);
+}
+
+int main(int argc, char **argv)
+{
+    size_t megabytes = DEFAULT_MEGABYTES;
+    if (argc > 1) {
+        char *end = NULL;
+        long long n = strtoll(argv[1], &end, 10);
+        if (end == argv[1] || *end != '\0' || n < 0 || n > 4000) {
+            fprintf(stderr, "Usage: %s [megabytes]\n", argv[0]);
+            fprintf(stderr, "ERROR: invalid size of the config `%s`\n", argv[1]);
+            return 1;
+        }
+        megabytes = (size_t) n;
+    }
+
+    printf("conf.c paths: SSE2=%d AVX2=%d\n", SV_SSE2, SV_AVX2);
+
+    for (size_t i = 0; i < ARRAY_LEN(edge_cases); ++i) {
+        check_input(edge_cases[i], sv_from_cstr(edge_cases[i]));
+    }
+    check_random();
+    char *small = generate_config(100000);
+    check_input("generated", sv_from_cstr(small));
+    free(small);
+    if (failures > 0) {
+        fprintf(stderr, "ERROR: %zu checks of conf.c failed\n", failures);
+        return 1;
+    }
+    printf("All checks passed\n");
+    if (megabytes == 0) return 0;
+
+    size_t size = megabytes * 1000 * 1000;
+    char *config = generate_config(size);
+    String_View input = sv_from_parts(config, size);
+    bench("line by line", input, false);
+    bench("two-stage tokenizer", input, true);
+    free(config);
+
+    return 0;
+}
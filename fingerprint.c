@@ -0,0 +1,22 @@
+// 64-bit fingerprints of everything a render pass depends on.
+//
+// Not a cryptographic hash, it only has to notice that something has changed
+// between the frames. Only the small values are hashed, the big data (like the
+// vertex buffer) is represented by the counters of its changes.
+
+#define FINGERPRINT_SEED 0xcbf29ce484222325ULL
+
+uint64_t fingerprint_u64(uint64_t h, uint64_t x)
+{
+    h ^= x;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    return h;
+}
+
+uint64_t fingerprint_f32(uint64_t h, float x)
+{
+    uint32_t bits;
+    memcpy(&bits, &x, sizeof(bits));
+    return fingerprint_u64(h, bits);
+}
@@ -31,6 +31,14 @@ static PFNGLCHECKFRAMEBUFFERSTATUSPROC glCheckFramebufferStatus = NULL;
 static PFNGLUNIFORM1IPROC glUniform1i = NULL;
 static PFNGLDRAWBUFFERSPROC glDrawBuffers = NULL;
 static PFNGLUNIFORM4FPROC glUniform4f = NULL;
+static PFNGLUNIFORMMATRIX3FVPROC glUniformMatrix3fv = NULL;
+static PFNGLGENQUERIESPROC glGenQueries = NULL;
+static PFNGLDELETEQUERIESPROC glDeleteQueries = NULL;
+static PFNGLBEGINQUERYPROC glBeginQuery = NULL;
+static PFNGLENDQUERYPROC glEndQuery = NULL;
+static PFNGLGETQUERYOBJECTIVPROC glGetQueryObjectiv = NULL;
+static PFNGLGETQUERYOBJECTUI64VPROC glGetQueryObjectui64v = NULL;
+static PFNGLTEXSTORAGE2DPROC glTexStorage2D = NULL;
 // TODO: there is something fishy with Windows gl.h header
 // Let's try to ship our own gl.h just like glext.h
 #ifdef _WIN32
@@ -72,6 +80,12 @@ static void load_gl_extensions(void)
     glUniform1i               = (PFNGLUNIFORM1IPROC) glfwGetProcAddress("glUniform1i");
     glDrawBuffers             = (PFNGLDRAWBUFFERSPROC) glfwGetProcAddress("glDrawBuffers");
     glUniform4f               = (PFNGLUNIFORM4FPROC) glfwGetProcAddress("glUniform4f");
+    glUniformMatrix3fv        = (PFNGLUNIFORMMATRIX3FVPROC) glfwGetProcAddress("glUniformMatrix3fv");
+    glGenQueries              = (PFNGLGENQUERIESPROC) glfwGetProcAddress("glGenQueries");
+    glDeleteQueries           = (PFNGLDELETEQUERIESPROC) glfwGetProcAddress("glDeleteQueries");
+    glBeginQuery              = (PFNGLBEGINQUERYPROC) glfwGetProcAddress("glBeginQuery");
+    glEndQuery                = (PFNGLENDQUERYPROC) glfwGetProcAddress("glEndQuery");
+    glGetQueryObjectiv        = (PFNGLGETQUERYOBJECTIVPROC) glfwGetProcAddress("glGetQueryObjectiv");
 #ifdef _WIN32
     glActiveTexture           = (PFNGLACTIVETEXTUREPROC) glfwGetProcAddress("glActiveTexture");
 #endif // _WIN32
@@ -83,6 +97,20 @@ static void load_gl_extensions(void)
         fprintf(stderr, "WARN: ARB_debug_output is NOT supported\n");
     }
 
+    if (glfwExtensionSupported("GL_ARB_timer_query")) {
+        fprintf(stderr, "INFO: ARB_timer_query is supported\n");
+        glGetQueryObjectui64v = (PFNGLGETQUERYOBJECTUI64VPROC) glfwGetProcAddress("glGetQueryObjectui64v");
+    } else {
+        fprintf(stderr, "WARN: ARB_timer_query is NOT supported\n");
+    }
+
+    if (glfwExtensionSupported("GL_ARB_texture_storage")) {
+        fprintf(stderr, "INFO: ARB_texture_storage is supported\n");
+        glTexStorage2D = (PFNGLTEXSTORAGE2DPROC) glfwGetProcAddress("glTexStorage2D");
+    } else {
+        fprintf(stderr, "WARN: ARB_texture_storage is NOT supported\n");
+    }
+
     if (glfwExtensionSupported("GL_EXT_draw_instanced")) {
         fprintf(stderr, "INFO: EXT_draw_instanced is supported\n");
         glDrawArraysInstanced = (PFNGLDRAWARRAYSINSTANCEDPROC) glfwGetProcAddress("glDrawArraysInstanced");
@@ -0,0 +1,168 @@
+// Render graph of the passes declared in render.conf.
+//
+// Every pass reads a list of named resources and writes a single named
+// resource. A resource is written by exactly one pass and may only be read
+// by the passes declared after it. The pass that writes SCREEN draws into the
+// window. Without explicit inputs and outputs the passes form a linear chain:
+// every pass reads the output of the previous one, writes the resource named
+// after itself, and the last pass writes SCREEN.
+//
+// graph_compile() culls the passes that do not contribute to SCREEN, computes
+// the lifetime of every resource (from the pass that writes it to the last
+// pass that reads it) and assigns the resources to physical render targets.
+// Resources whose lifetimes do not overlap share the same target, so a linear
+// chain of any length ping-pongs between two of them.
+
+#define GRAPH_PASSES_CAP 16
+#define GRAPH_INPUTS_CAP 4
+#define GRAPH_TARGETS_CAP GRAPH_PASSES_CAP
+#define GRAPH_SCREEN ((size_t) -1)
+#define GRAPH_SCREEN_NAME "SCREEN"
+
+typedef struct {
+    String_View name;
+    String_View inputs[GRAPH_INPUTS_CAP];
+    size_t inputs_count;
+    bool inputs_declared;
+    String_View output;
+    bool output_declared;
+} Graph_Pass;
+
+// A pass that survived the culling with its resources resolved to the targets
+typedef struct {
+    size_t pass;
+    size_t inputs[GRAPH_INPUTS_CAP];
+    size_t inputs_count;
+    // Index of the target or GRAPH_SCREEN
+    size_t output;
+} Graph_Step;
+
+typedef struct {
+    Graph_Pass passes[GRAPH_PASSES_CAP];
+    size_t passes_count;
+
+    Graph_Step steps[GRAPH_PASSES_CAP];
+    size_t steps_count;
+    size_t targets_count;
+} Graph;
+
+void graph_reset(Graph *g)
+{
+    memset(g, 0, sizeof(*g));
+}
+
+static void graph_apply_defaults(Graph *g)
+{
+    for (size_t i = 0; i < g->passes_count; ++i) {
+        Graph_Pass *pass = &g->passes[i];
+        if (!pass->output_declared) {
+            pass->output = i + 1 == g->passes_count ? SV(GRAPH_SCREEN_NAME) : pass->name;
+        }
+        if (!pass->inputs_declared) {
+            pass->inputs_count = 0;
+            if (i > 0) pass->inputs[pass->inputs_count++] = g->passes[i - 1].output;
+        }
+    }
+}
+
+bool graph_compile(Graph *g)
+{
+    g->steps_count = 0;
+    g->targets_count = 0;
+    graph_apply_defaults(g);
+
+    // Resolve every input to the pass that writes it
+    size_t producers[GRAPH_PASSES_CAP][GRAPH_INPUTS_CAP];
+    size_t screen_pass = GRAPH_SCREEN;
+    for (size_t i = 0; i < g->passes_count; ++i) {
+        const Graph_Pass *pass = &g->passes[i];
+        for (size_t k = 0; k < pass->inputs_count; ++k) {
+            size_t j = 0;
+            while (j < i && !sv_eq(g->passes[j].output, pass->inputs[k])) j += 1;
+            if (j == i || sv_eq(pass->inputs[k], SV(GRAPH_SCREEN_NAME))) {
+                fprintf(stderr, "ERROR: render graph: "SV_Fmt" reads "SV_Fmt" that is not written by any of the passes before it\n",
+                        SV_Arg(pass->name), SV_Arg(pass->inputs[k]));
+                return false;
+            }
+            producers[i][k] = j;
+        }
+        for (size_t j = 0; j < i; ++j) {
+            if (sv_eq(g->passes[j].output, pass->output)) {
+                fprintf(stderr, "ERROR: render graph: "SV_Fmt" is written by both "SV_Fmt" and "SV_Fmt"\n",
+                        SV_Arg(pass->output), SV_Arg(g->passes[j].name), SV_Arg(pass->name));
+                return false;
+            }
+        }
+        if (sv_eq(pass->output, SV(GRAPH_SCREEN_NAME))) screen_pass = i;
+    }
+    if (screen_pass == GRAPH_SCREEN) {
+        fprintf(stderr, "ERROR: render graph: none of the passes writes "GRAPH_SCREEN_NAME"\n");
+        return false;
+    }
+
+    // The producers always come before the consumers, so a single backward
+    // walk marks everything SCREEN depends on
+    bool live[GRAPH_PASSES_CAP] = {0};
+    size_t last_use[GRAPH_PASSES_CAP];
+    live[screen_pass] = true;
+    for (size_t i = g->passes_count; i-- > 0;) {
+        last_use[i] = i;
+        if (!live[i]) continue;
+        for (size_t k = 0; k < g->passes[i].inputs_count; ++k) {
+            live[producers[i][k]] = true;
+        }
+    }
+    for (size_t i = 0; i < g->passes_count; ++i) {
+        if (!live[i]) continue;
+        for (size_t k = 0; k < g->passes[i].inputs_count; ++k) {
+            size_t j = producers[i][k];
+            if (last_use[j] < i) last_use[j] = i;
+        }
+    }
+
+    // A target is free again once the last reader of its resource is done
+    size_t target_of[GRAPH_PASSES_CAP];
+    size_t target_resource[GRAPH_TARGETS_CAP];
+    for (size_t i = 0; i < g->passes_count; ++i) {
+        if (!live[i]) continue;
+
+        Graph_Step *step = &g->steps[g->steps_count++];
+        step->pass = i;
+        step->inputs_count = g->passes[i].inputs_count;
+        for (size_t k = 0; k < step->inputs_count; ++k) {
+            step->inputs[k] = target_of[producers[i][k]];
+        }
+
+        if (i == screen_pass) {
+            step->output = GRAPH_SCREEN;
+            continue;
+        }
+        size_t t = 0;
+        while (t < g->targets_count && last_use[target_resource[t]] >= i) t += 1;
+        if (t == g->targets_count) g->targets_count += 1;
+        target_resource[t] = i;
+        target_of[i] = t;
+        step->output = t;
+    }
+
+    return true;
+}
+
+void graph_print(const Graph *g)
+{
+    printf("Render graph: %zu passes (%zu culled) on %zu render targets\n",
+           g->steps_count, g->passes_count - g->steps_count, g->targets_count);
+    for (size_t s = 0; s < g->steps_count; ++s) {
+        const Graph_Step *step = &g->steps[s];
+        const Graph_Pass *pass = &g->passes[step->pass];
+        printf("  "SV_Fmt":", SV_Arg(pass->name));
+        for (size_t k = 0; k < step->inputs_count; ++k) {
+            printf(" "SV_Fmt"@%zu", SV_Arg(pass->inputs[k]), step->inputs[k]);
+        }
+        if (step->output == GRAPH_SCREEN) {
+            printf(" -> "GRAPH_SCREEN_NAME"\n");
+        } else {
+            printf(" -> "SV_Fmt"@%zu\n", SV_Arg(pass->output), step->output);
+        }
+    }
+}
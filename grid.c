@@ -0,0 +1,185 @@
+// Uniform grid spatial index over points (the centers of the objects).
+//
+// Every entry lives in exactly one cell picked by its center, so the
+// queries have to be expanded by the maximum half-extent of whatever the
+// points represent (a.k.a. loose grid). The cells are hashed into a table
+// of buckets which makes the grid unbounded: objects may fly as far
+// away from the origin as they want. The amount of buckets grows with the
+// amount of entries so the bucket chains stay short.
+//
+// The grid is updated incrementally: grid_update() only relinks the entry
+// when it actually moved to a different cell.
+
+#define GRID_MIN_BUCKETS (4 * 1024)
+static_assert((GRID_MIN_BUCKETS & (GRID_MIN_BUCKETS - 1)) == 0, "GRID_MIN_BUCKETS must be a power of two");
+#define GRID_NIL ((uint32_t) -1)
+#define GRID_CELL_COORD_LIMIT (1 << 30)
+
+typedef struct {
+    float x, y;
+    int32_t cx, cy;
+    uint32_t bucket;
+    uint32_t prev;
+    uint32_t next;
+} Grid_Entry;
+
+typedef struct {
+    float cell_size;
+    // The amount of buckets is always a power of two
+    uint32_t *buckets;
+    size_t buckets_count;
+    Grid_Entry *entries;
+    size_t entries_count;
+    size_t entries_capacity;
+    // Amount of entries that changed their cell since the last grid_reset().
+    size_t relinks;
+} Grid;
+
+int32_t grid_cell_coord(const Grid *g, float x)
+{
+    float c = floorf(x / g->cell_size);
+    // NaNs and infinities end up in the border cells instead of being UB on the cast
+    if (!(c > -GRID_CELL_COORD_LIMIT)) return -GRID_CELL_COORD_LIMIT;
+    if (!(c < GRID_CELL_COORD_LIMIT)) return GRID_CELL_COORD_LIMIT;
+    return (int32_t) c;
+}
+
+uint32_t grid_cell_hash(const Grid *g, int32_t cx, int32_t cy)
+{
+    uint32_t h = (uint32_t) cx * 73856093u ^ (uint32_t) cy * 19349663u;
+    return h & (uint32_t) (g->buckets_count - 1);
+}
+
+void grid_reset(Grid *g, float cell_size, size_t count)
+{
+    assert(cell_size > 0.0f);
+
+    if (count > g->entries_capacity) {
+        Grid_Entry *entries = realloc(g->entries, count * sizeof(*g->entries));
+        if (entries == NULL) {
+            fprintf(stderr, "ERROR: could not allocate %zu grid entries: %s\n",
+                    count, strerror(errno));
+            exit(1);
+        }
+        g->entries = entries;
+        g->entries_capacity = count;
+    }
+
+    size_t buckets_count = GRID_MIN_BUCKETS;
+    while (buckets_count < count * 2) buckets_count *= 2;
+    if (buckets_count != g->buckets_count) {
+        uint32_t *buckets = realloc(g->buckets, buckets_count * sizeof(*g->buckets));
+        if (buckets == NULL) {
+            fprintf(stderr, "ERROR: could not allocate %zu grid buckets: %s\n",
+                    buckets_count, strerror(errno));
+            exit(1);
+        }
+        g->buckets = buckets;
+        g->buckets_count = buckets_count;
+    }
+
+    g->cell_size = cell_size;
+    g->entries_count = count;
+    g->relinks = 0;
+    for (size_t i = 0; i < g->buckets_count; ++i) {
+        g->buckets[i] = GRID_NIL;
+    }
+    for (size_t i = 0; i < count; ++i) {
+        g->entries[i].bucket = GRID_NIL;
+    }
+}
+
+static void grid_unlink(Grid *g, uint32_t index)
+{
+    Grid_Entry *e = &g->entries[index];
+    if (e->prev != GRID_NIL) {
+        g->entries[e->prev].next = e->next;
+    } else {
+        g->buckets[e->bucket] = e->next;
+    }
+    if (e->next != GRID_NIL) {
+        g->entries[e->next].prev = e->prev;
+    }
+    e->bucket = GRID_NIL;
+}
+
+static void grid_link(Grid *g, uint32_t index, int32_t cx, int32_t cy)
+{
+    Grid_Entry *e = &g->entries[index];
+    e->cx = cx;
+    e->cy = cy;
+    e->bucket = grid_cell_hash(g, cx, cy);
+    e->prev = GRID_NIL;
+    e->next = g->buckets[e->bucket];
+    if (e->next != GRID_NIL) {
+        g->entries[e->next].prev = index;
+    }
+    g->buckets[e->bucket] = index;
+}
+
+void grid_update(Grid *g, uint32_t index, float x, float y)
+{
+    assert(index < g->entries_count);
+    Grid_Entry *e = &g->entries[index];
+    e->x = x;
+    e->y = y;
+
+    int32_t cx = grid_cell_coord(g, x);
+    int32_t cy = grid_cell_coord(g, y);
+    if (e->bucket != GRID_NIL) {
+        if (e->cx == cx && e->cy == cy) return;
+        grid_unlink(g, index);
+    }
+    grid_link(g, index, cx, cy);
+    g->relinks += 1;
+}
+
+// Collects the indices of all the entries whose centers are inside of the
+// [x0, x1]x[y0, y1] rectangle. Returns the amount of the collected indices.
+// The order of the indices is unspecified.
+size_t grid_query(const Grid *g,
+                  float x0, float y0, float x1, float y1,
+                  uint32_t *out, size_t out_cap)
+{
+    size_t out_count = 0;
+
+    int32_t cx0 = grid_cell_coord(g, x0);
+    int32_t cy0 = grid_cell_coord(g, y0);
+    int32_t cx1 = grid_cell_coord(g, x1);
+    int32_t cy1 = grid_cell_coord(g, y1);
+    if (cx0 > cx1 || cy0 > cy1) return 0;
+
+    // In 64 bits, the clamped coordinates span up to 2^31 + 1 cells
+    uint64_t cells = (uint64_t) ((int64_t) cx1 - cx0 + 1) * (uint64_t) ((int64_t) cy1 - cy0 + 1);
+    if (cells >= g->buckets_count) {
+        // The rectangle covers more cells than there are buckets. Walking
+        // the buckets directly visits each entry exactly once and is cheaper.
+        for (size_t b = 0; b < g->buckets_count; ++b) {
+            for (uint32_t i = g->buckets[b]; i != GRID_NIL; i = g->entries[i].next) {
+                const Grid_Entry *e = &g->entries[i];
+                if (x0 <= e->x && e->x <= x1 && y0 <= e->y && e->y <= y1) {
+                    assert(out_count < out_cap);
+                    out[out_count++] = i;
+                }
+            }
+        }
+        return out_count;
+    }
+
+    for (int32_t cy = cy0; cy <= cy1; ++cy) {
+        for (int32_t cx = cx0; cx <= cx1; ++cx) {
+            uint32_t b = grid_cell_hash(g, cx, cy);
+            for (uint32_t i = g->buckets[b]; i != GRID_NIL; i = g->entries[i].next) {
+                const Grid_Entry *e = &g->entries[i];
+                // Different cells may share the same bucket
+                if (e->cx != cx || e->cy != cy) continue;
+                if (x0 <= e->x && e->x <= x1 && y0 <= e->y && e->y <= y1) {
+                    assert(out_count < out_cap);
+                    out[out_count++] = i;
+                }
+            }
+        }
+    }
+
+    return out_count;
+}
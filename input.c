@@ -0,0 +1,211 @@
+// Recording and deterministic replay of the input.
+//
+// Every frame consumes its input through an Input_Frame: the cursor position,
+// the window size, the time step and the events (reloads, pausing, stepping
+// the time, mouse presses) that happened during the frame, in order. When
+// recording, the frames are appended to a file as they are consumed. When
+// replaying, they are read back from the file instead of the live input, so
+// the simulation and the uniforms evolve exactly like in the recorded session.
+//
+// The file is an Input_Header followed by an Input_Frame and its
+// `events_count` Input_Events for every frame. Everything is stored in the
+// native byte order, the header refuses the files with a different layout.
+//
+// F5 reloads the render.conf as it is on the disk during the replay, so keep
+// it the same as during the recording.
+
+#define INPUT_MAGIC "OGTI"
+#define INPUT_VERSION 1
+#define INPUT_FRAME_EVENTS_CAP 64
+
+typedef enum {
+    INPUT_EVENT_RELOAD = 0,
+    INPUT_EVENT_TOGGLE_PAUSE,
+    INPUT_EVENT_STEP_BACK,
+    INPUT_EVENT_STEP_FORTH,
+    INPUT_EVENT_MOUSE_PRESS,
+    INPUT_EVENT_MOUSE_RELEASE,
+    COUNT_INPUT_EVENTS
+} Input_Event_Kind;
+
+typedef struct {
+    // Cursor position of the mouse events in the scene coordinates
+    float x, y;
+    uint32_t kind;
+} Input_Event;
+
+typedef struct {
+    double delta_time;
+    // Cursor position in the scene coordinates
+    float cursor_x, cursor_y;
+    uint16_t width, height;
+    uint32_t events_count;
+} Input_Frame;
+
+typedef struct {
+    char magic[4];
+    uint32_t version;
+    uint32_t frame_size;
+    uint32_t event_size;
+    double start_time;
+} Input_Header;
+
+typedef enum {
+    INPUT_LIVE = 0,
+    INPUT_RECORDING,
+    INPUT_REPLAYING,
+} Input_Mode;
+
+typedef struct {
+    Input_Mode mode;
+    const char *file_path;
+    FILE *file;
+    Input_Frame frame;
+    Input_Event events[INPUT_FRAME_EVENTS_CAP];
+    size_t frames_count;
+    size_t events_dropped;
+} Input;
+
+static Input input = {0};
+
+bool input_record_start(const char *file_path, double start_time)
+{
+    FILE *f = fopen(file_path, "wb");
+    if (f == NULL) {
+        fprintf(stderr, "ERROR: could not open %s: %s\n", file_path, strerror(errno));
+        return false;
+    }
+
+    Input_Header header = {
+        .magic = INPUT_MAGIC,
+        .version = INPUT_VERSION,
+        .frame_size = sizeof(Input_Frame),
+        .event_size = sizeof(Input_Event),
+        .start_time = start_time,
+    };
+    if (fwrite(&header, sizeof(header), 1, f) != 1) {
+        fprintf(stderr, "ERROR: could not write %s: %s\n", file_path, strerror(errno));
+        fclose(f);
+        return false;
+    }
+
+    input.mode = INPUT_RECORDING;
+    input.file_path = file_path;
+    input.file = f;
+    input.frames_count = 0;
+    input.events_dropped = 0;
+    printf("Recording the input to %s\n", file_path);
+    return true;
+}
+
+// `start_time` gets the scene time the recording was started at
+bool input_replay_start(const char *file_path, double *start_time)
+{
+    FILE *f = fopen(file_path, "rb");
+    if (f == NULL) {
+        fprintf(stderr, "ERROR: could not open %s: %s\n", file_path, strerror(errno));
+        return false;
+    }
+
+    Input_Header header;
+    if (fread(&header, sizeof(header), 1, f) != 1) {
+        fprintf(stderr, "ERROR: %s is not an input recording: could not read the header\n", file_path);
+        fclose(f);
+        return false;
+    }
+    if (memcmp(header.magic, INPUT_MAGIC, sizeof(header.magic)) != 0 ||
+            header.version != INPUT_VERSION ||
+            header.frame_size != sizeof(Input_Frame) ||
+            header.event_size != sizeof(Input_Event)) {
+        fprintf(stderr, "ERROR: %s is not an input recording of this version of the program\n", file_path);
+        fclose(f);
+        return false;
+    }
+
+    input.mode = INPUT_REPLAYING;
+    input.file_path = file_path;
+    input.file = f;
+    input.frames_count = 0;
+    *start_time = header.start_time;
+    printf("Replaying the input from %s\n", file_path);
+    return true;
+}
+
+void input_stop(void)
+{
+    if (input.file == NULL) return;
+    if (input.mode == INPUT_RECORDING) {
+        printf("Recorded %zu frames of input to %s", input.frames_count, input.file_path);
+        if (input.events_dropped > 0) printf(" (%zu events were dropped)", input.events_dropped);
+        printf("\n");
+    } else {
+        printf("Replayed %zu frames of input from %s\n", input.frames_count, input.file_path);
+    }
+    fclose(input.file);
+    input.file = NULL;
+    input.mode = INPUT_LIVE;
+}
+
+// Starts a new frame. `live` is the input sampled from the window. Returns
+// the input the frame must use, or NULL when the replay is over.
+const Input_Frame *input_frame_begin(const Input_Frame *live)
+{
+    if (input.mode != INPUT_REPLAYING) {
+        input.frame = *live;
+        input.frame.events_count = 0;
+        return &input.frame;
+    }
+
+    if (fread(&input.frame, sizeof(input.frame), 1, input.file) != 1) {
+        return NULL;
+    }
+    if (input.frame.events_count > INPUT_FRAME_EVENTS_CAP ||
+            fread(input.events, sizeof(input.events[0]), input.frame.events_count, input.file) != input.frame.events_count) {
+        fprintf(stderr, "ERROR: %s is corrupted at frame %zu\n", input.file_path, input.frames_count);
+        return NULL;
+    }
+    return &input.frame;
+}
+
+// Returns true if the event has to be applied. The replay ignores the live
+// events, they come from the file instead.
+bool input_event_push(Input_Event event)
+{
+    if (input.mode == INPUT_REPLAYING) return false;
+    if (input.mode == INPUT_RECORDING) {
+        if (input.frame.events_count >= INPUT_FRAME_EVENTS_CAP) {
+            input.events_dropped += 1;
+            return false;
+        }
+        input.events[input.frame.events_count++] = event;
+    }
+    return true;
+}
+
+// Events of the replayed frame to apply after the live ones would have been polled
+size_t input_replayed_events(const Input_Event **events)
+{
+    if (input.mode != INPUT_REPLAYING) return 0;
+    *events = input.events;
+    return input.frame.events_count;
+}
+
+// Finishes the frame. `delta_time` is the live time step. Returns the time step
+// the simulation must use.
+double input_frame_end(double delta_time)
+{
+    input.frames_count += 1;
+    if (input.mode == INPUT_REPLAYING) return input.frame.delta_time;
+
+    input.frame.delta_time = delta_time;
+    if (input.mode == INPUT_RECORDING) {
+        if (fwrite(&input.frame, sizeof(input.frame), 1, input.file) != 1 ||
+                fwrite(input.events, sizeof(input.events[0]), input.frame.events_count, input.file) != input.frame.events_count) {
+            fprintf(stderr, "ERROR: could not write %s: %s\n", input.file_path, strerror(errno));
+            fclose(input.file);
+            input.file = NULL;
+            input.mode = INPUT_LIVE;
+        }
+    }
+    return delta_time;
+}
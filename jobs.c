@@ -0,0 +1,552 @@
+// Work-stealing job system.
+//
+// Every worker owns a Chase-Lev deque: the owner pushes and pops jobs at the
+// bottom without any locks, idle workers steal from the top of the other
+// deques. The thread that calls jobs_init() becomes the worker 0, so it can
+// submit jobs and help executing them while it waits.
+//
+// Jobs are owned by the caller and must outlive jobs_wait() on them.
+// A job may have a parent (the parent is not done until all of its children
+// are done) and dependencies (the job is not started until all of its
+// dependencies are done). Dependencies must be declared with job_depends_on()
+// before either of the jobs is submitted.
+//
+// Long jobs that must not stall the worker 0 (decoding the files, encoding the
+// screenshots) go to the background queue with jobs_submit_background(). Only
+// the other workers take them, after their own and the stolen jobs, so the
+// worker 0 never runs them, not even in jobs_wait(). Without the other workers
+// they run right away.
+//
+// The mutex and the condition variable are only touched by the workers that
+// ran out of work and are going to sleep, by the submitters when there are
+// sleeping workers, and around the background queue.
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#endif // _WIN32
+#include <stdatomic.h>
+
+#define JOBS_WORKERS_CAP 64
+#define JOBS_DEQUE_CAP 4096
+static_assert((JOBS_DEQUE_CAP & (JOBS_DEQUE_CAP - 1)) == 0, "JOBS_DEQUE_CAP must be a power of two");
+#define JOB_DEPENDENTS_CAP 8
+#define JOBS_PARALLEL_FOR_CAP 256
+#define JOBS_SPINS_BEFORE_SLEEP 256
+
+typedef struct Job Job;
+typedef void (*Job_Func)(void *data);
+typedef void (*Jobs_Range_Func)(void *data, size_t begin, size_t end);
+
+struct Job {
+    Job_Func func;
+    void *data;
+    Job *parent;
+    // 1 for the job itself + the amount of the unfinished children
+    atomic_int unfinished;
+    // The amount of the unfinished jobs this job depends on + 1 until the job is submitted
+    atomic_int dependencies;
+    atomic_bool done;
+    Job *dependents[JOB_DEPENDENTS_CAP];
+    size_t dependents_count;
+    // Next job in the background queue
+    Job *next;
+};
+
+typedef struct {
+    atomic_llong top;
+    atomic_llong bottom;
+    _Atomic(Job*) items[JOBS_DEQUE_CAP];
+} Jobs_Deque;
+
+typedef struct {
+    atomic_ullong jobs_executed;
+    atomic_ullong jobs_stolen;
+    atomic_ullong busy_nsecs;
+} Jobs_Worker_Stats;
+
+#ifdef _WIN32
+typedef HANDLE Jobs_Thread;
+#else
+typedef pthread_t Jobs_Thread;
+#endif // _WIN32
+
+typedef struct {
+    size_t workers_count;
+    Jobs_Thread threads[JOBS_WORKERS_CAP];
+    Jobs_Deque deques[JOBS_WORKERS_CAP];
+    Jobs_Worker_Stats stats[JOBS_WORKERS_CAP];
+    double stats_start;
+
+    atomic_bool running;
+    atomic_llong pending;
+    atomic_int sleeping;
+    // Guarded by `lock`, the count is also read without it
+    Job *background_head;
+    Job *background_tail;
+    atomic_size_t background_count;
+#ifdef _WIN32
+    SRWLOCK lock;
+    CONDITION_VARIABLE wake;
+#else
+    pthread_mutex_t lock;
+    pthread_cond_t wake;
+#endif // _WIN32
+} Jobs;
+
+static Jobs jobs = {0};
+static _Thread_local int jobs_worker_index = -1;
+
+size_t jobs_cpu_count(void)
+{
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return info.dwNumberOfProcessors;
+#else
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    return n > 0 ? (size_t) n : 1;
+#endif // _WIN32
+}
+
+static void jobs_yield(void)
+{
+#ifdef _WIN32
+    SwitchToThread();
+#else
+    sched_yield();
+#endif // _WIN32
+}
+
+static bool jobs_deque_push(Jobs_Deque *d, Job *job)
+{
+    long long b = atomic_load_explicit(&d->bottom, memory_order_relaxed);
+    long long t = atomic_load_explicit(&d->top, memory_order_acquire);
+    if (b - t >= JOBS_DEQUE_CAP) return false;
+    atomic_store_explicit(&d->items[b & (JOBS_DEQUE_CAP - 1)], job, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    atomic_store_explicit(&d->bottom, b + 1, memory_order_relaxed);
+    return true;
+}
+
+static Job *jobs_deque_pop(Jobs_Deque *d)
+{
+    long long b = atomic_load_explicit(&d->bottom, memory_order_relaxed) - 1;
+    atomic_store_explicit(&d->bottom, b, memory_order_relaxed);
+    atomic_thread_fence(memory_order_seq_cst);
+    long long t = atomic_load_explicit(&d->top, memory_order_relaxed);
+
+    if (t > b) {
+        atomic_store_explicit(&d->bottom, b + 1, memory_order_relaxed);
+        return NULL;
+    }
+
+    Job *job = atomic_load_explicit(&d->items[b & (JOBS_DEQUE_CAP - 1)], memory_order_relaxed);
+    if (t == b) {
+        // The last job in the deque: race against the thieves for it
+        if (!atomic_compare_exchange_strong_explicit(&d->top, &t, t + 1,
+                                                     memory_order_seq_cst,
+                                                     memory_order_relaxed)) {
+            job = NULL;
+        }
+        atomic_store_explicit(&d->bottom, b + 1, memory_order_relaxed);
+    }
+    return job;
+}
+
+static Job *jobs_deque_steal(Jobs_Deque *d)
+{
+    long long t = atomic_load_explicit(&d->top, memory_order_acquire);
+    atomic_thread_fence(memory_order_seq_cst);
+    long long b = atomic_load_explicit(&d->bottom, memory_order_acquire);
+    if (t >= b) return NULL;
+
+    Job *job = atomic_load_explicit(&d->items[t & (JOBS_DEQUE_CAP - 1)], memory_order_relaxed);
+    if (!atomic_compare_exchange_strong_explicit(&d->top, &t, t + 1,
+                                                 memory_order_seq_cst,
+                                                 memory_order_relaxed)) {
+        return NULL;
+    }
+    return job;
+}
+
+void job_init(Job *job, Job_Func func, void *data, Job *parent)
+{
+    job->func = func;
+    job->data = data;
+    job->parent = parent;
+    atomic_init(&job->unfinished, 1);
+    atomic_init(&job->dependencies, 1);
+    atomic_init(&job->done, false);
+    job->dependents_count = 0;
+    job->next = NULL;
+    if (parent) {
+        atomic_fetch_add(&parent->unfinished, 1);
+    }
+}
+
+void job_depends_on(Job *job, Job *dependency)
+{
+    assert(dependency->dependents_count < JOB_DEPENDENTS_CAP);
+    dependency->dependents[dependency->dependents_count++] = job;
+    atomic_fetch_add(&job->dependencies, 1);
+}
+
+static void jobs_enqueue(Job *job);
+
+static void job_finish(Job *job)
+{
+    if (atomic_fetch_sub(&job->unfinished, 1) != 1) return;
+
+    for (size_t i = 0; i < job->dependents_count; ++i) {
+        Job *dependent = job->dependents[i];
+        if (atomic_fetch_sub(&dependent->dependencies, 1) == 1) {
+            jobs_enqueue(dependent);
+        }
+    }
+    Job *parent = job->parent;
+    // The waiters may release the job as soon as it is marked done, so
+    // nothing can touch it afterwards
+    atomic_store(&job->done, true);
+    if (parent) job_finish(parent);
+}
+
+static void job_execute(Job *job, bool stolen)
+{
+    Jobs_Worker_Stats *stats = &jobs.stats[jobs_worker_index];
+    double start = glfwGetTime();
+    if (job->func) job->func(job->data);
+    double elapsed = glfwGetTime() - start;
+
+    atomic_fetch_add_explicit(&stats->busy_nsecs, (unsigned long long) (elapsed * 1e9), memory_order_relaxed);
+    atomic_fetch_add_explicit(&stats->jobs_executed, 1, memory_order_relaxed);
+    if (stolen) atomic_fetch_add_explicit(&stats->jobs_stolen, 1, memory_order_relaxed);
+
+    job_finish(job);
+}
+
+static void jobs_lock(void)
+{
+#ifdef _WIN32
+    AcquireSRWLockExclusive(&jobs.lock);
+#else
+    pthread_mutex_lock(&jobs.lock);
+#endif // _WIN32
+}
+
+static void jobs_unlock(void)
+{
+#ifdef _WIN32
+    ReleaseSRWLockExclusive(&jobs.lock);
+#else
+    pthread_mutex_unlock(&jobs.lock);
+#endif // _WIN32
+}
+
+static void jobs_wake_sleepers(void)
+{
+    if (atomic_load(&jobs.sleeping) == 0) return;
+    jobs_lock();
+#ifdef _WIN32
+    WakeAllConditionVariable(&jobs.wake);
+#else
+    pthread_cond_broadcast(&jobs.wake);
+#endif // _WIN32
+    jobs_unlock();
+}
+
+static void jobs_enqueue(Job *job)
+{
+    assert(jobs_worker_index >= 0 && "Jobs can only be submitted from the worker threads");
+    atomic_fetch_add(&jobs.pending, 1);
+    if (!jobs_deque_push(&jobs.deques[jobs_worker_index], job)) {
+        // The deque is full, just do the job right away
+        atomic_fetch_sub(&jobs.pending, 1);
+        job_execute(job, false);
+        return;
+    }
+    jobs_wake_sleepers();
+}
+
+// The job starts as soon as all of its dependencies are done. Whoever drops
+// the dependencies counter to zero (the submitter or the last dependency)
+// enqueues it, so it can never be enqueued twice.
+void jobs_submit(Job *job)
+{
+    if (atomic_fetch_sub(&job->dependencies, 1) == 1) {
+        jobs_enqueue(job);
+    }
+}
+
+// Only called when there are other workers to take the job
+static void jobs_background_push(Job *job)
+{
+    atomic_fetch_add(&jobs.pending, 1);
+    jobs_lock();
+    if (jobs.background_tail != NULL) {
+        jobs.background_tail->next = job;
+    } else {
+        jobs.background_head = job;
+    }
+    jobs.background_tail = job;
+    atomic_fetch_add(&jobs.background_count, 1);
+    jobs_unlock();
+    jobs_wake_sleepers();
+}
+
+static Job *jobs_background_pop(void)
+{
+    if (atomic_load(&jobs.background_count) == 0) return NULL;
+    jobs_lock();
+    Job *job = jobs.background_head;
+    if (job != NULL) {
+        jobs.background_head = job->next;
+        if (jobs.background_head == NULL) jobs.background_tail = NULL;
+        job->next = NULL;
+        atomic_fetch_sub(&jobs.background_count, 1);
+    }
+    jobs_unlock();
+    return job;
+}
+
+// Like jobs_submit() but the job is only executed by the workers besides the
+// worker 0, or right away by the caller if there are none. The job can not
+// have dependencies, the last one of them would enqueue it as a regular job.
+void jobs_submit_background(Job *job)
+{
+    assert(atomic_load(&job->dependencies) == 1 && "Background jobs can not have dependencies");
+    atomic_store(&job->dependencies, 0);
+    if (jobs.workers_count <= 1) {
+        job_execute(job, false);
+    } else {
+        jobs_background_push(job);
+    }
+}
+
+// Pops a job from the own deque, steals one from somebody else's or, unless
+// this is the worker 0, takes one from the background queue
+static bool jobs_try_execute_one(void)
+{
+    size_t self = (size_t) jobs_worker_index;
+    Job *job = jobs_deque_pop(&jobs.deques[self]);
+    bool stolen = false;
+    for (size_t i = 1; job == NULL && i < jobs.workers_count; ++i) {
+        job = jobs_deque_steal(&jobs.deques[(self + i) % jobs.workers_count]);
+        stolen = true;
+    }
+    if (job == NULL && self != 0) {
+        job = jobs_background_pop();
+        stolen = false;
+    }
+    if (job == NULL) return false;
+
+    atomic_fetch_sub(&jobs.pending, 1);
+    job_execute(job, stolen);
+    return true;
+}
+
+void jobs_wait(Job *job)
+{
+    while (!atomic_load(&job->done)) {
+        if (!jobs_try_execute_one()) jobs_yield();
+    }
+}
+
+static void jobs_worker_sleep(void)
+{
+#ifdef _WIN32
+    AcquireSRWLockExclusive(&jobs.lock);
+    atomic_fetch_add(&jobs.sleeping, 1);
+    while (atomic_load(&jobs.pending) == 0 && atomic_load(&jobs.running)) {
+        SleepConditionVariableSRW(&jobs.wake, &jobs.lock, INFINITE, 0);
+    }
+    atomic_fetch_sub(&jobs.sleeping, 1);
+    ReleaseSRWLockExclusive(&jobs.lock);
+#else
+    pthread_mutex_lock(&jobs.lock);
+    atomic_fetch_add(&jobs.sleeping, 1);
+    while (atomic_load(&jobs.pending) == 0 && atomic_load(&jobs.running)) {
+        pthread_cond_wait(&jobs.wake, &jobs.lock);
+    }
+    atomic_fetch_sub(&jobs.sleeping, 1);
+    pthread_mutex_unlock(&jobs.lock);
+#endif // _WIN32
+}
+
+static void jobs_worker_loop(int index)
+{
+    jobs_worker_index = index;
+    size_t spins = 0;
+    while (atomic_load(&jobs.running)) {
+        if (jobs_try_execute_one()) {
+            spins = 0;
+        } else if (++spins < JOBS_SPINS_BEFORE_SLEEP) {
+            jobs_yield();
+        } else {
+            jobs_worker_sleep();
+            spins = 0;
+        }
+    }
+}
+
+#ifdef _WIN32
+static DWORD WINAPI jobs_worker_main(LPVOID arg)
+{
+    jobs_worker_loop((int) (intptr_t) arg);
+    return 0;
+}
+#else
+static void *jobs_worker_main(void *arg)
+{
+    jobs_worker_loop((int) (intptr_t) arg);
+    return NULL;
+}
+#endif // _WIN32
+
+// Starts `threads_count` workers including the calling thread.
+// 0 means one worker per CPU.
+void jobs_init(size_t threads_count)
+{
+    if (threads_count == 0) threads_count = jobs_cpu_count();
+    if (threads_count > JOBS_WORKERS_CAP) threads_count = JOBS_WORKERS_CAP;
+
+    jobs.workers_count = threads_count;
+    for (size_t i = 0; i < JOBS_WORKERS_CAP; ++i) {
+        atomic_init(&jobs.deques[i].top, 0);
+        atomic_init(&jobs.deques[i].bottom, 0);
+        atomic_init(&jobs.stats[i].jobs_executed, 0);
+        atomic_init(&jobs.stats[i].jobs_stolen, 0);
+        atomic_init(&jobs.stats[i].busy_nsecs, 0);
+    }
+    jobs.stats_start = glfwGetTime();
+    atomic_init(&jobs.running, true);
+    atomic_init(&jobs.pending, 0);
+    atomic_init(&jobs.sleeping, 0);
+    jobs.background_head = NULL;
+    jobs.background_tail = NULL;
+    atomic_init(&jobs.background_count, 0);
+#ifdef _WIN32
+    InitializeSRWLock(&jobs.lock);
+    InitializeConditionVariable(&jobs.wake);
+#else
+    pthread_mutex_init(&jobs.lock, NULL);
+    pthread_cond_init(&jobs.wake, NULL);
+#endif // _WIN32
+
+    jobs_worker_index = 0;
+    for (size_t i = 1; i < threads_count; ++i) {
+#ifdef _WIN32
+        jobs.threads[i] = CreateThread(NULL, 0, jobs_worker_main, (LPVOID) (intptr_t) i, 0, NULL);
+        if (jobs.threads[i] == NULL) {
+            fprintf(stderr, "ERROR: could not create a worker thread\n");
+            exit(1);
+        }
+#else
+        int err = pthread_create(&jobs.threads[i], NULL, jobs_worker_main, (void*) (intptr_t) i);
+        if (err != 0) {
+            fprintf(stderr, "ERROR: could not create a worker thread: %s\n", strerror(err));
+            exit(1);
+        }
+#endif // _WIN32
+    }
+
+    printf("Started %zu job workers\n", threads_count);
+}
+
+// Must be called from the thread that called jobs_init() when no jobs are in flight
+void jobs_shutdown(void)
+{
+    assert(jobs_worker_index == 0);
+    atomic_store(&jobs.running, false);
+#ifdef _WIN32
+    AcquireSRWLockExclusive(&jobs.lock);
+    WakeAllConditionVariable(&jobs.wake);
+    ReleaseSRWLockExclusive(&jobs.lock);
+#else
+    pthread_mutex_lock(&jobs.lock);
+    pthread_cond_broadcast(&jobs.wake);
+    pthread_mutex_unlock(&jobs.lock);
+#endif // _WIN32
+
+    for (size_t i = 1; i < jobs.workers_count; ++i) {
+#ifdef _WIN32
+        WaitForSingleObject(jobs.threads[i], INFINITE);
+        CloseHandle(jobs.threads[i]);
+#else
+        pthread_join(jobs.threads[i], NULL);
+#endif // _WIN32
+    }
+
+#ifndef _WIN32
+    pthread_mutex_destroy(&jobs.lock);
+    pthread_cond_destroy(&jobs.wake);
+#endif // _WIN32
+    jobs.workers_count = 0;
+}
+
+typedef struct {
+    Jobs_Range_Func func;
+    void *data;
+    size_t begin;
+    size_t end;
+} Jobs_Range;
+
+static void jobs_range_execute(void *data)
+{
+    Jobs_Range *range = data;
+    range->func(range->data, range->begin, range->end);
+}
+
+// Splits [0, count) into chunks of at least `grain` elements, runs them on
+// all the workers and waits for them to finish. Small ranges are executed
+// inline on the calling thread.
+void jobs_parallel_for(size_t count, size_t grain, Jobs_Range_Func func, void *data)
+{
+    if (grain == 0) grain = 1;
+    size_t chunks = (count + grain - 1) / grain;
+    if (chunks > jobs.workers_count * 4) chunks = jobs.workers_count * 4;
+    if (chunks > JOBS_PARALLEL_FOR_CAP) chunks = JOBS_PARALLEL_FOR_CAP;
+    if (chunks <= 1 || jobs.workers_count <= 1) {
+        func(data, 0, count);
+        return;
+    }
+
+    Job root;
+    job_init(&root, NULL, NULL, NULL);
+
+    Job chunk_jobs[JOBS_PARALLEL_FOR_CAP];
+    Jobs_Range ranges[JOBS_PARALLEL_FOR_CAP];
+    for (size_t i = 0; i < chunks; ++i) {
+        ranges[i].func = func;
+        ranges[i].data = data;
+        ranges[i].begin = count * i / chunks;
+        ranges[i].end = count * (i + 1) / chunks;
+        job_init(&chunk_jobs[i], jobs_range_execute, &ranges[i], &root);
+        jobs_submit(&chunk_jobs[i]);
+    }
+
+    job_finish(&root);
+    jobs_wait(&root);
+}
+
+// Prints per-worker utilization since the previous call and resets the counters
+void jobs_print_stats(void)
+{
+    double now = glfwGetTime();
+    double window = now - jobs.stats_start;
+    if (window <= 0.0) window = 1e-9;
+    for (size_t i = 0; i < jobs.workers_count; ++i) {
+        Jobs_Worker_Stats *stats = &jobs.stats[i];
+        unsigned long long executed = atomic_exchange(&stats->jobs_executed, 0);
+        unsigned long long stolen = atomic_exchange(&stats->jobs_stolen, 0);
+        double busy = atomic_exchange(&stats->busy_nsecs, 0) * 1e-9;
+        printf("Worker %zu: %5.1f%% busy, %llu jobs, %llu stolen\n",
+               i, busy / window * 100.0, executed, stolen);
+    }
+    jobs.stats_start = now;
+}
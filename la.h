@@ -2,11 +2,49 @@
 #define LA_H_
 
 #include <math.h>
+#include <stddef.h>
+#include <stdlib.h>
+#ifdef _MSC_VER
+#  include <malloc.h>
+#endif // _MSC_VER
 
 #ifndef LADEF
 #define LADEF static inline
 #endif // LADEF
 
+// Define LA_SIMD before including la.h to implement the element-wise
+// operations of V4f, V4i, V4u and V2f (in the low half of a register) with
+// SSE and the ones of V4d with AVX, as far as the target allows it:
+//   SSE2    sum, sub, mul, div, sqrt, min, max, lerp, clamp of V4f and V2f,
+//           sum and sub of V4i and V4u
+//   SSE4.1  floor and ceil of V4f and V2f, mul, min, max, clamp of V4i and V4u
+//   AVX     everything of V4d
+// Everything else stays scalar. The types and the API are the same and the
+// results are bit for bit the same as without LA_SIMD.
+#ifdef LA_SIMD
+#  if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#    define LA_SSE2 1
+#    include <emmintrin.h>
+#  endif
+#  if defined(__SSE4_1__) || defined(__AVX__)
+#    define LA_SSE41 1
+#    include <smmintrin.h>
+#  endif
+#  ifdef __AVX__
+#    define LA_AVX 1
+#    include <immintrin.h>
+#  endif
+#endif // LA_SIMD
+#ifndef LA_SSE2
+#  define LA_SSE2 0
+#endif
+#ifndef LA_SSE41
+#  define LA_SSE41 0
+#endif
+#ifndef LA_AVX
+#  define LA_AVX 0
+#endif
+
 LADEF float lerpf(float a, float b, float t);
 LADEF double lerp(double a, double b, double t);
 LADEF int mini(int a, int b);
@@ -367,10 +405,534 @@ LADEF V4u v4u_max(V4u a, V4u b);
 LADEF V4u v4u_clamp(V4u x, V4u a, V4u b);
 LADEF unsigned int v4u_sqrlen(V4u a);
 
+// Batch operations over `n` elements, `out` may be the same array as any of
+// the inputs. They are vectorized with LA_SIMD and take arrays of any
+// alignment. The operations of the vector types are element-wise, so they
+// process an array of V2f as one array of 2*n floats. For the
+// structure-of-arrays layout call the scalar versions on each component and
+// v*_len_soa() for the lengths. v*_len_n() deinterleave 4 vectors at a time
+// into the registers of their x, y, z and w and compute the lengths the same way.
+
+LADEF void floats_sum_n(float *out, const float *a, const float *b, size_t n);
+LADEF void floats_sub_n(float *out, const float *a, const float *b, size_t n);
+LADEF void floats_mul_n(float *out, const float *a, const float *b, size_t n);
+LADEF void floats_div_n(float *out, const float *a, const float *b, size_t n);
+LADEF void floats_sqrt_n(float *out, const float *a, size_t n);
+LADEF void floats_min_n(float *out, const float *a, const float *b, size_t n);
+LADEF void floats_max_n(float *out, const float *a, const float *b, size_t n);
+LADEF void floats_lerp_n(float *out, const float *a, const float *b, const float *t, size_t n);
+LADEF void floats_clamp_n(float *out, const float *x, const float *a, const float *b, size_t n);
+LADEF void doubles_sum_n(double *out, const double *a, const double *b, size_t n);
+LADEF void doubles_sub_n(double *out, const double *a, const double *b, size_t n);
+LADEF void doubles_mul_n(double *out, const double *a, const double *b, size_t n);
+LADEF void doubles_div_n(double *out, const double *a, const double *b, size_t n);
+LADEF void doubles_sqrt_n(double *out, const double *a, size_t n);
+LADEF void doubles_min_n(double *out, const double *a, const double *b, size_t n);
+LADEF void doubles_max_n(double *out, const double *a, const double *b, size_t n);
+LADEF void doubles_lerp_n(double *out, const double *a, const double *b, const double *t, size_t n);
+LADEF void doubles_clamp_n(double *out, const double *x, const double *a, const double *b, size_t n);
+LADEF void ints_sum_n(int *out, const int *a, const int *b, size_t n);
+LADEF void ints_sub_n(int *out, const int *a, const int *b, size_t n);
+LADEF void ints_mul_n(int *out, const int *a, const int *b, size_t n);
+LADEF void ints_div_n(int *out, const int *a, const int *b, size_t n);
+LADEF void ints_min_n(int *out, const int *a, const int *b, size_t n);
+LADEF void ints_max_n(int *out, const int *a, const int *b, size_t n);
+LADEF void ints_clamp_n(int *out, const int *x, const int *a, const int *b, size_t n);
+LADEF void uints_sum_n(unsigned int *out, const unsigned int *a, const unsigned int *b, size_t n);
+LADEF void uints_sub_n(unsigned int *out, const unsigned int *a, const unsigned int *b, size_t n);
+LADEF void uints_mul_n(unsigned int *out, const unsigned int *a, const unsigned int *b, size_t n);
+LADEF void uints_div_n(unsigned int *out, const unsigned int *a, const unsigned int *b, size_t n);
+LADEF void uints_min_n(unsigned int *out, const unsigned int *a, const unsigned int *b, size_t n);
+LADEF void uints_max_n(unsigned int *out, const unsigned int *a, const unsigned int *b, size_t n);
+LADEF void uints_clamp_n(unsigned int *out, const unsigned int *x, const unsigned int *a, const unsigned int *b, size_t n);
+
+LADEF void v2f_len_soa(float *out, const float *x, const float *y, size_t n);
+LADEF void v3f_len_soa(float *out, const float *x, const float *y, const float *z, size_t n);
+LADEF void v4f_len_soa(float *out, const float *x, const float *y, const float *z, const float *w, size_t n);
+LADEF void v2d_len_soa(double *out, const double *x, const double *y, size_t n);
+LADEF void v3d_len_soa(double *out, const double *x, const double *y, const double *z, size_t n);
+LADEF void v4d_len_soa(double *out, const double *x, const double *y, const double *z, const double *w, size_t n);
+
+LADEF void v2f_sum_n(V2f *out, const V2f *a, const V2f *b, size_t n);
+LADEF void v2f_sub_n(V2f *out, const V2f *a, const V2f *b, size_t n);
+LADEF void v2f_mul_n(V2f *out, const V2f *a, const V2f *b, size_t n);
+LADEF void v2f_div_n(V2f *out, const V2f *a, const V2f *b, size_t n);
+LADEF void v2f_sqrt_n(V2f *out, const V2f *a, size_t n);
+LADEF void v2f_min_n(V2f *out, const V2f *a, const V2f *b, size_t n);
+LADEF void v2f_max_n(V2f *out, const V2f *a, const V2f *b, size_t n);
+LADEF void v2f_lerp_n(V2f *out, const V2f *a, const V2f *b, const V2f *t, size_t n);
+LADEF void v2f_clamp_n(V2f *out, const V2f *x, const V2f *a, const V2f *b, size_t n);
+LADEF void v2f_len_n(float *out, const V2f *a, size_t n);
+LADEF void v3f_sum_n(V3f *out, const V3f *a, const V3f *b, size_t n);
+LADEF void v3f_sub_n(V3f *out, const V3f *a, const V3f *b, size_t n);
+LADEF void v3f_mul_n(V3f *out, const V3f *a, const V3f *b, size_t n);
+LADEF void v3f_div_n(V3f *out, const V3f *a, const V3f *b, size_t n);
+LADEF void v3f_sqrt_n(V3f *out, const V3f *a, size_t n);
+LADEF void v3f_min_n(V3f *out, const V3f *a, const V3f *b, size_t n);
+LADEF void v3f_max_n(V3f *out, const V3f *a, const V3f *b, size_t n);
+LADEF void v3f_lerp_n(V3f *out, const V3f *a, const V3f *b, const V3f *t, size_t n);
+LADEF void v3f_clamp_n(V3f *out, const V3f *x, const V3f *a, const V3f *b, size_t n);
+LADEF void v3f_len_n(float *out, const V3f *a, size_t n);
+LADEF void v4f_sum_n(V4f *out, const V4f *a, const V4f *b, size_t n);
+LADEF void v4f_sub_n(V4f *out, const V4f *a, const V4f *b, size_t n);
+LADEF void v4f_mul_n(V4f *out, const V4f *a, const V4f *b, size_t n);
+LADEF void v4f_div_n(V4f *out, const V4f *a, const V4f *b, size_t n);
+LADEF void v4f_sqrt_n(V4f *out, const V4f *a, size_t n);
+LADEF void v4f_min_n(V4f *out, const V4f *a, const V4f *b, size_t n);
+LADEF void v4f_max_n(V4f *out, const V4f *a, const V4f *b, size_t n);
+LADEF void v4f_lerp_n(V4f *out, const V4f *a, const V4f *b, const V4f *t, size_t n);
+LADEF void v4f_clamp_n(V4f *out, const V4f *x, const V4f *a, const V4f *b, size_t n);
+LADEF void v4f_len_n(float *out, const V4f *a, size_t n);
+LADEF void v2d_sum_n(V2d *out, const V2d *a, const V2d *b, size_t n);
+LADEF void v2d_sub_n(V2d *out, const V2d *a, const V2d *b, size_t n);
+LADEF void v2d_mul_n(V2d *out, const V2d *a, const V2d *b, size_t n);
+LADEF void v2d_div_n(V2d *out, const V2d *a, const V2d *b, size_t n);
+LADEF void v2d_sqrt_n(V2d *out, const V2d *a, size_t n);
+LADEF void v2d_min_n(V2d *out, const V2d *a, const V2d *b, size_t n);
+LADEF void v2d_max_n(V2d *out, const V2d *a, const V2d *b, size_t n);
+LADEF void v2d_lerp_n(V2d *out, const V2d *a, const V2d *b, const V2d *t, size_t n);
+LADEF void v2d_clamp_n(V2d *out, const V2d *x, const V2d *a, const V2d *b, size_t n);
+LADEF void v2d_len_n(double *out, const V2d *a, size_t n);
+LADEF void v3d_sum_n(V3d *out, const V3d *a, const V3d *b, size_t n);
+LADEF void v3d_sub_n(V3d *out, const V3d *a, const V3d *b, size_t n);
+LADEF void v3d_mul_n(V3d *out, const V3d *a, const V3d *b, size_t n);
+LADEF void v3d_div_n(V3d *out, const V3d *a, const V3d *b, size_t n);
+LADEF void v3d_sqrt_n(V3d *out, const V3d *a, size_t n);
+LADEF void v3d_min_n(V3d *out, const V3d *a, const V3d *b, size_t n);
+LADEF void v3d_max_n(V3d *out, const V3d *a, const V3d *b, size_t n);
+LADEF void v3d_lerp_n(V3d *out, const V3d *a, const V3d *b, const V3d *t, size_t n);
+LADEF void v3d_clamp_n(V3d *out, const V3d *x, const V3d *a, const V3d *b, size_t n);
+LADEF void v3d_len_n(double *out, const V3d *a, size_t n);
+LADEF void v4d_sum_n(V4d *out, const V4d *a, const V4d *b, size_t n);
+LADEF void v4d_sub_n(V4d *out, const V4d *a, const V4d *b, size_t n);
+LADEF void v4d_mul_n(V4d *out, const V4d *a, const V4d *b, size_t n);
+LADEF void v4d_div_n(V4d *out, const V4d *a, const V4d *b, size_t n);
+LADEF void v4d_sqrt_n(V4d *out, const V4d *a, size_t n);
+LADEF void v4d_min_n(V4d *out, const V4d *a, const V4d *b, size_t n);
+LADEF void v4d_max_n(V4d *out, const V4d *a, const V4d *b, size_t n);
+LADEF void v4d_lerp_n(V4d *out, const V4d *a, const V4d *b, const V4d *t, size_t n);
+LADEF void v4d_clamp_n(V4d *out, const V4d *x, const V4d *a, const V4d *b, size_t n);
+LADEF void v4d_len_n(double *out, const V4d *a, size_t n);
+LADEF void v2i_sum_n(V2i *out, const V2i *a, const V2i *b, size_t n);
+LADEF void v2i_sub_n(V2i *out, const V2i *a, const V2i *b, size_t n);
+LADEF void v2i_mul_n(V2i *out, const V2i *a, const V2i *b, size_t n);
+LADEF void v2i_div_n(V2i *out, const V2i *a, const V2i *b, size_t n);
+LADEF void v2i_min_n(V2i *out, const V2i *a, const V2i *b, size_t n);
+LADEF void v2i_max_n(V2i *out, const V2i *a, const V2i *b, size_t n);
+LADEF void v2i_clamp_n(V2i *out, const V2i *x, const V2i *a, const V2i *b, size_t n);
+LADEF void v3i_sum_n(V3i *out, const V3i *a, const V3i *b, size_t n);
+LADEF void v3i_sub_n(V3i *out, const V3i *a, const V3i *b, size_t n);
+LADEF void v3i_mul_n(V3i *out, const V3i *a, const V3i *b, size_t n);
+LADEF void v3i_div_n(V3i *out, const V3i *a, const V3i *b, size_t n);
+LADEF void v3i_min_n(V3i *out, const V3i *a, const V3i *b, size_t n);
+LADEF void v3i_max_n(V3i *out, const V3i *a, const V3i *b, size_t n);
+LADEF void v3i_clamp_n(V3i *out, const V3i *x, const V3i *a, const V3i *b, size_t n);
+LADEF void v4i_sum_n(V4i *out, const V4i *a, const V4i *b, size_t n);
+LADEF void v4i_sub_n(V4i *out, const V4i *a, const V4i *b, size_t n);
+LADEF void v4i_mul_n(V4i *out, const V4i *a, const V4i *b, size_t n);
+LADEF void v4i_div_n(V4i *out, const V4i *a, const V4i *b, size_t n);
+LADEF void v4i_min_n(V4i *out, const V4i *a, const V4i *b, size_t n);
+LADEF void v4i_max_n(V4i *out, const V4i *a, const V4i *b, size_t n);
+LADEF void v4i_clamp_n(V4i *out, const V4i *x, const V4i *a, const V4i *b, size_t n);
+LADEF void v2u_sum_n(V2u *out, const V2u *a, const V2u *b, size_t n);
+LADEF void v2u_sub_n(V2u *out, const V2u *a, const V2u *b, size_t n);
+LADEF void v2u_mul_n(V2u *out, const V2u *a, const V2u *b, size_t n);
+LADEF void v2u_div_n(V2u *out, const V2u *a, const V2u *b, size_t n);
+LADEF void v2u_min_n(V2u *out, const V2u *a, const V2u *b, size_t n);
+LADEF void v2u_max_n(V2u *out, const V2u *a, const V2u *b, size_t n);
+LADEF void v2u_clamp_n(V2u *out, const V2u *x, const V2u *a, const V2u *b, size_t n);
+LADEF void v3u_sum_n(V3u *out, const V3u *a, const V3u *b, size_t n);
+LADEF void v3u_sub_n(V3u *out, const V3u *a, const V3u *b, size_t n);
+LADEF void v3u_mul_n(V3u *out, const V3u *a, const V3u *b, size_t n);
+LADEF void v3u_div_n(V3u *out, const V3u *a, const V3u *b, size_t n);
+LADEF void v3u_min_n(V3u *out, const V3u *a, const V3u *b, size_t n);
+LADEF void v3u_max_n(V3u *out, const V3u *a, const V3u *b, size_t n);
+LADEF void v3u_clamp_n(V3u *out, const V3u *x, const V3u *a, const V3u *b, size_t n);
+LADEF void v4u_sum_n(V4u *out, const V4u *a, const V4u *b, size_t n);
+LADEF void v4u_sub_n(V4u *out, const V4u *a, const V4u *b, size_t n);
+LADEF void v4u_mul_n(V4u *out, const V4u *a, const V4u *b, size_t n);
+LADEF void v4u_div_n(V4u *out, const V4u *a, const V4u *b, size_t n);
+LADEF void v4u_min_n(V4u *out, const V4u *a, const V4u *b, size_t n);
+LADEF void v4u_max_n(V4u *out, const V4u *a, const V4u *b, size_t n);
+LADEF void v4u_clamp_n(V4u *out, const V4u *x, const V4u *a, const V4u *b, size_t n);
+
+// Matrices are stored column-major, `m[column][row]`, the same way as GLSL
+// expects them, so they can be uploaded with glUniformMatrix*fv() without
+// transposing. A2f is a 2D affine transform: the columns are the images of
+// the x and y axes and the translation. The *_inverse() functions of the
+// singular matrices return infinities and NaNs.
+typedef struct { float m[2][2]; } M2f;
+typedef struct { float m[3][3]; } M3f;
+typedef struct { float m[4][4]; } M4f;
+typedef struct { float m[3][2]; } A2f;
+
+LADEF M2f m2f_id(void);
+LADEF M2f m2f_mul(M2f a, M2f b);
+LADEF V2f m2f_mul_v2f(M2f a, V2f v);
+LADEF M2f m2f_transpose(M2f a);
+LADEF float m2f_det(M2f a);
+LADEF M2f m2f_inverse(M2f a);
+LADEF void m2f_mul_v2f_n(V2f *out, M2f a, const V2f *v, size_t n);
+
+LADEF M3f m3f_id(void);
+LADEF M3f m3f_mul(M3f a, M3f b);
+LADEF V3f m3f_mul_v3f(M3f a, V3f v);
+LADEF M3f m3f_transpose(M3f a);
+LADEF float m3f_det(M3f a);
+LADEF M3f m3f_inverse(M3f a);
+LADEF void m3f_mul_v3f_n(V3f *out, M3f a, const V3f *v, size_t n);
+LADEF M3f m3f_a2f(A2f a);
+
+LADEF M4f m4f_id(void);
+LADEF M4f m4f_mul(M4f a, M4f b);
+LADEF V4f m4f_mul_v4f(M4f a, V4f v);
+LADEF M4f m4f_transpose(M4f a);
+LADEF float m4f_det(M4f a);
+LADEF M4f m4f_inverse(M4f a);
+LADEF void m4f_mul_v4f_n(V4f *out, M4f a, const V4f *v, size_t n);
+LADEF M4f m4f_ortho(float left, float right, float bottom, float top, float znear, float zfar);
+
+LADEF A2f a2f_id(void);
+LADEF A2f a2f_translate(V2f t);
+LADEF A2f a2f_scale(V2f s);
+LADEF A2f a2f_rotate(float angle);
+// a2f_mul(a, b) applies `b` first and then `a`
+LADEF A2f a2f_mul(A2f a, A2f b);
+LADEF V2f a2f_apply(A2f a, V2f p);
+LADEF A2f a2f_inverse(A2f a);
+LADEF void a2f_apply_n(V2f *out, A2f a, const V2f *p, size_t n);
+
+// Fast approximations of the transcendental functions: polynomials that are
+// vectorized with LA_SIMD and give the same results with and without it.
+// The maximal error against the correctly rounded result:
+//   sinf_fast, cosf_fast  8e-8 absolute (2 ULP away from the zeros) for |x| <= 8192
+//   expf_fast             1 ULP, 0 below -87.3 (no denormals), +inf above 88.7
+//   logf_fast             1 ULP for the normal x > 0, -inf for x = 0 and the denormals, NaN for x < 0
+//   powf_fast             exp(y*log(x)), the error of log grows with |y|, NaN for x < 0
+//   rsqrtf_fast           4 ULP for x > 0
+// Outside of the ranges above they are still finite (except where noted) but
+// not accurate, use the libm functions there.
+LADEF float sinf_fast(float x);
+LADEF float cosf_fast(float x);
+LADEF float expf_fast(float x);
+LADEF float logf_fast(float x);
+LADEF float powf_fast(float x, float y);
+LADEF float rsqrtf_fast(float x);
+
+LADEF V2f v2f_sin_fast(V2f a);
+LADEF V2f v2f_cos_fast(V2f a);
+LADEF V2f v2f_exp_fast(V2f a);
+LADEF V2f v2f_log_fast(V2f a);
+LADEF V2f v2f_pow_fast(V2f base, V2f exp);
+LADEF V2f v2f_rsqrt_fast(V2f a);
+LADEF V3f v3f_sin_fast(V3f a);
+LADEF V3f v3f_cos_fast(V3f a);
+LADEF V3f v3f_exp_fast(V3f a);
+LADEF V3f v3f_log_fast(V3f a);
+LADEF V3f v3f_pow_fast(V3f base, V3f exp);
+LADEF V3f v3f_rsqrt_fast(V3f a);
+LADEF V4f v4f_sin_fast(V4f a);
+LADEF V4f v4f_cos_fast(V4f a);
+LADEF V4f v4f_exp_fast(V4f a);
+LADEF V4f v4f_log_fast(V4f a);
+LADEF V4f v4f_pow_fast(V4f base, V4f exp);
+LADEF V4f v4f_rsqrt_fast(V4f a);
+
+LADEF void floats_sin_fast_n(float *out, const float *a, size_t n);
+LADEF void floats_cos_fast_n(float *out, const float *a, size_t n);
+LADEF void floats_exp_fast_n(float *out, const float *a, size_t n);
+LADEF void floats_log_fast_n(float *out, const float *a, size_t n);
+LADEF void floats_pow_fast_n(float *out, const float *base, const float *exp, size_t n);
+LADEF void floats_rsqrt_fast_n(float *out, const float *a, size_t n);
+
+// Padded and over-aligned variants of the vectors for the arrays that are
+// processed with full-width aligned loads and stores. V3fa, V4fa, V3ia, V4ia,
+// V3ua and V4ua are 16 bytes aligned to 16 (an SSE register), V3da and V4da
+// are 32 bytes aligned to 16 (two SSE registers): the structs aligned to 32
+// can not be passed by value portably (MSVC rejects them, GCC warns about the
+// ABI). The constructors set `pad` to 0, after an operation it holds whatever
+// the operation made of it. The API is the one of the unaligned types. The
+// batch kernels process the padding too, a vector at a time with the aligned
+// loads and stores and without a scalar tail. With AVX a V3da or V4da is one
+// register instead, loaded with the unaligned instruction.
+typedef struct { _Alignas(16) float x; float y, z, pad; } V3fa;
+typedef struct { _Alignas(16) float x; float y, z, w; } V4fa;
+typedef struct { _Alignas(16) double x; double y, z, pad; } V3da;
+typedef struct { _Alignas(16) double x; double y, z, w; } V4da;
+typedef struct { _Alignas(16) int x; int y, z, pad; } V3ia;
+typedef struct { _Alignas(16) int x; int y, z, w; } V4ia;
+typedef struct { _Alignas(16) unsigned int x; unsigned int y, z, pad; } V3ua;
+typedef struct { _Alignas(16) unsigned int x; unsigned int y, z, w; } V4ua;
+
+// Allocates `size` bytes aligned to `alignment` (a power of two) for the
+// arrays of the aligned vectors, returns NULL if there is not enough memory.
+// Free it with la_aligned_free().
+LADEF void *la_aligned_alloc(size_t alignment, size_t size);
+LADEF void la_aligned_free(void *p);
+
+LADEF V3fa v3fa(float x, float y, float z);
+LADEF V3fa v3faf(float x);
+LADEF V3fa v3fa3f(V3f a);
+LADEF V3f v3f3fa(V3fa a);
+LADEF V3fa v3fa_sum(V3fa a, V3fa b);
+LADEF V3fa v3fa_sub(V3fa a, V3fa b);
+LADEF V3fa v3fa_mul(V3fa a, V3fa b);
+LADEF V3fa v3fa_div(V3fa a, V3fa b);
+LADEF V3fa v3fa_sqrt(V3fa a);
+LADEF V3fa v3fa_pow(V3fa base, V3fa exp);
+LADEF V3fa v3fa_sin(V3fa a);
+LADEF V3fa v3fa_cos(V3fa a);
+LADEF V3fa v3fa_min(V3fa a, V3fa b);
+LADEF V3fa v3fa_max(V3fa a, V3fa b);
+LADEF V3fa v3fa_lerp(V3fa a, V3fa b, V3fa t);
+LADEF V3fa v3fa_floor(V3fa a);
+LADEF V3fa v3fa_ceil(V3fa a);
+LADEF V3fa v3fa_clamp(V3fa x, V3fa a, V3fa b);
+LADEF float v3fa_sqrlen(V3fa a);
+LADEF float v3fa_len(V3fa a);
+LADEF void v3fa_sum_n(V3fa *out, const V3fa *a, const V3fa *b, size_t n);
+LADEF void v3fa_sub_n(V3fa *out, const V3fa *a, const V3fa *b, size_t n);
+LADEF void v3fa_mul_n(V3fa *out, const V3fa *a, const V3fa *b, size_t n);
+LADEF void v3fa_div_n(V3fa *out, const V3fa *a, const V3fa *b, size_t n);
+LADEF void v3fa_sqrt_n(V3fa *out, const V3fa *a, size_t n);
+LADEF void v3fa_min_n(V3fa *out, const V3fa *a, const V3fa *b, size_t n);
+LADEF void v3fa_max_n(V3fa *out, const V3fa *a, const V3fa *b, size_t n);
+LADEF void v3fa_lerp_n(V3fa *out, const V3fa *a, const V3fa *b, const V3fa *t, size_t n);
+LADEF void v3fa_clamp_n(V3fa *out, const V3fa *x, const V3fa *a, const V3fa *b, size_t n);
+LADEF void v3fa_len_n(float *out, const V3fa *a, size_t n);
+
+LADEF V4fa v4fa(float x, float y, float z, float w);
+LADEF V4fa v4faf(float x);
+LADEF V4fa v4fa4f(V4f a);
+LADEF V4f v4f4fa(V4fa a);
+LADEF V4fa v4fa_sum(V4fa a, V4fa b);
+LADEF V4fa v4fa_sub(V4fa a, V4fa b);
+LADEF V4fa v4fa_mul(V4fa a, V4fa b);
+LADEF V4fa v4fa_div(V4fa a, V4fa b);
+LADEF V4fa v4fa_sqrt(V4fa a);
+LADEF V4fa v4fa_pow(V4fa base, V4fa exp);
+LADEF V4fa v4fa_sin(V4fa a);
+LADEF V4fa v4fa_cos(V4fa a);
+LADEF V4fa v4fa_min(V4fa a, V4fa b);
+LADEF V4fa v4fa_max(V4fa a, V4fa b);
+LADEF V4fa v4fa_lerp(V4fa a, V4fa b, V4fa t);
+LADEF V4fa v4fa_floor(V4fa a);
+LADEF V4fa v4fa_ceil(V4fa a);
+LADEF V4fa v4fa_clamp(V4fa x, V4fa a, V4fa b);
+LADEF float v4fa_sqrlen(V4fa a);
+LADEF float v4fa_len(V4fa a);
+LADEF void v4fa_sum_n(V4fa *out, const V4fa *a, const V4fa *b, size_t n);
+LADEF void v4fa_sub_n(V4fa *out, const V4fa *a, const V4fa *b, size_t n);
+LADEF void v4fa_mul_n(V4fa *out, const V4fa *a, const V4fa *b, size_t n);
+LADEF void v4fa_div_n(V4fa *out, const V4fa *a, const V4fa *b, size_t n);
+LADEF void v4fa_sqrt_n(V4fa *out, const V4fa *a, size_t n);
+LADEF void v4fa_min_n(V4fa *out, const V4fa *a, const V4fa *b, size_t n);
+LADEF void v4fa_max_n(V4fa *out, const V4fa *a, const V4fa *b, size_t n);
+LADEF void v4fa_lerp_n(V4fa *out, const V4fa *a, const V4fa *b, const V4fa *t, size_t n);
+LADEF void v4fa_clamp_n(V4fa *out, const V4fa *x, const V4fa *a, const V4fa *b, size_t n);
+LADEF void v4fa_len_n(float *out, const V4fa *a, size_t n);
+
+LADEF V3da v3da(double x, double y, double z);
+LADEF V3da v3dad(double x);
+LADEF V3da v3da3d(V3d a);
+LADEF V3d v3d3da(V3da a);
+LADEF V3da v3da_sum(V3da a, V3da b);
+LADEF V3da v3da_sub(V3da a, V3da b);
+LADEF V3da v3da_mul(V3da a, V3da b);
+LADEF V3da v3da_div(V3da a, V3da b);
+LADEF V3da v3da_sqrt(V3da a);
+LADEF V3da v3da_pow(V3da base, V3da exp);
+LADEF V3da v3da_sin(V3da a);
+LADEF V3da v3da_cos(V3da a);
+LADEF V3da v3da_min(V3da a, V3da b);
+LADEF V3da v3da_max(V3da a, V3da b);
+LADEF V3da v3da_lerp(V3da a, V3da b, V3da t);
+LADEF V3da v3da_floor(V3da a);
+LADEF V3da v3da_ceil(V3da a);
+LADEF V3da v3da_clamp(V3da x, V3da a, V3da b);
+LADEF double v3da_sqrlen(V3da a);
+LADEF double v3da_len(V3da a);
+LADEF void v3da_sum_n(V3da *out, const V3da *a, const V3da *b, size_t n);
+LADEF void v3da_sub_n(V3da *out, const V3da *a, const V3da *b, size_t n);
+LADEF void v3da_mul_n(V3da *out, const V3da *a, const V3da *b, size_t n);
+LADEF void v3da_div_n(V3da *out, const V3da *a, const V3da *b, size_t n);
+LADEF void v3da_sqrt_n(V3da *out, const V3da *a, size_t n);
+LADEF void v3da_min_n(V3da *out, const V3da *a, const V3da *b, size_t n);
+LADEF void v3da_max_n(V3da *out, const V3da *a, const V3da *b, size_t n);
+LADEF void v3da_lerp_n(V3da *out, const V3da *a, const V3da *b, const V3da *t, size_t n);
+LADEF void v3da_clamp_n(V3da *out, const V3da *x, const V3da *a, const V3da *b, size_t n);
+LADEF void v3da_len_n(double *out, const V3da *a, size_t n);
+
+LADEF V4da v4da(double x, double y, double z, double w);
+LADEF V4da v4dad(double x);
+LADEF V4da v4da4d(V4d a);
+LADEF V4d v4d4da(V4da a);
+LADEF V4da v4da_sum(V4da a, V4da b);
+LADEF V4da v4da_sub(V4da a, V4da b);
+LADEF V4da v4da_mul(V4da a, V4da b);
+LADEF V4da v4da_div(V4da a, V4da b);
+LADEF V4da v4da_sqrt(V4da a);
+LADEF V4da v4da_pow(V4da base, V4da exp);
+LADEF V4da v4da_sin(V4da a);
+LADEF V4da v4da_cos(V4da a);
+LADEF V4da v4da_min(V4da a, V4da b);
+LADEF V4da v4da_max(V4da a, V4da b);
+LADEF V4da v4da_lerp(V4da a, V4da b, V4da t);
+LADEF V4da v4da_floor(V4da a);
+LADEF V4da v4da_ceil(V4da a);
+LADEF V4da v4da_clamp(V4da x, V4da a, V4da b);
+LADEF double v4da_sqrlen(V4da a);
+LADEF double v4da_len(V4da a);
+LADEF void v4da_sum_n(V4da *out, const V4da *a, const V4da *b, size_t n);
+LADEF void v4da_sub_n(V4da *out, const V4da *a, const V4da *b, size_t n);
+LADEF void v4da_mul_n(V4da *out, const V4da *a, const V4da *b, size_t n);
+LADEF void v4da_div_n(V4da *out, const V4da *a, const V4da *b, size_t n);
+LADEF void v4da_sqrt_n(V4da *out, const V4da *a, size_t n);
+LADEF void v4da_min_n(V4da *out, const V4da *a, const V4da *b, size_t n);
+LADEF void v4da_max_n(V4da *out, const V4da *a, const V4da *b, size_t n);
+LADEF void v4da_lerp_n(V4da *out, const V4da *a, const V4da *b, const V4da *t, size_t n);
+LADEF void v4da_clamp_n(V4da *out, const V4da *x, const V4da *a, const V4da *b, size_t n);
+LADEF void v4da_len_n(double *out, const V4da *a, size_t n);
+
+LADEF V3ia v3ia(int x, int y, int z);
+LADEF V3ia v3iai(int x);
+LADEF V3ia v3ia3i(V3i a);
+LADEF V3i v3i3ia(V3ia a);
+LADEF V3ia v3ia_sum(V3ia a, V3ia b);
+LADEF V3ia v3ia_sub(V3ia a, V3ia b);
+LADEF V3ia v3ia_mul(V3ia a, V3ia b);
+LADEF V3ia v3ia_div(V3ia a, V3ia b);
+LADEF V3ia v3ia_min(V3ia a, V3ia b);
+LADEF V3ia v3ia_max(V3ia a, V3ia b);
+LADEF V3ia v3ia_clamp(V3ia x, V3ia a, V3ia b);
+LADEF int v3ia_sqrlen(V3ia a);
+LADEF void v3ia_sum_n(V3ia *out, const V3ia *a, const V3ia *b, size_t n);
+LADEF void v3ia_sub_n(V3ia *out, const V3ia *a, const V3ia *b, size_t n);
+LADEF void v3ia_mul_n(V3ia *out, const V3ia *a, const V3ia *b, size_t n);
+LADEF void v3ia_div_n(V3ia *out, const V3ia *a, const V3ia *b, size_t n);
+LADEF void v3ia_min_n(V3ia *out, const V3ia *a, const V3ia *b, size_t n);
+LADEF void v3ia_max_n(V3ia *out, const V3ia *a, const V3ia *b, size_t n);
+LADEF void v3ia_clamp_n(V3ia *out, const V3ia *x, const V3ia *a, const V3ia *b, size_t n);
+
+LADEF V4ia v4ia(int x, int y, int z, int w);
+LADEF V4ia v4iai(int x);
+LADEF V4ia v4ia4i(V4i a);
+LADEF V4i v4i4ia(V4ia a);
+LADEF V4ia v4ia_sum(V4ia a, V4ia b);
+LADEF V4ia v4ia_sub(V4ia a, V4ia b);
+LADEF V4ia v4ia_mul(V4ia a, V4ia b);
+LADEF V4ia v4ia_div(V4ia a, V4ia b);
+LADEF V4ia v4ia_min(V4ia a, V4ia b);
+LADEF V4ia v4ia_max(V4ia a, V4ia b);
+LADEF V4ia v4ia_clamp(V4ia x, V4ia a, V4ia b);
+LADEF int v4ia_sqrlen(V4ia a);
+LADEF void v4ia_sum_n(V4ia *out, const V4ia *a, const V4ia *b, size_t n);
+LADEF void v4ia_sub_n(V4ia *out, const V4ia *a, const V4ia *b, size_t n);
+LADEF void v4ia_mul_n(V4ia *out, const V4ia *a, const V4ia *b, size_t n);
+LADEF void v4ia_div_n(V4ia *out, const V4ia *a, const V4ia *b, size_t n);
+LADEF void v4ia_min_n(V4ia *out, const V4ia *a, const V4ia *b, size_t n);
+LADEF void v4ia_max_n(V4ia *out, const V4ia *a, const V4ia *b, size_t n);
+LADEF void v4ia_clamp_n(V4ia *out, const V4ia *x, const V4ia *a, const V4ia *b, size_t n);
+
+LADEF V3ua v3ua(unsigned int x, unsigned int y, unsigned int z);
+LADEF V3ua v3uau(unsigned int x);
+LADEF V3ua v3ua3u(V3u a);
+LADEF V3u v3u3ua(V3ua a);
+LADEF V3ua v3ua_sum(V3ua a, V3ua b);
+LADEF V3ua v3ua_sub(V3ua a, V3ua b);
+LADEF V3ua v3ua_mul(V3ua a, V3ua b);
+LADEF V3ua v3ua_div(V3ua a, V3ua b);
+LADEF V3ua v3ua_min(V3ua a, V3ua b);
+LADEF V3ua v3ua_max(V3ua a, V3ua b);
+LADEF V3ua v3ua_clamp(V3ua x, V3ua a, V3ua b);
+LADEF unsigned int v3ua_sqrlen(V3ua a);
+LADEF void v3ua_sum_n(V3ua *out, const V3ua *a, const V3ua *b, size_t n);
+LADEF void v3ua_sub_n(V3ua *out, const V3ua *a, const V3ua *b, size_t n);
+LADEF void v3ua_mul_n(V3ua *out, const V3ua *a, const V3ua *b, size_t n);
+LADEF void v3ua_div_n(V3ua *out, const V3ua *a, const V3ua *b, size_t n);
+LADEF void v3ua_min_n(V3ua *out, const V3ua *a, const V3ua *b, size_t n);
+LADEF void v3ua_max_n(V3ua *out, const V3ua *a, const V3ua *b, size_t n);
+LADEF void v3ua_clamp_n(V3ua *out, const V3ua *x, const V3ua *a, const V3ua *b, size_t n);
+
+LADEF V4ua v4ua(unsigned int x, unsigned int y, unsigned int z, unsigned int w);
+LADEF V4ua v4uau(unsigned int x);
+LADEF V4ua v4ua4u(V4u a);
+LADEF V4u v4u4ua(V4ua a);
+LADEF V4ua v4ua_sum(V4ua a, V4ua b);
+LADEF V4ua v4ua_sub(V4ua a, V4ua b);
+LADEF V4ua v4ua_mul(V4ua a, V4ua b);
+LADEF V4ua v4ua_div(V4ua a, V4ua b);
+LADEF V4ua v4ua_min(V4ua a, V4ua b);
+LADEF V4ua v4ua_max(V4ua a, V4ua b);
+LADEF V4ua v4ua_clamp(V4ua x, V4ua a, V4ua b);
+LADEF unsigned int v4ua_sqrlen(V4ua a);
+LADEF void v4ua_sum_n(V4ua *out, const V4ua *a, const V4ua *b, size_t n);
+LADEF void v4ua_sub_n(V4ua *out, const V4ua *a, const V4ua *b, size_t n);
+LADEF void v4ua_mul_n(V4ua *out, const V4ua *a, const V4ua *b, size_t n);
+LADEF void v4ua_div_n(V4ua *out, const V4ua *a, const V4ua *b, size_t n);
+LADEF void v4ua_min_n(V4ua *out, const V4ua *a, const V4ua *b, size_t n);
+LADEF void v4ua_max_n(V4ua *out, const V4ua *a, const V4ua *b, size_t n);
+LADEF void v4ua_clamp_n(V4ua *out, const V4ua *x, const V4ua *a, const V4ua *b, size_t n);
+
 #endif // LA_H_
 
 #ifdef LA_IMPLEMENTATION
 
+#if LA_SSE2
+static inline __m128 la_load4f(V4f a) { return _mm_loadu_ps(&a.x); }
+static inline V4f la_store4f(__m128 r) { V4f a; _mm_storeu_ps(&a.x, r); return a; }
+
+// The upper half is filled with `pad`, so it does not produce any exceptions
+static inline __m128 la_load2f(V2f a, float pad) { return _mm_loadl_pi(_mm_set1_ps(pad), (const __m64*) &a); }
+static inline V2f la_store2f(__m128 r) { V2f a; _mm_storel_pi((__m64*) &a, r); return a; }
+
+static inline __m128i la_load4i(V4i a) { return _mm_loadu_si128((const __m128i*) &a); }
+static inline V4i la_store4i(__m128i r) { V4i a; _mm_storeu_si128((__m128i*) &a, r); return a; }
+static inline __m128i la_load4u(V4u a) { return _mm_loadu_si128((const __m128i*) &a); }
+static inline V4u la_store4u(__m128i r) { V4u a; _mm_storeu_si128((__m128i*) &a, r); return a; }
+
+// fminf() and fmaxf() return the other operand if one of them is NaN, minps
+// and maxps return the second one
+static inline __m128 la_fmin_ps(__m128 a, __m128 b)
+{
+    __m128 b_nan = _mm_cmpunord_ps(b, b);
+    return _mm_or_ps(_mm_and_ps(b_nan, a), _mm_andnot_ps(b_nan, _mm_min_ps(a, b)));
+}
+
+static inline __m128 la_fmax_ps(__m128 a, __m128 b)
+{
+    __m128 b_nan = _mm_cmpunord_ps(b, b);
+    return _mm_or_ps(_mm_and_ps(b_nan, a), _mm_andnot_ps(b_nan, _mm_max_ps(a, b)));
+}
+
+static inline __m128d la_fmin_pd128(__m128d a, __m128d b)
+{
+    __m128d b_nan = _mm_cmpunord_pd(b, b);
+    return _mm_or_pd(_mm_and_pd(b_nan, a), _mm_andnot_pd(b_nan, _mm_min_pd(a, b)));
+}
+
+static inline __m128d la_fmax_pd128(__m128d a, __m128d b)
+{
+    __m128d b_nan = _mm_cmpunord_pd(b, b);
+    return _mm_or_pd(_mm_and_pd(b_nan, a), _mm_andnot_pd(b_nan, _mm_max_pd(a, b)));
+}
+#endif // LA_SSE2
+
+#if LA_AVX
+static inline __m256d la_load4d(V4d a) { return _mm256_loadu_pd(&a.x); }
+static inline V4d la_store4d(__m256d r) { V4d a; _mm256_storeu_pd(&a.x, r); return a; }
+
+static inline __m256d la_fmin_pd(__m256d a, __m256d b)
+{
+    return _mm256_blendv_pd(_mm256_min_pd(a, b), a, _mm256_cmp_pd(b, b, _CMP_UNORD_Q));
+}
+
+static inline __m256d la_fmax_pd(__m256d a, __m256d b)
+{
+    return _mm256_blendv_pd(_mm256_max_pd(a, b), a, _mm256_cmp_pd(b, b, _CMP_UNORD_Q));
+}
+#endif // LA_AVX
+
 LADEF float lerpf(float a, float b, float t)
 {
     return a + (b - a) * t;
@@ -524,37 +1086,57 @@ LADEF V2f v2f4u(V4u a)
 
 LADEF V2f v2f_sum(V2f a, V2f b)
 {
+#if LA_SSE2
+    return la_store2f(_mm_add_ps(la_load2f(a, 0.0f), la_load2f(b, 0.0f)));
+#else
     a.x += b.x;
     a.y += b.y;
     return a;
+#endif // LA_SSE2
 }
 
 LADEF V2f v2f_sub(V2f a, V2f b)
 {
+#if LA_SSE2
+    return la_store2f(_mm_sub_ps(la_load2f(a, 0.0f), la_load2f(b, 0.0f)));
+#else
     a.x -= b.x;
     a.y -= b.y;
     return a;
+#endif // LA_SSE2
 }
 
 LADEF V2f v2f_mul(V2f a, V2f b)
 {
+#if LA_SSE2
+    return la_store2f(_mm_mul_ps(la_load2f(a, 0.0f), la_load2f(b, 0.0f)));
+#else
     a.x *= b.x;
     a.y *= b.y;
     return a;
+#endif // LA_SSE2
 }
 
 LADEF V2f v2f_div(V2f a, V2f b)
 {
+#if LA_SSE2
+    return la_store2f(_mm_div_ps(la_load2f(a, 0.0f), la_load2f(b, 1.0f)));
+#else
     a.x /= b.x;
     a.y /= b.y;
     return a;
+#endif // LA_SSE2
 }
 
 LADEF V2f v2f_sqrt(V2f a)
 {
+#if LA_SSE2
+    return la_store2f(_mm_sqrt_ps(la_load2f(a, 0.0f)));
+#else
     a.x = sqrtf(a.x);
     a.y = sqrtf(a.y);
     return a;
+#endif // LA_SSE2
 }
 
 LADEF V2f v2f_pow(V2f base, V2f exp)
@@ -580,44 +1162,69 @@ LADEF V2f v2f_cos(V2f a)
 
 LADEF V2f v2f_min(V2f a, V2f b)
 {
+#if LA_SSE2
+    return la_store2f(la_fmin_ps(la_load2f(a, 0.0f), la_load2f(b, 0.0f)));
+#else
     a.x = fminf(a.x, b.x);
     a.y = fminf(a.y, b.y);
     return a;
+#endif // LA_SSE2
 }
 
 LADEF V2f v2f_max(V2f a, V2f b)
 {
+#if LA_SSE2
+    return la_store2f(la_fmax_ps(la_load2f(a, 0.0f), la_load2f(b, 0.0f)));
+#else
     a.x = fmaxf(a.x, b.x);
     a.y = fmaxf(a.y, b.y);
     return a;
+#endif // LA_SSE2
 }
 
 LADEF V2f v2f_lerp(V2f a, V2f b, V2f t)
 {
+#if LA_SSE2
+    __m128 va = la_load2f(a, 0.0f);
+    return la_store2f(_mm_add_ps(va, _mm_mul_ps(_mm_sub_ps(la_load2f(b, 0.0f), va), la_load2f(t, 0.0f))));
+#else
     a.x = lerpf(a.x, b.x, t.x);
     a.y = lerpf(a.y, b.y, t.y);
     return a;
+#endif // LA_SSE2
 }
 
 LADEF V2f v2f_floor(V2f a)
 {
+#if LA_SSE41
+    return la_store2f(_mm_floor_ps(la_load2f(a, 0.0f)));
+#else
     a.x = floorf(a.x);
     a.y = floorf(a.y);
     return a;
+#endif // LA_SSE41
 }
 
 LADEF V2f v2f_ceil(V2f a)
 {
+#if LA_SSE41
+    return la_store2f(_mm_ceil_ps(la_load2f(a, 0.0f)));
+#else
     a.x = ceilf(a.x);
     a.y = ceilf(a.y);
     return a;
+#endif // LA_SSE41
 }
 
 LADEF V2f v2f_clamp(V2f x, V2f a, V2f b)
 {
+#if LA_SSE2
+    return la_store2f(la_fmin_ps(la_fmax_ps(la_load2f(a, 0.0f), la_load2f(x, 0.0f)), la_load2f(b, 0.0f)));
+#else
     x.x = clampf(x.x, a.x, b.x);
     x.y = clampf(x.y, a.y, b.y);
     return x;
+#endif // LA_SSE2
 }
 
 LADEF float v2f_sqrlen(V2f a)
@@ -2094,47 +2701,67 @@ LADEF V4f v4f4u(V4u a)
 
 LADEF V4f v4f_sum(V4f a, V4f b)
 {
+#if LA_SSE2
+    return la_store4f(_mm_add_ps(la_load4f(a), la_load4f(b)));
+#else
     a.x += b.x;
     a.y += b.y;
     a.z += b.z;
     a.w += b.w;
     return a;
+#endif // LA_SSE2
 }
 
 LADEF V4f v4f_sub(V4f a, V4f b)
 {
+#if LA_SSE2
+    return la_store4f(_mm_sub_ps(la_load4f(a), la_load4f(b)));
+#else
     a.x -= b.x;
     a.y -= b.y;
     a.z -= b.z;
     a.w -= b.w;
     return a;
+#endif // LA_SSE2
 }
 
 LADEF V4f v4f_mul(V4f a, V4f b)
 {
+#if LA_SSE2
+    return la_store4f(_mm_mul_ps(la_load4f(a), la_load4f(b)));
+#else
     a.x *= b.x;
     a.y *= b.y;
     a.z *= b.z;
     a.w *= b.w;
     return a;
+#endif // LA_SSE2
 }
 
 LADEF V4f v4f_div(V4f a, V4f b)
 {
+#if LA_SSE2
+    return la_store4f(_mm_div_ps(la_load4f(a), la_load4f(b)));
+#else
     a.x /= b.x;
     a.y /= b.y;
     a.z /= b.z;
     a.w /= b.w;
     return a;
+#endif // LA_SSE2
 }
 
 LADEF V4f v4f_sqrt(V4f a)
 {
+#if LA_SSE2
+    return la_store4f(_mm_sqrt_ps(la_load4f(a)));
+#else
     a.x = sqrtf(a.x);
     a.y = sqrtf(a.y);
     a.z = sqrtf(a.z);
     a.w = sqrtf(a.w);
     return a;
+#endif // LA_SSE2
 }
 
 LADEF V4f v4f_pow(V4f base, V4f exp)
@@ -2166,56 +2793,81 @@ LADEF V4f v4f_cos(V4f a)
 
 LADEF V4f v4f_min(V4f a, V4f b)
 {
+#if LA_SSE2
+    return la_store4f(la_fmin_ps(la_load4f(a), la_load4f(b)));
+#else
     a.x = fminf(a.x, b.x);
     a.y = fminf(a.y, b.y);
     a.z = fminf(a.z, b.z);
     a.w = fminf(a.w, b.w);
     return a;
+#endif // LA_SSE2
 }
 
 LADEF V4f v4f_max(V4f a, V4f b)
 {
+#if LA_SSE2
+    return la_store4f(la_fmax_ps(la_load4f(a), la_load4f(b)));
+#else
     a.x = fmaxf(a.x, b.x);
     a.y = fmaxf(a.y, b.y);
     a.z = fmaxf(a.z, b.z);
     a.w = fmaxf(a.w, b.w);
     return a;
+#endif // LA_SSE2
 }
 
 LADEF V4f v4f_lerp(V4f a, V4f b, V4f t)
 {
+#if LA_SSE2
+    __m128 va = la_load4f(a);
+    return la_store4f(_mm_add_ps(va, _mm_mul_ps(_mm_sub_ps(la_load4f(b), va), la_load4f(t))));
+#else
     a.x = lerpf(a.x, b.x, t.x);
     a.y = lerpf(a.y, b.y, t.y);
     a.z = lerpf(a.z, b.z, t.z);
     a.w = lerpf(a.w, b.w, t.w);
     return a;
+#endif // LA_SSE2
 }
 
 LADEF V4f v4f_floor(V4f a)
 {
+#if LA_SSE41
+    return la_store4f(_mm_floor_ps(la_load4f(a)));
+#else
     a.x = floorf(a.x);
     a.y = floorf(a.y);
     a.z = floorf(a.z);
     a.w = floorf(a.w);
     return a;
+#endif // LA_SSE41
 }
 
 LADEF V4f v4f_ceil(V4f a)
 {
+#if LA_SSE41
+    return la_store4f(_mm_ceil_ps(la_load4f(a)));
+#else
     a.x = ceilf(a.x);
     a.y = ceilf(a.y);
     a.z = ceilf(a.z);
     a.w = ceilf(a.w);
     return a;
+#endif // LA_SSE41
 }
 
 LADEF V4f v4f_clamp(V4f x, V4f a, V4f b)
 {
+#if LA_SSE2
+    return la_store4f(la_fmin_ps(la_fmax_ps(la_load4f(a), la_load4f(x)), la_load4f(b)));
+#else
     x.x = clampf(x.x, a.x, b.x);
     x.y = clampf(x.y, a.y, b.y);
     x.z = clampf(x.z, a.z, b.z);
     x.w = clampf(x.w, a.w, b.w);
     return x;
+#endif // LA_SSE2
 }
 
 LADEF float v4f_sqrlen(V4f a)
@@ -2355,47 +3007,67 @@ LADEF V4d v4d4u(V4u a)
 
 LADEF V4d v4d_sum(V4d a, V4d b)
 {
+#if LA_AVX
+    return la_store4d(_mm256_add_pd(la_load4d(a), la_load4d(b)));
+#else
     a.x += b.x;
     a.y += b.y;
     a.z += b.z;
     a.w += b.w;
     return a;
+#endif // LA_AVX
 }
 
 LADEF V4d v4d_sub(V4d a, V4d b)
 {
+#if LA_AVX
+    return la_store4d(_mm256_sub_pd(la_load4d(a), la_load4d(b)));
+#else
     a.x -= b.x;
     a.y -= b.y;
     a.z -= b.z;
     a.w -= b.w;
     return a;
+#endif // LA_AVX
 }
 
 LADEF V4d v4d_mul(V4d a, V4d b)
 {
+#if LA_AVX
+    return la_store4d(_mm256_mul_pd(la_load4d(a), la_load4d(b)));
+#else
     a.x *= b.x;
     a.y *= b.y;
     a.z *= b.z;
     a.w *= b.w;
     return a;
+#endif // LA_AVX
 }
 
 LADEF V4d v4d_div(V4d a, V4d b)
 {
+#if LA_AVX
+    return la_store4d(_mm256_div_pd(la_load4d(a), la_load4d(b)));
+#else
     a.x /= b.x;
     a.y /= b.y;
     a.z /= b.z;
     a.w /= b.w;
     return a;
+#endif // LA_AVX
 }
 
 LADEF V4d v4d_sqrt(V4d a)
 {
+#if LA_AVX
+    return la_store4d(_mm256_sqrt_pd(la_load4d(a)));
+#else
     a.x = sqrt(a.x);
     a.y = sqrt(a.y);
     a.z = sqrt(a.z);
     a.w = sqrt(a.w);
     return a;
+#endif // LA_AVX
 }
 
 LADEF V4d v4d_pow(V4d base, V4d exp)
@@ -2427,56 +3099,81 @@ LADEF V4d v4d_cos(V4d a)
 
 LADEF V4d v4d_min(V4d a, V4d b)
 {
+#if LA_AVX
+    return la_store4d(la_fmin_pd(la_load4d(a), la_load4d(b)));
+#else
     a.x = fmin(a.x, b.x);
     a.y = fmin(a.y, b.y);
     a.z = fmin(a.z, b.z);
     a.w = fmin(a.w, b.w);
     return a;
+#endif // LA_AVX
 }
 
 LADEF V4d v4d_max(V4d a, V4d b)
 {
+#if LA_AVX
+    return la_store4d(la_fmax_pd(la_load4d(a), la_load4d(b)));
+#else
     a.x = fmax(a.x, b.x);
     a.y = fmax(a.y, b.y);
     a.z = fmax(a.z, b.z);
     a.w = fmax(a.w, b.w);
     return a;
+#endif // LA_AVX
 }
 
 LADEF V4d v4d_lerp(V4d a, V4d b, V4d t)
 {
+#if LA_AVX
+    __m256d va = la_load4d(a);
+    return la_store4d(_mm256_add_pd(va, _mm256_mul_pd(_mm256_sub_pd(la_load4d(b), va), la_load4d(t))));
+#else
     a.x = lerp(a.x, b.x, t.x);
     a.y = lerp(a.y, b.y, t.y);
     a.z = lerp(a.z, b.z, t.z);
     a.w = lerp(a.w, b.w, t.w);
     return a;
+#endif // LA_AVX
 }
 
 LADEF V4d v4d_floor(V4d a)
 {
+#if LA_AVX
+    return la_store4d(_mm256_floor_pd(la_load4d(a)));
+#else
     a.x = floor(a.x);
     a.y = floor(a.y);
     a.z = floor(a.z);
     a.w = floor(a.w);
     return a;
+#endif // LA_AVX
 }
 
 LADEF V4d v4d_ceil(V4d a)
 {
+#if LA_AVX
+    return la_store4d(_mm256_ceil_pd(la_load4d(a)));
+#else
     a.x = ceil(a.x);
     a.y = ceil(a.y);
     a.z = ceil(a.z);
     a.w = ceil(a.w);
     return a;
+#endif // LA_AVX
 }
 
 LADEF V4d v4d_clamp(V4d x, V4d a, V4d b)
 {
+#if LA_AVX
+    return la_store4d(la_fmin_pd(la_fmax_pd(la_load4d(a), la_load4d(x)), la_load4d(b)));
+#else
     x.x = clampd(x.x, a.x, b.x);
     x.y = clampd(x.y, a.y, b.y);
     x.z = clampd(x.z, a.z, b.z);
     x.w = clampd(x.w, a.w, b.w);
     return x;
+#endif // LA_AVX
 }
 
 LADEF double v4d_sqrlen(V4d a)
@@ -2616,29 +3313,41 @@ LADEF V4i v4i4u(V4u a)
 
 LADEF V4i v4i_sum(V4i a, V4i b)
 {
+#if LA_SSE2
+    return la_store4i(_mm_add_epi32(la_load4i(a), la_load4i(b)));
+#else
     a.x += b.x;
     a.y += b.y;
     a.z += b.z;
     a.w += b.w;
     return a;
+#endif // LA_SSE2
 }
 
 LADEF V4i v4i_sub(V4i a, V4i b)
 {
+#if LA_SSE2
+    return la_store4i(_mm_sub_epi32(la_load4i(a), la_load4i(b)));
+#else
     a.x -= b.x;
     a.y -= b.y;
     a.z -= b.z;
     a.w -= b.w;
     return a;
+#endif // LA_SSE2
 }
 
 LADEF V4i v4i_mul(V4i a, V4i b)
 {
+#if LA_SSE41
+    return la_store4i(_mm_mullo_epi32(la_load4i(a), la_load4i(b)));
+#else
     a.x *= b.x;
     a.y *= b.y;
     a.z *= b.z;
     a.w *= b.w;
     return a;
+#endif // LA_SSE41
 }
 
 LADEF V4i v4i_div(V4i a, V4i b)
@@ -2652,29 +3361,41 @@ LADEF V4i v4i_div(V4i a, V4i b)
 
 LADEF V4i v4i_min(V4i a, V4i b)
 {
+#if LA_SSE41
+    return la_store4i(_mm_min_epi32(la_load4i(a), la_load4i(b)));
+#else
     a.x = mini(a.x, b.x);
     a.y = mini(a.y, b.y);
     a.z = mini(a.z, b.z);
     a.w = mini(a.w, b.w);
     return a;
+#endif // LA_SSE41
 }
 
 LADEF V4i v4i_max(V4i a, V4i b)
 {
+#if LA_SSE41
+    return la_store4i(_mm_max_epi32(la_load4i(a), la_load4i(b)));
+#else
     a.x = maxi(a.x, b.x);
     a.y = maxi(a.y, b.y);
     a.z = maxi(a.z, b.z);
     a.w = maxi(a.w, b.w);
     return a;
+#endif // LA_SSE41
 }
 
 LADEF V4i v4i_clamp(V4i x, V4i a, V4i b)
 {
+#if LA_SSE41
+    return la_store4i(_mm_min_epi32(_mm_max_epi32(la_load4i(a), la_load4i(x)), la_load4i(b)));
+#else
     x.x = clampi(x.x, a.x, b.x);
     x.y = clampi(x.y, a.y, b.y);
     x.z = clampi(x.z, a.z, b.z);
     x.w = clampi(x.w, a.w, b.w);
     return x;
+#endif // LA_SSE41
 }
 
 LADEF int v4i_sqrlen(V4i a)
@@ -2809,29 +3530,41 @@ LADEF V4u v4u4i(V4i a)
 
 LADEF V4u v4u_sum(V4u a, V4u b)
 {
+#if LA_SSE2
+    return la_store4u(_mm_add_epi32(la_load4u(a), la_load4u(b)));
+#else
     a.x += b.x;
     a.y += b.y;
     a.z += b.z;
     a.w += b.w;
     return a;
+#endif // LA_SSE2
 }
 
 LADEF V4u v4u_sub(V4u a, V4u b)
 {
+#if LA_SSE2
+    return la_store4u(_mm_sub_epi32(la_load4u(a), la_load4u(b)));
+#else
     a.x -= b.x;
     a.y -= b.y;
     a.z -= b.z;
     a.w -= b.w;
     return a;
+#endif // LA_SSE2
 }
 
 LADEF V4u v4u_mul(V4u a, V4u b)
 {
+#if LA_SSE41
+    return la_store4u(_mm_mullo_epi32(la_load4u(a), la_load4u(b)));
+#else
     a.x *= b.x;
     a.y *= b.y;
     a.z *= b.z;
     a.w *= b.w;
     return a;
+#endif // LA_SSE41
 }
 
 LADEF V4u v4u_div(V4u a, V4u b)
@@ -2845,29 +3578,41 @@ LADEF V4u v4u_div(V4u a, V4u b)
 
 LADEF V4u v4u_min(V4u a, V4u b)
 {
+#if LA_SSE41
+    return la_store4u(_mm_min_epu32(la_load4u(a), la_load4u(b)));
+#else
     a.x = minu(a.x, b.x);
     a.y = minu(a.y, b.y);
     a.z = minu(a.z, b.z);
     a.w = minu(a.w, b.w);
     return a;
+#endif // LA_SSE41
 }
 
 LADEF V4u v4u_max(V4u a, V4u b)
 {
+#if LA_SSE41
+    return la_store4u(_mm_max_epu32(la_load4u(a), la_load4u(b)));
+#else
     a.x = maxu(a.x, b.x);
     a.y = maxu(a.y, b.y);
     a.z = maxu(a.z, b.z);
     a.w = maxu(a.w, b.w);
     return a;
+#endif // LA_SSE41
 }
 
 LADEF V4u v4u_clamp(V4u x, V4u a, V4u b)
 {
+#if LA_SSE41
+    return la_store4u(_mm_min_epu32(_mm_max_epu32(la_load4u(a), la_load4u(x)), la_load4u(b)));
+#else
     x.x = clampu(x.x, a.x, b.x);
     x.y = clampu(x.y, a.y, b.y);
     x.z = clampu(x.z, a.z, b.z);
     x.w = clampu(x.w, a.w, b.w);
     return x;
+#endif // LA_SSE41
 }
 
 LADEF unsigned int v4u_sqrlen(V4u a)
@@ -2875,4 +3620,4249 @@ LADEF unsigned int v4u_sqrlen(V4u a)
     return a.x*a.x + a.y*a.y + a.z*a.z + a.w*a.w;
 }
 
+LADEF void floats_sum_n(float *out, const float *a, const float *b, size_t n)
+{
+    size_t i = 0;
+#if LA_SSE2
+    for (; i < (n & ~(size_t) 3); i += 4) {
+        _mm_storeu_ps(out + i, _mm_add_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+    }
+#endif // LA_SSE2
+    for (; i < n; ++i) {
+        out[i] = a[i] + b[i];
+    }
+}
+
+LADEF void floats_sub_n(float *out, const float *a, const float *b, size_t n)
+{
+    size_t i = 0;
+#if LA_SSE2
+    for (; i < (n & ~(size_t) 3); i += 4) {
+        _mm_storeu_ps(out + i, _mm_sub_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+    }
+#endif // LA_SSE2
+    for (; i < n; ++i) {
+        out[i] = a[i] - b[i];
+    }
+}
+
+LADEF void floats_mul_n(float *out, const float *a, const float *b, size_t n)
+{
+    size_t i = 0;
+#if LA_SSE2
+    for (; i < (n & ~(size_t) 3); i += 4) {
+        _mm_storeu_ps(out + i, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+    }
+#endif // LA_SSE2
+    for (; i < n; ++i) {
+        out[i] = a[i] * b[i];
+    }
+}
+
+LADEF void floats_div_n(float *out, const float *a, const float *b, size_t n)
+{
+    size_t i = 0;
+#if LA_SSE2
+    for (; i < (n & ~(size_t) 3); i += 4) {
+        _mm_storeu_ps(out + i, _mm_div_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+    }
+#endif // LA_SSE2
+    for (; i < n; ++i) {
+        out[i] = a[i] / b[i];
+    }
+}
+
+LADEF void floats_sqrt_n(float *out, const float *a, size_t n)
+{
+    size_t i = 0;
+#if LA_SSE2
+    for (; i < (n & ~(size_t) 3); i += 4) {
+        _mm_storeu_ps(out + i, _mm_sqrt_ps(_mm_loadu_ps(a + i)));
+    }
+#endif // LA_SSE2
+    for (; i < n; ++i) {
+        out[i] = sqrtf(a[i]);
+    }
+}
+
+LADEF void floats_min_n(float *out, const float *a, const float *b, size_t n)
+{
+    size_t i = 0;
+#if LA_SSE2
+    for (; i < (n & ~(size_t) 3); i += 4) {
+        _mm_storeu_ps(out + i, la_fmin_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+    }
+#endif // LA_SSE2
+    for (; i < n; ++i) {
+        out[i] = fminf(a[i], b[i]);
+    }
+}
+
+LADEF void floats_max_n(float *out, const float *a, const float *b, size_t n)
+{
+    size_t i = 0;
+#if LA_SSE2
+    for (; i < (n & ~(size_t) 3); i += 4) {
+        _mm_storeu_ps(out + i, la_fmax_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+    }
+#endif // LA_SSE2
+    for (; i < n; ++i) {
+        out[i] = fmaxf(a[i], b[i]);
+    }
+}
+
+LADEF void floats_lerp_n(float *out, const float *a, const float *b, const float *t, size_t n)
+{
+    size_t i = 0;
+#if LA_SSE2
+    for (; i < (n & ~(size_t) 3); i += 4) {
+        __m128 va = _mm_loadu_ps(a + i);
+        _mm_storeu_ps(out + i, _mm_add_ps(va, _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(b + i), va), _mm_loadu_ps(t + i))));
+    }
+#endif // LA_SSE2
+    for (; i < n; ++i) {
+        out[i] = lerpf(a[i], b[i], t[i]);
+    }
+}
+
+LADEF void floats_clamp_n(float *out, const float *x, const float *a, const float *b, size_t n)
+{
+    size_t i = 0;
+#if LA_SSE2
+    for (; i < (n & ~(size_t) 3); i += 4) {
+        _mm_storeu_ps(out + i, la_fmin_ps(la_fmax_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(x + i)), _mm_loadu_ps(b + i)));
+    }
+#endif // LA_SSE2
+    for (; i < n; ++i) {
+        out[i] = clampf(x[i], a[i], b[i]);
+    }
+}
+
+LADEF void doubles_sum_n(double *out, const double *a, const double *b, size_t n)
+{
+    size_t i = 0;
+#if LA_AVX
+    for (; i < (n & ~(size_t) 3); i += 4) {
+        _mm256_storeu_pd(out + i, _mm256_add_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i)));
+    }
+#endif // LA_AVX
+    for (; i < n; ++i) {
+        out[i] = a[i] + b[i];
+    }
+}
+
+LADEF void doubles_sub_n(double *out, const double *a, const double *b, size_t n)
+{
+    size_t i = 0;
+#if LA_AVX
+    for (; i < (n & ~(size_t) 3); i += 4) {
+        _mm256_storeu_pd(out + i, _mm256_sub_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i)));
+    }
+#endif // LA_AVX
+    for (; i < n; ++i) {
+        out[i] = a[i] - b[i];
+    }
+}
+
+LADEF void doubles_mul_n(double *out, const double *a, const double *b, size_t n)
+{
+    size_t i = 0;
+#if LA_AVX
+    for (; i < (n & ~(size_t) 3); i += 4) {
+        _mm256_storeu_pd(out + i, _mm256_mul_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i)));
+    }
+#endif // LA_AVX
+    for (; i < n; ++i) {
+        out[i] = a[i] * b[i];
+    }
+}
+
+LADEF void doubles_div_n(double *out, const double *a, const double *b, size_t n)
+{
+    size_t i = 0;
+#if LA_AVX
+    for (; i < (n & ~(size_t) 3); i += 4) {
+        _mm256_storeu_pd(out + i, _mm256_div_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i)));
+    }
+#endif // LA_AVX
+    for (; i < n; ++i) {
+        out[i] = a[i] / b[i];
+    }
+}
+
+LADEF void doubles_sqrt_n(double *out, const double *a, size_t n)
+{
+    size_t i = 0;
+#if LA_AVX
+    for (; i < (n & ~(size_t) 3); i += 4) {
+        _mm256_storeu_pd(out + i, _mm256_sqrt_pd(_mm256_loadu_pd(a + i)));
+    }
+#endif // LA_AVX
+    for (; i < n; ++i) {
+        out[i] = sqrt(a[i]);
+    }
+}
+
+LADEF void doubles_min_n(double *out, const double *a, const double *b, size_t n)
+{
+    size_t i = 0;
+#if LA_AVX
+    for (; i < (n & ~(size_t) 3); i += 4) {
+        _mm256_storeu_pd(out + i, la_fmin_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i)));
+    }
+#endif // LA_AVX
+    for (; i < n; ++i) {
+        out[i] = fmin(a[i], b[i]);
+    }
+}
+
+LADEF void doubles_max_n(double *out, const double *a, const double *b, size_t n)
+{
+    size_t i = 0;
+#if LA_AVX
+    for (; i < (n & ~(size_t) 3); i += 4) {
+        _mm256_storeu_pd(out + i, la_fmax_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i)));
+    }
+#endif // LA_AVX
+    for (; i < n; ++i) {
+        out[i] = fmax(a[i], b[i]);
+    }
+}
+
+LADEF void doubles_lerp_n(double *out, const double *a, const double *b, const double *t, size_t n)
+{
+    size_t i = 0;
+#if LA_AVX
+    for (; i < (n & ~(size_t) 3); i += 4) {
+        __m256d va = _mm256_loadu_pd(a + i);
+        _mm256_storeu_pd(out + i, _mm256_add_pd(va, _mm256_mul_pd(_mm256_sub_pd(_mm256_loadu_pd(b + i), va), _mm256_loadu_pd(t + i))));
+    }
+#endif // LA_AVX
+    for (; i < n; ++i) {
+        out[i] = lerp(a[i], b[i], t[i]);
+    }
+}
+
+LADEF void doubles_clamp_n(double *out, const double *x, const double *a, const double *b, size_t n)
+{
+    size_t i = 0;
+#if LA_AVX
+    for (; i < (n & ~(size_t) 3); i += 4) {
+        _mm256_storeu_pd(out + i, la_fmin_pd(la_fmax_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(x + i)), _mm256_loadu_pd(b + i)));
+    }
+#endif // LA_AVX
+    for (; i < n; ++i) {
+        out[i] = clampd(x[i], a[i], b[i]);
+    }
+}
+
+LADEF void ints_sum_n(int *out, const int *a, const int *b, size_t n)
+{
+    size_t i = 0;
+#if LA_SSE2
+    for (; i < (n & ~(size_t) 3); i += 4) {
+        _mm_storeu_si128((__m128i*) (out + i), _mm_add_epi32(_mm_loadu_si128((const __m128i*) (a + i)), _mm_loadu_si128((const __m128i*) (b + i))));
+    }
+#endif // LA_SSE2
+    for (; i < n; ++i) {
+        out[i] = a[i] + b[i];
+    }
+}
+
+LADEF void ints_sub_n(int *out, const int *a, const int *b, size_t n)
+{
+    size_t i = 0;
+#if LA_SSE2
+    for (; i < (n & ~(size_t) 3); i += 4) {
+        _mm_storeu_si128((__m128i*) (out + i), _mm_sub_epi32(_mm_loadu_si128((const __m128i*) (a + i)), _mm_loadu_si128((const __m128i*) (b + i))));
+    }
+#endif // LA_SSE2
+    for (; i < n; ++i) {
+        out[i] = a[i] - b[i];
+    }
+}
+
+LADEF void ints_mul_n(int *out, const int *a, const int *b, size_t n)
+{
+    size_t i = 0;
+#if LA_SSE41
+    for (; i < (n & ~(size_t) 3); i += 4) {
+        _mm_storeu_si128((__m128i*) (out + i), _mm_mullo_epi32(_mm_loadu_si128((const __m128i*) (a + i)), _mm_loadu_si128((const __m128i*) (b + i))));
+    }
+#endif // LA_SSE41
+    for (; i < n; ++i) {
+        out[i] = a[i] * b[i];
+    }
+}
+
+LADEF void ints_div_n(int *out, const int *a, const int *b, size_t n)
+{
+    size_t i = 0;
+    for (; i < n; ++i) {
+        out[i] = a[i] / b[i];
+    }
+}
+
+LADEF void ints_min_n(int *out, const int *a, const int *b, size_t n)
+{
+    size_t i = 0;
+#if LA_SSE41
+    for (; i < (n & ~(size_t) 3); i += 4) {
+        _mm_storeu_si128((__m128i*) (out + i), _mm_min_epi32(_mm_loadu_si128((const __m128i*) (a + i)), _mm_loadu_si128((const __m128i*) (b + i))));
+    }
+#endif // LA_SSE41
+    for (; i < n; ++i) {
+        out[i] = mini(a[i], b[i]);
+    }
+}
+
+LADEF void ints_max_n(int *out, const int *a, const int *b, size_t n)
+{
+    size_t i = 0;
+#if LA_SSE41
+    for (; i < (n & ~(size_t) 3); i += 4) {
+        _mm_storeu_si128((__m128i*) (out + i), _mm_max_epi32(_mm_loadu_si128((const __m128i*) (a + i)), _mm_loadu_si128((const __m128i*) (b + i))));
+    }
+#endif // LA_SSE41
+    for (; i < n; ++i) {
+        out[i] = maxi(a[i], b[i]);
+    }
+}
+
+LADEF void ints_clamp_n(int *out, const int *x, const int *a, const int *b, size_t n)
+{
+    size_t i = 0;
+#if LA_SSE41
+    for (; i < (n & ~(size_t) 3); i += 4) {
+        _mm_storeu_si128((__m128i*) (out + i), _mm_min_epi32(_mm_max_epi32(_mm_loadu_si128((const __m128i*) (a + i)), _mm_loadu_si128((const __m128i*) (x + i))), _mm_loadu_si128((const __m128i*) (b + i))));
+    }
+#endif // LA_SSE41
+    for (; i < n; ++i) {
+        out[i] = clampi(x[i], a[i], b[i]);
+    }
+}
+
+LADEF void uints_sum_n(unsigned int *out, const unsigned int *a, const unsigned int *b, size_t n)
+{
+    size_t i = 0;
+#if LA_SSE2
+    for (; i < (n & ~(size_t) 3); i += 4) {
+        _mm_storeu_si128((__m128i*) (out + i), _mm_add_epi32(_mm_loadu_si128((const __m128i*) (a + i)), _mm_loadu_si128((const __m128i*) (b + i))));
+    }
+#endif // LA_SSE2
+    for (; i < n; ++i) {
+        out[i] = a[i] + b[i];
+    }
+}
+
+LADEF void uints_sub_n(unsigned int *out, const unsigned int *a, const unsigned int *b, size_t n)
+{
+    size_t i = 0;
+#if LA_SSE2
+    for (; i < (n & ~(size_t) 3); i += 4) {
+        _mm_storeu_si128((__m128i*) (out + i), _mm_sub_epi32(_mm_loadu_si128((const __m128i*) (a + i)), _mm_loadu_si128((const __m128i*) (b + i))));
+    }
+#endif // LA_SSE2
+    for (; i < n; ++i) {
+        out[i] = a[i] - b[i];
+    }
+}
+
+LADEF void uints_mul_n(unsigned int *out, const unsigned int *a, const unsigned int *b, size_t n)
+{
+    size_t i = 0;
+#if LA_SSE41
+    for (; i < (n & ~(size_t) 3); i += 4) {
+        _mm_storeu_si128((__m128i*) (out + i), _mm_mullo_epi32(_mm_loadu_si128((const __m128i*) (a + i)), _mm_loadu_si128((const __m128i*) (b + i))));
+    }
+#endif // LA_SSE41
+    for (; i < n; ++i) {
+        out[i] = a[i] * b[i];
+    }
+}
+
+LADEF void uints_div_n(unsigned int *out, const unsigned int *a, const unsigned int *b, size_t n)
+{
+    size_t i = 0;
+    for (; i < n; ++i) {
+        out[i] = a[i] / b[i];
+    }
+}
+
+LADEF void uints_min_n(unsigned int *out, const unsigned int *a, const unsigned int *b, size_t n)
+{
+    size_t i = 0;
+#if LA_SSE41
+    for (; i < (n & ~(size_t) 3); i += 4) {
+        _mm_storeu_si128((__m128i*) (out + i), _mm_min_epu32(_mm_loadu_si128((const __m128i*) (a + i)), _mm_loadu_si128((const __m128i*) (b + i))));
+    }
+#endif // LA_SSE41
+    for (; i < n; ++i) {
+        out[i] = minu(a[i], b[i]);
+    }
+}
+
+LADEF void uints_max_n(unsigned int *out, const unsigned int *a, const unsigned int *b, size_t n)
+{
+    size_t i = 0;
+#if LA_SSE41
+    for (; i < (n & ~(size_t) 3); i += 4) {
+        _mm_storeu_si128((__m128i*) (out + i), _mm_max_epu32(_mm_loadu_si128((const __m128i*) (a + i)), _mm_loadu_si128((const __m128i*) (b + i))));
+    }
+#endif // LA_SSE41
+    for (; i < n; ++i) {
+        out[i] = maxu(a[i], b[i]);
+    }
+}
+
+LADEF void uints_clamp_n(unsigned int *out, const unsigned int *x, const unsigned int *a, const unsigned int *b, size_t n)
+{
+    size_t i = 0;
+#if LA_SSE41
+    for (; i < (n & ~(size_t) 3); i += 4) {
+        _mm_storeu_si128((__m128i*) (out + i), _mm_min_epu32(_mm_max_epu32(_mm_loadu_si128((const __m128i*) (a + i)), _mm_loadu_si128((const __m128i*) (x + i))), _mm_loadu_si128((const __m128i*) (b + i))));
+    }
+#endif // LA_SSE41
+    for (; i < n; ++i) {
+        out[i] = clampu(x[i], a[i], b[i]);
+    }
+}
+
+LADEF void v2f_len_soa(float *out, const float *x, const float *y, size_t n)
+{
+    size_t i = 0;
+#if LA_SSE2
+    for (; i < (n & ~(size_t) 3); i += 4) {
+        __m128 vx = _mm_loadu_ps(x + i);
+        __m128 s = _mm_mul_ps(vx, vx);
+        __m128 vy = _mm_loadu_ps(y + i);
+        s = _mm_add_ps(s, _mm_mul_ps(vy, vy));
+        _mm_storeu_ps(out + i, _mm_sqrt_ps(s));
+    }
+#endif // LA_SSE2
+    for (; i < n; ++i) {
+        out[i] = sqrtf(x[i]*x[i] + y[i]*y[i]);
+    }
+}
+
+LADEF void v3f_len_soa(float *out, const float *x, const float *y, const float *z, size_t n)
+{
+    size_t i = 0;
+#if LA_SSE2
+    for (; i < (n & ~(size_t) 3); i += 4) {
+        __m128 vx = _mm_loadu_ps(x + i);
+        __m128 s = _mm_mul_ps(vx, vx);
+        __m128 vy = _mm_loadu_ps(y + i);
+        s = _mm_add_ps(s, _mm_mul_ps(vy, vy));
+        __m128 vz = _mm_loadu_ps(z + i);
+        s = _mm_add_ps(s, _mm_mul_ps(vz, vz));
+        _mm_storeu_ps(out + i, _mm_sqrt_ps(s));
+    }
+#endif // LA_SSE2
+    for (; i < n; ++i) {
+        out[i] = sqrtf(x[i]*x[i] + y[i]*y[i] + z[i]*z[i]);
+    }
+}
+
+LADEF void v4f_len_soa(float *out, const float *x, const float *y, const float *z, const float *w, size_t n)
+{
+    size_t i = 0;
+#if LA_SSE2
+    for (; i < (n & ~(size_t) 3); i += 4) {
+        __m128 vx = _mm_loadu_ps(x + i);
+        __m128 s = _mm_mul_ps(vx, vx);
+        __m128 vy = _mm_loadu_ps(y + i);
+        s = _mm_add_ps(s, _mm_mul_ps(vy, vy));
+        __m128 vz = _mm_loadu_ps(z + i);
+        s = _mm_add_ps(s, _mm_mul_ps(vz, vz));
+        __m128 vw = _mm_loadu_ps(w + i);
+        s = _mm_add_ps(s, _mm_mul_ps(vw, vw));
+        _mm_storeu_ps(out + i, _mm_sqrt_ps(s));
+    }
+#endif // LA_SSE2
+    for (; i < n; ++i) {
+        out[i] = sqrtf(x[i]*x[i] + y[i]*y[i] + z[i]*z[i] + w[i]*w[i]);
+    }
+}
+
+LADEF void v2d_len_soa(double *out, const double *x, const double *y, size_t n)
+{
+    size_t i = 0;
+#if LA_AVX
+    for (; i < (n & ~(size_t) 3); i += 4) {
+        __m256d vx = _mm256_loadu_pd(x + i);
+        __m256d s = _mm256_mul_pd(vx, vx);
+        __m256d vy = _mm256_loadu_pd(y + i);
+        s = _mm256_add_pd(s, _mm256_mul_pd(vy, vy));
+        _mm256_storeu_pd(out + i, _mm256_sqrt_pd(s));
+    }
+#endif // LA_AVX
+    for (; i < n; ++i) {
+        out[i] = sqrt(x[i]*x[i] + y[i]*y[i]);
+    }
+}
+
+LADEF void v3d_len_soa(double *out, const double *x, const double *y, const double *z, size_t n)
+{
+    size_t i = 0;
+#if LA_AVX
+    for (; i < (n & ~(size_t) 3); i += 4) {
+        __m256d vx = _mm256_loadu_pd(x + i);
+        __m256d s = _mm256_mul_pd(vx, vx);
+        __m256d vy = _mm256_loadu_pd(y + i);
+        s = _mm256_add_pd(s, _mm256_mul_pd(vy, vy));
+        __m256d vz = _mm256_loadu_pd(z + i);
+        s = _mm256_add_pd(s, _mm256_mul_pd(vz, vz));
+        _mm256_storeu_pd(out + i, _mm256_sqrt_pd(s));
+    }
+#endif // LA_AVX
+    for (; i < n; ++i) {
+        out[i] = sqrt(x[i]*x[i] + y[i]*y[i] + z[i]*z[i]);
+    }
+}
+
+LADEF void v4d_len_soa(double *out, const double *x, const double *y, const double *z, const double *w, size_t n)
+{
+    size_t i = 0;
+#if LA_AVX
+    for (; i < (n & ~(size_t) 3); i += 4) {
+        __m256d vx = _mm256_loadu_pd(x + i);
+        __m256d s = _mm256_mul_pd(vx, vx);
+        __m256d vy = _mm256_loadu_pd(y + i);
+        s = _mm256_add_pd(s, _mm256_mul_pd(vy, vy));
+        __m256d vz = _mm256_loadu_pd(z + i);
+        s = _mm256_add_pd(s, _mm256_mul_pd(vz, vz));
+        __m256d vw = _mm256_loadu_pd(w + i);
+        s = _mm256_add_pd(s, _mm256_mul_pd(vw, vw));
+        _mm256_storeu_pd(out + i, _mm256_sqrt_pd(s));
+    }
+#endif // LA_AVX
+    for (; i < n; ++i) {
+        out[i] = sqrt(x[i]*x[i] + y[i]*y[i] + z[i]*z[i] + w[i]*w[i]);
+    }
+}
+
+LADEF void v2f_sum_n(V2f *out, const V2f *a, const V2f *b, size_t n)
+{
+    floats_sum_n((float*) out, (const float*) a, (const float*) b, n * 2);
+}
+
+LADEF void v2f_sub_n(V2f *out, const V2f *a, const V2f *b, size_t n)
+{
+    floats_sub_n((float*) out, (const float*) a, (const float*) b, n * 2);
+}
+
+LADEF void v2f_mul_n(V2f *out, const V2f *a, const V2f *b, size_t n)
+{
+    floats_mul_n((float*) out, (const float*) a, (const float*) b, n * 2);
+}
+
+LADEF void v2f_div_n(V2f *out, const V2f *a, const V2f *b, size_t n)
+{
+    floats_div_n((float*) out, (const float*) a, (const float*) b, n * 2);
+}
+
+LADEF void v2f_sqrt_n(V2f *out, const V2f *a, size_t n)
+{
+    floats_sqrt_n((float*) out, (const float*) a, n * 2);
+}
+
+LADEF void v2f_min_n(V2f *out, const V2f *a, const V2f *b, size_t n)
+{
+    floats_min_n((float*) out, (const float*) a, (const float*) b, n * 2);
+}
+
+LADEF void v2f_max_n(V2f *out, const V2f *a, const V2f *b, size_t n)
+{
+    floats_max_n((float*) out, (const float*) a, (const float*) b, n * 2);
+}
+
+LADEF void v2f_lerp_n(V2f *out, const V2f *a, const V2f *b, const V2f *t, size_t n)
+{
+    floats_lerp_n((float*) out, (const float*) a, (const float*) b, (const float*) t, n * 2);
+}
+
+LADEF void v2f_clamp_n(V2f *out, const V2f *x, const V2f *a, const V2f *b, size_t n)
+{
+    floats_clamp_n((float*) out, (const float*) x, (const float*) a, (const float*) b, n * 2);
+}
+
+LADEF void v2f_len_n(float *out, const V2f *a, size_t n)
+{
+    size_t i = 0;
+#if LA_SSE2
+    for (; i < (n & ~(size_t) 3); i += 4) {
+        // Deinterleave 4 vectors into the x and y of each
+        __m128 a0 = _mm_loadu_ps(&a[i].x);
+        __m128 a1 = _mm_loadu_ps(&a[i + 2].x);
+        __m128 vx = _mm_shuffle_ps(a0, a1, _MM_SHUFFLE(2, 0, 2, 0));
+        __m128 vy = _mm_shuffle_ps(a0, a1, _MM_SHUFFLE(3, 1, 3, 1));
+        __m128 s = _mm_mul_ps(vx, vx);
+        s = _mm_add_ps(s, _mm_mul_ps(vy, vy));
+        _mm_storeu_ps(out + i, _mm_sqrt_ps(s));
+    }
+#endif // LA_SSE2
+    for (; i < n; ++i) {
+        out[i] = v2f_len(a[i]);
+    }
+}
+
+LADEF void v3f_sum_n(V3f *out, const V3f *a, const V3f *b, size_t n)
+{
+    floats_sum_n((float*) out, (const float*) a, (const float*) b, n * 3);
+}
+
+LADEF void v3f_sub_n(V3f *out, const V3f *a, const V3f *b, size_t n)
+{
+    floats_sub_n((float*) out, (const float*) a, (const float*) b, n * 3);
+}
+
+LADEF void v3f_mul_n(V3f *out, const V3f *a, const V3f *b, size_t n)
+{
+    floats_mul_n((float*) out, (const float*) a, (const float*) b, n * 3);
+}
+
+LADEF void v3f_div_n(V3f *out, const V3f *a, const V3f *b, size_t n)
+{
+    floats_div_n((float*) out, (const float*) a, (const float*) b, n * 3);
+}
+
+LADEF void v3f_sqrt_n(V3f *out, const V3f *a, size_t n)
+{
+    floats_sqrt_n((float*) out, (const float*) a, n * 3);
+}
+
+LADEF void v3f_min_n(V3f *out, const V3f *a, const V3f *b, size_t n)
+{
+    floats_min_n((float*) out, (const float*) a, (const float*) b, n * 3);
+}
+
+LADEF void v3f_max_n(V3f *out, const V3f *a, const V3f *b, size_t n)
+{
+    floats_max_n((float*) out, (const float*) a, (const float*) b, n * 3);
+}
+
+LADEF void v3f_lerp_n(V3f *out, const V3f *a, const V3f *b, const V3f *t, size_t n)
+{
+    floats_lerp_n((float*) out, (const float*) a, (const float*) b, (const float*) t, n * 3);
+}
+
+LADEF void v3f_clamp_n(V3f *out, const V3f *x, const V3f *a, const V3f *b, size_t n)
+{
+    floats_clamp_n((float*) out, (const float*) x, (const float*) a, (const float*) b, n * 3);
+}
+
+LADEF void v3f_len_n(float *out, const V3f *a, size_t n)
+{
+    size_t i = 0;
+#if LA_SSE2
+    for (; i < (n & ~(size_t) 3); i += 4) {
+        // 4 vectors are 3 registers: x0 y0 z0 x1 | y1 z1 x2 y2 | z2 x3 y3 z3
+        const float *p = &a[i].x;
+        __m128 a0 = _mm_loadu_ps(p);
+        __m128 a1 = _mm_loadu_ps(p + 4);
+        __m128 a2 = _mm_loadu_ps(p + 8);
+        __m128 x2y2x3y3 = _mm_shuffle_ps(a1, a2, _MM_SHUFFLE(2, 1, 3, 2));
+        __m128 y0z0y1z1 = _mm_shuffle_ps(a0, a1, _MM_SHUFFLE(1, 0, 2, 1));
+        __m128 vx = _mm_shuffle_ps(a0, x2y2x3y3, _MM_SHUFFLE(2, 0, 3, 0));
+        __m128 vy = _mm_shuffle_ps(y0z0y1z1, x2y2x3y3, _MM_SHUFFLE(3, 1, 2, 0));
+        __m128 vz = _mm_shuffle_ps(y0z0y1z1, a2, _MM_SHUFFLE(3, 0, 3, 1));
+        __m128 s = _mm_mul_ps(vx, vx);
+        s = _mm_add_ps(s, _mm_mul_ps(vy, vy));
+        s = _mm_add_ps(s, _mm_mul_ps(vz, vz));
+        _mm_storeu_ps(out + i, _mm_sqrt_ps(s));
+    }
+#endif // LA_SSE2
+    for (; i < n; ++i) {
+        out[i] = v3f_len(a[i]);
+    }
+}
+
+LADEF void v4f_sum_n(V4f *out, const V4f *a, const V4f *b, size_t n)
+{
+    floats_sum_n((float*) out, (const float*) a, (const float*) b, n * 4);
+}
+
+LADEF void v4f_sub_n(V4f *out, const V4f *a, const V4f *b, size_t n)
+{
+    floats_sub_n((float*) out, (const float*) a, (const float*) b, n * 4);
+}
+
+LADEF void v4f_mul_n(V4f *out, const V4f *a, const V4f *b, size_t n)
+{
+    floats_mul_n((float*) out, (const float*) a, (const float*) b, n * 4);
+}
+
+LADEF void v4f_div_n(V4f *out, const V4f *a, const V4f *b, size_t n)
+{
+    floats_div_n((float*) out, (const float*) a, (const float*) b, n * 4);
+}
+
+LADEF void v4f_sqrt_n(V4f *out, const V4f *a, size_t n)
+{
+    floats_sqrt_n((float*) out, (const float*) a, n * 4);
+}
+
+LADEF void v4f_min_n(V4f *out, const V4f *a, const V4f *b, size_t n)
+{
+    floats_min_n((float*) out, (const float*) a, (const float*) b, n * 4);
+}
+
+LADEF void v4f_max_n(V4f *out, const V4f *a, const V4f *b, size_t n)
+{
+    floats_max_n((float*) out, (const float*) a, (const float*) b, n * 4);
+}
+
+LADEF void v4f_lerp_n(V4f *out, const V4f *a, const V4f *b, const V4f *t, size_t n)
+{
+    floats_lerp_n((float*) out, (const float*) a, (const float*) b, (const float*) t, n * 4);
+}
+
+LADEF void v4f_clamp_n(V4f *out, const V4f *x, const V4f *a, const V4f *b, size_t n)
+{
+    floats_clamp_n((float*) out, (const float*) x, (const float*) a, (const float*) b, n * 4);
+}
+
+LADEF void v4f_len_n(float *out, const V4f *a, size_t n)
+{
+    size_t i = 0;
+#if LA_SSE2
+    for (; i < (n & ~(size_t) 3); i += 4) {
+        __m128 vx = _mm_loadu_ps(&a[i].x);
+        __m128 vy = _mm_loadu_ps(&a[i + 1].x);
+        __m128 vz = _mm_loadu_ps(&a[i + 2].x);
+        __m128 vw = _mm_loadu_ps(&a[i + 3].x);
+        _MM_TRANSPOSE4_PS(vx, vy, vz, vw);
+        __m128 s = _mm_mul_ps(vx, vx);
+        s = _mm_add_ps(s, _mm_mul_ps(vy, vy));
+        s = _mm_add_ps(s, _mm_mul_ps(vz, vz));
+        s = _mm_add_ps(s, _mm_mul_ps(vw, vw));
+        _mm_storeu_ps(out + i, _mm_sqrt_ps(s));
+    }
+#endif // LA_SSE2
+    for (; i < n; ++i) {
+        out[i] = v4f_len(a[i]);
+    }
+}
+
+LADEF void v2d_sum_n(V2d *out, const V2d *a, const V2d *b, size_t n)
+{
+    doubles_sum_n((double*) out, (const double*) a, (const double*) b, n * 2);
+}
+
+LADEF void v2d_sub_n(V2d *out, const V2d *a, const V2d *b, size_t n)
+{
+    doubles_sub_n((double*) out, (const double*) a, (const double*) b, n * 2);
+}
+
+LADEF void v2d_mul_n(V2d *out, const V2d *a, const V2d *b, size_t n)
+{
+    doubles_mul_n((double*) out, (const double*) a, (const double*) b, n * 2);
+}
+
+LADEF void v2d_div_n(V2d *out, const V2d *a, const V2d *b, size_t n)
+{
+    doubles_div_n((double*) out, (const double*) a, (const double*) b, n * 2);
+}
+
+LADEF void v2d_sqrt_n(V2d *out, const V2d *a, size_t n)
+{
+    doubles_sqrt_n((double*) out, (const double*) a, n * 2);
+}
+
+LADEF void v2d_min_n(V2d *out, const V2d *a, const V2d *b, size_t n)
+{
+    doubles_min_n((double*) out, (const double*) a, (const double*) b, n * 2);
+}
+
+LADEF void v2d_max_n(V2d *out, const V2d *a, const V2d *b, size_t n)
+{
+    doubles_max_n((double*) out, (const double*) a, (const double*) b, n * 2);
+}
+
+LADEF void v2d_lerp_n(V2d *out, const V2d *a, const V2d *b, const V2d *t, size_t n)
+{
+    doubles_lerp_n((double*) out, (const double*) a, (const double*) b, (const double*) t, n * 2);
+}
+
+LADEF void v2d_clamp_n(V2d *out, const V2d *x, const V2d *a, const V2d *b, size_t n)
+{
+    doubles_clamp_n((double*) out, (const double*) x, (const double*) a, (const double*) b, n * 2);
+}
+
+LADEF void v2d_len_n(double *out, const V2d *a, size_t n)
+{
+    size_t i = 0;
+#if LA_AVX
+    for (; i < (n & ~(size_t) 3); i += 4) {
+        // x0 y0 x1 y1 | x2 y2 x3 y3 -> x0 y0 x2 y2 | x1 y1 x3 y3, then unpack within the lanes
+        __m256d a0 = _mm256_loadu_pd(&a[i].x);
+        __m256d a1 = _mm256_loadu_pd(&a[i + 2].x);
+        __m256d even = _mm256_permute2f128_pd(a0, a1, 0x20);
+        __m256d odd = _mm256_permute2f128_pd(a0, a1, 0x31);
+        __m256d vx = _mm256_unpacklo_pd(even, odd);
+        __m256d vy = _mm256_unpackhi_pd(even, odd);
+        __m256d s = _mm256_mul_pd(vx, vx);
+        s = _mm256_add_pd(s, _mm256_mul_pd(vy, vy));
+        _mm256_storeu_pd(out + i, _mm256_sqrt_pd(s));
+    }
+#endif // LA_AVX
+    for (; i < n; ++i) {
+        out[i] = v2d_len(a[i]);
+    }
+}
+
+LADEF void v3d_sum_n(V3d *out, const V3d *a, const V3d *b, size_t n)
+{
+    doubles_sum_n((double*) out, (const double*) a, (const double*) b, n * 3);
+}
+
+LADEF void v3d_sub_n(V3d *out, const V3d *a, const V3d *b, size_t n)
+{
+    doubles_sub_n((double*) out, (const double*) a, (const double*) b, n * 3);
+}
+
+LADEF void v3d_mul_n(V3d *out, const V3d *a, const V3d *b, size_t n)
+{
+    doubles_mul_n((double*) out, (const double*) a, (const double*) b, n * 3);
+}
+
+LADEF void v3d_div_n(V3d *out, const V3d *a, const V3d *b, size_t n)
+{
+    doubles_div_n((double*) out, (const double*) a, (const double*) b, n * 3);
+}
+
+LADEF void v3d_sqrt_n(V3d *out, const V3d *a, size_t n)
+{
+    doubles_sqrt_n((double*) out, (const double*) a, n * 3);
+}
+
+LADEF void v3d_min_n(V3d *out, const V3d *a, const V3d *b, size_t n)
+{
+    doubles_min_n((double*) out, (const double*) a, (const double*) b, n * 3);
+}
+
+LADEF void v3d_max_n(V3d *out, const V3d *a, const V3d *b, size_t n)
+{
+    doubles_max_n((double*) out, (const double*) a, (const double*) b, n * 3);
+}
+
+LADEF void v3d_lerp_n(V3d *out, const V3d *a, const V3d *b, const V3d *t, size_t n)
+{
+    doubles_lerp_n((double*) out, (const double*) a, (const double*) b, (const double*) t, n * 3);
+}
+
+LADEF void v3d_clamp_n(V3d *out, const V3d *x, const V3d *a, const V3d *b, size_t n)
+{
+    doubles_clamp_n((double*) out, (const double*) x, (const double*) a, (const double*) b, n * 3);
+}
+
+LADEF void v3d_len_n(double *out, const V3d *a, size_t n)
+{
+    size_t i = 0;
+#if LA_AVX
+    for (; i < (n & ~(size_t) 3); i += 4) {
+        // The vectors 0 and 2 in the low and the high lanes of `r0` and `r1`,
+        // 1 and 3 in the ones of `r1` and `r2`: x0 y0 | x2 y2, z0 x1 | z2 x3, y1 z1 | y3 z3
+        const double *p = &a[i].x;
+        __m256d r0 = _mm256_insertf128_pd(_mm256_castpd128_pd256(_mm_loadu_pd(p)), _mm_loadu_pd(p + 6), 1);
+        __m256d r1 = _mm256_insertf128_pd(_mm256_castpd128_pd256(_mm_loadu_pd(p + 2)), _mm_loadu_pd(p + 8), 1);
+        __m256d r2 = _mm256_insertf128_pd(_mm256_castpd128_pd256(_mm_loadu_pd(p + 4)), _mm_loadu_pd(p + 10), 1);
+        __m256d vx = _mm256_shuffle_pd(r0, r1, 0xA);
+        __m256d vy = _mm256_shuffle_pd(r0, r2, 0x5);
+        __m256d vz = _mm256_shuffle_pd(r1, r2, 0xA);
+        __m256d s = _mm256_mul_pd(vx, vx);
+        s = _mm256_add_pd(s, _mm256_mul_pd(vy, vy));
+        s = _mm256_add_pd(s, _mm256_mul_pd(vz, vz));
+        _mm256_storeu_pd(out + i, _mm256_sqrt_pd(s));
+    }
+#endif // LA_AVX
+    for (; i < n; ++i) {
+        out[i] = v3d_len(a[i]);
+    }
+}
+
+LADEF void v4d_sum_n(V4d *out, const V4d *a, const V4d *b, size_t n)
+{
+    doubles_sum_n((double*) out, (const double*) a, (const double*) b, n * 4);
+}
+
+LADEF void v4d_sub_n(V4d *out, const V4d *a, const V4d *b, size_t n)
+{
+    doubles_sub_n((double*) out, (const double*) a, (const double*) b, n * 4);
+}
+
+LADEF void v4d_mul_n(V4d *out, const V4d *a, const V4d *b, size_t n)
+{
+    doubles_mul_n((double*) out, (const double*) a, (const double*) b, n * 4);
+}
+
+LADEF void v4d_div_n(V4d *out, const V4d *a, const V4d *b, size_t n)
+{
+    doubles_div_n((double*) out, (const double*) a, (const double*) b, n * 4);
+}
+
+LADEF void v4d_sqrt_n(V4d *out, const V4d *a, size_t n)
+{
+    doubles_sqrt_n((double*) out, (const double*) a, n * 4);
+}
+
+LADEF void v4d_min_n(V4d *out, const V4d *a, const V4d *b, size_t n)
+{
+    doubles_min_n((double*) out, (const double*) a, (const double*) b, n * 4);
+}
+
+LADEF void v4d_max_n(V4d *out, const V4d *a, const V4d *b, size_t n)
+{
+    doubles_max_n((double*) out, (const double*) a, (const double*) b, n * 4);
+}
+
+LADEF void v4d_lerp_n(V4d *out, const V4d *a, const V4d *b, const V4d *t, size_t n)
+{
+    doubles_lerp_n((double*) out, (const double*) a, (const double*) b, (const double*) t, n * 4);
+}
+
+LADEF void v4d_clamp_n(V4d *out, const V4d *x, const V4d *a, const V4d *b, size_t n)
+{
+    doubles_clamp_n((double*) out, (const double*) x, (const double*) a, (const double*) b, n * 4);
+}
+
+LADEF void v4d_len_n(double *out, const V4d *a, size_t n)
+{
+    size_t i = 0;
+#if LA_AVX
+    for (; i < (n & ~(size_t) 3); i += 4) {
+        __m256d r0 = _mm256_loadu_pd(&a[i].x);
+        __m256d r1 = _mm256_loadu_pd(&a[i + 1].x);
+        __m256d r2 = _mm256_loadu_pd(&a[i + 2].x);
+        __m256d r3 = _mm256_loadu_pd(&a[i + 3].x);
+        // x0 x1 z0 z1, y0 y1 w0 w1, x2 x3 z2 z3, y2 y3 w2 w3
+        __m256d t0 = _mm256_unpacklo_pd(r0, r1);
+        __m256d t1 = _mm256_unpackhi_pd(r0, r1);
+        __m256d t2 = _mm256_unpacklo_pd(r2, r3);
+        __m256d t3 = _mm256_unpackhi_pd(r2, r3);
+        __m256d vx = _mm256_permute2f128_pd(t0, t2, 0x20);
+        __m256d vy = _mm256_permute2f128_pd(t1, t3, 0x20);
+        __m256d vz = _mm256_permute2f128_pd(t0, t2, 0x31);
+        __m256d vw = _mm256_permute2f128_pd(t1, t3, 0x31);
+        __m256d s = _mm256_mul_pd(vx, vx);
+        s = _mm256_add_pd(s, _mm256_mul_pd(vy, vy));
+        s = _mm256_add_pd(s, _mm256_mul_pd(vz, vz));
+        s = _mm256_add_pd(s, _mm256_mul_pd(vw, vw));
+        _mm256_storeu_pd(out + i, _mm256_sqrt_pd(s));
+    }
+#endif // LA_AVX
+    for (; i < n; ++i) {
+        out[i] = v4d_len(a[i]);
+    }
+}
+
+LADEF void v2i_sum_n(V2i *out, const V2i *a, const V2i *b, size_t n)
+{
+    ints_sum_n((int*) out, (const int*) a, (const int*) b, n * 2);
+}
+
+LADEF void v2i_sub_n(V2i *out, const V2i *a, const V2i *b, size_t n)
+{
+    ints_sub_n((int*) out, (const int*) a, (const int*) b, n * 2);
+}
+
+LADEF void v2i_mul_n(V2i *out, const V2i *a, const V2i *b, size_t n)
+{
+    ints_mul_n((int*) out, (const int*) a, (const int*) b, n * 2);
+}
+
+LADEF void v2i_div_n(V2i *out, const V2i *a, const V2i *b, size_t n)
+{
+    ints_div_n((int*) out, (const int*) a, (const int*) b, n * 2);
+}
+
+LADEF void v2i_min_n(V2i *out, const V2i *a, const V2i *b, size_t n)
+{
+    ints_min_n((int*) out, (const int*) a, (const int*) b, n * 2);
+}
+
+LADEF void v2i_max_n(V2i *out, const V2i *a, const V2i *b, size_t n)
+{
+    ints_max_n((int*) out, (const int*) a, (const int*) b, n * 2);
+}
+
+LADEF void v2i_clamp_n(V2i *out, const V2i *x, const V2i *a, const V2i *b, size_t n)
+{
+    ints_clamp_n((int*) out, (const int*) x, (const int*) a, (const int*) b, n * 2);
+}
+
+LADEF void v3i_sum_n(V3i *out, const V3i *a, const V3i *b, size_t n)
+{
+    ints_sum_n((int*) out, (const int*) a, (const int*) b, n * 3);
+}
+
+LADEF void v3i_sub_n(V3i *out, const V3i *a, const V3i *b, size_t n)
+{
+    ints_sub_n((int*) out, (const int*) a, (const int*) b, n * 3);
+}
+
+LADEF void v3i_mul_n(V3i *out, const V3i *a, const V3i *b, size_t n)
+{
+    ints_mul_n((int*) out, (const int*) a, (const int*) b, n * 3);
+}
+
+LADEF void v3i_div_n(V3i *out, const V3i *a, const V3i *b, size_t n)
+{
+    ints_div_n((int*) out, (const int*) a, (const int*) b, n * 3);
+}
+
+LADEF void v3i_min_n(V3i *out, const V3i *a, const V3i *b, size_t n)
+{
+    ints_min_n((int*) out, (const int*) a, (const int*) b, n * 3);
+}
+
+LADEF void v3i_max_n(V3i *out, const V3i *a, const V3i *b, size_t n)
+{
+    ints_max_n((int*) out, (const int*) a, (const int*) b, n * 3);
+}
+
+LADEF void v3i_clamp_n(V3i *out, const V3i *x, const V3i *a, const V3i *b, size_t n)
+{
+    ints_clamp_n((int*) out, (const int*) x, (const int*) a, (const int*) b, n * 3);
+}
+
+LADEF void v4i_sum_n(V4i *out, const V4i *a, const V4i *b, size_t n)
+{
+    ints_sum_n((int*) out, (const int*) a, (const int*) b, n * 4);
+}
+
+LADEF void v4i_sub_n(V4i *out, const V4i *a, const V4i *b, size_t n)
+{
+    ints_sub_n((int*) out, (const int*) a, (const int*) b, n * 4);
+}
+
+LADEF void v4i_mul_n(V4i *out, const V4i *a, const V4i *b, size_t n)
+{
+    ints_mul_n((int*) out, (const int*) a, (const int*) b, n * 4);
+}
+
+LADEF void v4i_div_n(V4i *out, const V4i *a, const V4i *b, size_t n)
+{
+    ints_div_n((int*) out, (const int*) a, (const int*) b, n * 4);
+}
+
+LADEF void v4i_min_n(V4i *out, const V4i *a, const V4i *b, size_t n)
+{
+    ints_min_n((int*) out, (const int*) a, (const int*) b, n * 4);
+}
+
+LADEF void v4i_max_n(V4i *out, const V4i *a, const V4i *b, size_t n)
+{
+    ints_max_n((int*) out, (const int*) a, (const int*) b, n * 4);
+}
+
+LADEF void v4i_clamp_n(V4i *out, const V4i *x, const V4i *a, const V4i *b, size_t n)
+{
+    ints_clamp_n((int*) out, (const int*) x, (const int*) a, (const int*) b, n * 4);
+}
+
+LADEF void v2u_sum_n(V2u *out, const V2u *a, const V2u *b, size_t n)
+{
+    uints_sum_n((unsigned int*) out, (const unsigned int*) a, (const unsigned int*) b, n * 2);
+}
+
+LADEF void v2u_sub_n(V2u *out, const V2u *a, const V2u *b, size_t n)
+{
+    uints_sub_n((unsigned int*) out, (const unsigned int*) a, (const unsigned int*) b, n * 2);
+}
+
+LADEF void v2u_mul_n(V2u *out, const V2u *a, const V2u *b, size_t n)
+{
+    uints_mul_n((unsigned int*) out, (const unsigned int*) a, (const unsigned int*) b, n * 2);
+}
+
+LADEF void v2u_div_n(V2u *out, const V2u *a, const V2u *b, size_t n)
+{
+    uints_div_n((unsigned int*) out, (const unsigned int*) a, (const unsigned int*) b, n * 2);
+}
+
+LADEF void v2u_min_n(V2u *out, const V2u *a, const V2u *b, size_t n)
+{
+    uints_min_n((unsigned int*) out, (const unsigned int*) a, (const unsigned int*) b, n * 2);
+}
+
+LADEF void v2u_max_n(V2u *out, const V2u *a, const V2u *b, size_t n)
+{
+    uints_max_n((unsigned int*) out, (const unsigned int*) a, (const unsigned int*) b, n * 2);
+}
+
+LADEF void v2u_clamp_n(V2u *out, const V2u *x, const V2u *a, const V2u *b, size_t n)
+{
+    uints_clamp_n((unsigned int*) out, (const unsigned int*) x, (const unsigned int*) a, (const unsigned int*) b, n * 2);
+}
+
+LADEF void v3u_sum_n(V3u *out, const V3u *a, const V3u *b, size_t n)
+{
+    uints_sum_n((unsigned int*) out, (const unsigned int*) a, (const unsigned int*) b, n * 3);
+}
+
+LADEF void v3u_sub_n(V3u *out, const V3u *a, const V3u *b, size_t n)
+{
+    uints_sub_n((unsigned int*) out, (const unsigned int*) a, (const unsigned int*) b, n * 3);
+}
+
+LADEF void v3u_mul_n(V3u *out, const V3u *a, const V3u *b, size_t n)
+{
+    uints_mul_n((unsigned int*) out, (const unsigned int*) a, (const unsigned int*) b, n * 3);
+}
+
+LADEF void v3u_div_n(V3u *out, const V3u *a, const V3u *b, size_t n)
+{
+    uints_div_n((unsigned int*) out, (const unsigned int*) a, (const unsigned int*) b, n * 3);
+}
+
+LADEF void v3u_min_n(V3u *out, const V3u *a, const V3u *b, size_t n)
+{
+    uints_min_n((unsigned int*) out, (const unsigned int*) a, (const unsigned int*) b, n * 3);
+}
+
+LADEF void v3u_max_n(V3u *out, const V3u *a, const V3u *b, size_t n)
+{
+    uints_max_n((unsigned int*) out, (const unsigned int*) a, (const unsigned int*) b, n * 3);
+}
+
+LADEF void v3u_clamp_n(V3u *out, const V3u *x, const V3u *a, const V3u *b, size_t n)
+{
+    uints_clamp_n((unsigned int*) out, (const unsigned int*) x, (const unsigned int*) a, (const unsigned int*) b, n * 3);
+}
+
+LADEF void v4u_sum_n(V4u *out, const V4u *a, const V4u *b, size_t n)
+{
+    uints_sum_n((unsigned int*) out, (const unsigned int*) a, (const unsigned int*) b, n * 4);
+}
+
+LADEF void v4u_sub_n(V4u *out, const V4u *a, const V4u *b, size_t n)
+{
+    uints_sub_n((unsigned int*) out, (const unsigned int*) a, (const unsigned int*) b, n * 4);
+}
+
+LADEF void v4u_mul_n(V4u *out, const V4u *a, const V4u *b, size_t n)
+{
+    uints_mul_n((unsigned int*) out, (const unsigned int*) a, (const unsigned int*) b, n * 4);
+}
+
+LADEF void v4u_div_n(V4u *out, const V4u *a, const V4u *b, size_t n)
+{
+    uints_div_n((unsigned int*) out, (const unsigned int*) a, (const unsigned int*) b, n * 4);
+}
+
+LADEF void v4u_min_n(V4u *out, const V4u *a, const V4u *b, size_t n)
+{
+    uints_min_n((unsigned int*) out, (const unsigned int*) a, (const unsigned int*) b, n * 4);
+}
+
+LADEF void v4u_max_n(V4u *out, const V4u *a, const V4u *b, size_t n)
+{
+    uints_max_n((unsigned int*) out, (const unsigned int*) a, (const unsigned int*) b, n * 4);
+}
+
+LADEF void v4u_clamp_n(V4u *out, const V4u *x, const V4u *a, const V4u *b, size_t n)
+{
+    uints_clamp_n((unsigned int*) out, (const unsigned int*) x, (const unsigned int*) a, (const unsigned int*) b, n * 4);
+}
+
+LADEF M2f m2f_id(void)
+{
+    M2f r = {0};
+    r.m[0][0] = 1.0f;
+    r.m[1][1] = 1.0f;
+    return r;
+}
+
+LADEF M2f m2f_mul(M2f a, M2f b)
+{
+    M2f r;
+    for (int c = 0; c < 2; ++c) {
+        for (int i = 0; i < 2; ++i) {
+            r.m[c][i] = a.m[0][i]*b.m[c][0] + a.m[1][i]*b.m[c][1];
+        }
+    }
+    return r;
+}
+
+LADEF V2f m2f_mul_v2f(M2f a, V2f v)
+{
+    V2f r;
+    r.x = a.m[0][0]*v.x + a.m[1][0]*v.y;
+    r.y = a.m[0][1]*v.x + a.m[1][1]*v.y;
+    return r;
+}
+
+LADEF M2f m2f_transpose(M2f a)
+{
+    M2f r;
+    r.m[0][0] = a.m[0][0];
+    r.m[0][1] = a.m[1][0];
+    r.m[1][0] = a.m[0][1];
+    r.m[1][1] = a.m[1][1];
+    return r;
+}
+
+LADEF float m2f_det(M2f a)
+{
+    return a.m[0][0]*a.m[1][1] - a.m[1][0]*a.m[0][1];
+}
+
+LADEF M2f m2f_inverse(M2f a)
+{
+    float inv_det = 1.0f / m2f_det(a);
+    M2f r;
+    r.m[0][0] =  a.m[1][1]*inv_det;
+    r.m[0][1] = -a.m[0][1]*inv_det;
+    r.m[1][0] = -a.m[1][0]*inv_det;
+    r.m[1][1] =  a.m[0][0]*inv_det;
+    return r;
+}
+
+LADEF void m2f_mul_v2f_n(V2f *out, M2f a, const V2f *v, size_t n)
+{
+    size_t i = 0;
+#if LA_SSE2
+    // Two vectors per register: x0 y0 x1 y1
+    __m128 c0 = _mm_setr_ps(a.m[0][0], a.m[0][1], a.m[0][0], a.m[0][1]);
+    __m128 c1 = _mm_setr_ps(a.m[1][0], a.m[1][1], a.m[1][0], a.m[1][1]);
+    for (; i < (n & ~(size_t) 1); i += 2) {
+        __m128 p = _mm_loadu_ps(&v[i].x);
+        __m128 x = _mm_shuffle_ps(p, p, _MM_SHUFFLE(2, 2, 0, 0));
+        __m128 y = _mm_shuffle_ps(p, p, _MM_SHUFFLE(3, 3, 1, 1));
+        _mm_storeu_ps(&out[i].x, _mm_add_ps(_mm_mul_ps(c0, x), _mm_mul_ps(c1, y)));
+    }
+#endif // LA_SSE2
+    for (; i < n; ++i) {
+        out[i] = m2f_mul_v2f(a, v[i]);
+    }
+}
+
+LADEF M3f m3f_id(void)
+{
+    M3f r = {0};
+    r.m[0][0] = 1.0f;
+    r.m[1][1] = 1.0f;
+    r.m[2][2] = 1.0f;
+    return r;
+}
+
+LADEF M3f m3f_mul(M3f a, M3f b)
+{
+    M3f r;
+    for (int c = 0; c < 3; ++c) {
+        for (int i = 0; i < 3; ++i) {
+            r.m[c][i] = a.m[0][i]*b.m[c][0] + a.m[1][i]*b.m[c][1] + a.m[2][i]*b.m[c][2];
+        }
+    }
+    return r;
+}
+
+LADEF V3f m3f_mul_v3f(M3f a, V3f v)
+{
+    V3f r;
+    r.x = a.m[0][0]*v.x + a.m[1][0]*v.y + a.m[2][0]*v.z;
+    r.y = a.m[0][1]*v.x + a.m[1][1]*v.y + a.m[2][1]*v.z;
+    r.z = a.m[0][2]*v.x + a.m[1][2]*v.y + a.m[2][2]*v.z;
+    return r;
+}
+
+LADEF M3f m3f_transpose(M3f a)
+{
+    M3f r;
+    for (int c = 0; c < 3; ++c) {
+        for (int i = 0; i < 3; ++i) {
+            r.m[c][i] = a.m[i][c];
+        }
+    }
+    return r;
+}
+
+LADEF float m3f_det(M3f a)
+{
+    return a.m[0][0]*(a.m[1][1]*a.m[2][2] - a.m[2][1]*a.m[1][2])
+         - a.m[1][0]*(a.m[0][1]*a.m[2][2] - a.m[2][1]*a.m[0][2])
+         + a.m[2][0]*(a.m[0][1]*a.m[1][2] - a.m[1][1]*a.m[0][2]);
+}
+
+LADEF M3f m3f_inverse(M3f a)
+{
+    float inv_det = 1.0f / m3f_det(a);
+    M3f r;
+    r.m[0][0] =  (a.m[1][1]*a.m[2][2] - a.m[2][1]*a.m[1][2])*inv_det;
+    r.m[0][1] = -(a.m[0][1]*a.m[2][2] - a.m[2][1]*a.m[0][2])*inv_det;
+    r.m[0][2] =  (a.m[0][1]*a.m[1][2] - a.m[1][1]*a.m[0][2])*inv_det;
+    r.m[1][0] = -(a.m[1][0]*a.m[2][2] - a.m[2][0]*a.m[1][2])*inv_det;
+    r.m[1][1] =  (a.m[0][0]*a.m[2][2] - a.m[2][0]*a.m[0][2])*inv_det;
+    r.m[1][2] = -(a.m[0][0]*a.m[1][2] - a.m[1][0]*a.m[0][2])*inv_det;
+    r.m[2][0] =  (a.m[1][0]*a.m[2][1] - a.m[2][0]*a.m[1][1])*inv_det;
+    r.m[2][1] = -(a.m[0][0]*a.m[2][1] - a.m[2][0]*a.m[0][1])*inv_det;
+    r.m[2][2] =  (a.m[0][0]*a.m[1][1] - a.m[1][0]*a.m[0][1])*inv_det;
+    return r;
+}
+
+LADEF void m3f_mul_v3f_n(V3f *out, M3f a, const V3f *v, size_t n)
+{
+    for (size_t i = 0; i < n; ++i) {
+        out[i] = m3f_mul_v3f(a, v[i]);
+    }
+}
+
+LADEF M3f m3f_a2f(A2f a)
+{
+    M3f r = {0};
+    for (int c = 0; c < 3; ++c) {
+        r.m[c][0] = a.m[c][0];
+        r.m[c][1] = a.m[c][1];
+    }
+    r.m[2][2] = 1.0f;
+    return r;
+}
+
+LADEF M4f m4f_id(void)
+{
+    M4f r = {0};
+    r.m[0][0] = 1.0f;
+    r.m[1][1] = 1.0f;
+    r.m[2][2] = 1.0f;
+    r.m[3][3] = 1.0f;
+    return r;
+}
+
+LADEF M4f m4f_mul(M4f a, M4f b)
+{
+    M4f r;
+#if LA_SSE2
+    __m128 a0 = _mm_loadu_ps(a.m[0]);
+    __m128 a1 = _mm_loadu_ps(a.m[1]);
+    __m128 a2 = _mm_loadu_ps(a.m[2]);
+    __m128 a3 = _mm_loadu_ps(a.m[3]);
+    for (int c = 0; c < 4; ++c) {
+        __m128 s = _mm_mul_ps(a0, _mm_set1_ps(b.m[c][0]));
+        s = _mm_add_ps(s, _mm_mul_ps(a1, _mm_set1_ps(b.m[c][1])));
+        s = _mm_add_ps(s, _mm_mul_ps(a2, _mm_set1_ps(b.m[c][2])));
+        s = _mm_add_ps(s, _mm_mul_ps(a3, _mm_set1_ps(b.m[c][3])));
+        _mm_storeu_ps(r.m[c], s);
+    }
+#else
+    for (int c = 0; c < 4; ++c) {
+        for (int i = 0; i < 4; ++i) {
+            r.m[c][i] = a.m[0][i]*b.m[c][0] + a.m[1][i]*b.m[c][1] + a.m[2][i]*b.m[c][2] + a.m[3][i]*b.m[c][3];
+        }
+    }
+#endif // LA_SSE2
+    return r;
+}
+
+LADEF V4f m4f_mul_v4f(M4f a, V4f v)
+{
+#if LA_SSE2
+    __m128 s = _mm_mul_ps(_mm_loadu_ps(a.m[0]), _mm_set1_ps(v.x));
+    s = _mm_add_ps(s, _mm_mul_ps(_mm_loadu_ps(a.m[1]), _mm_set1_ps(v.y)));
+    s = _mm_add_ps(s, _mm_mul_ps(_mm_loadu_ps(a.m[2]), _mm_set1_ps(v.z)));
+    s = _mm_add_ps(s, _mm_mul_ps(_mm_loadu_ps(a.m[3]), _mm_set1_ps(v.w)));
+    return la_store4f(s);
+#else
+    V4f r;
+    r.x = a.m[0][0]*v.x + a.m[1][0]*v.y + a.m[2][0]*v.z + a.m[3][0]*v.w;
+    r.y = a.m[0][1]*v.x + a.m[1][1]*v.y + a.m[2][1]*v.z + a.m[3][1]*v.w;
+    r.z = a.m[0][2]*v.x + a.m[1][2]*v.y + a.m[2][2]*v.z + a.m[3][2]*v.w;
+    r.w = a.m[0][3]*v.x + a.m[1][3]*v.y + a.m[2][3]*v.z + a.m[3][3]*v.w;
+    return r;
+#endif // LA_SSE2
+}
+
+LADEF M4f m4f_transpose(M4f a)
+{
+#if LA_SSE2
+    __m128 c0 = _mm_loadu_ps(a.m[0]);
+    __m128 c1 = _mm_loadu_ps(a.m[1]);
+    __m128 c2 = _mm_loadu_ps(a.m[2]);
+    __m128 c3 = _mm_loadu_ps(a.m[3]);
+    _MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+    _mm_storeu_ps(a.m[0], c0);
+    _mm_storeu_ps(a.m[1], c1);
+    _mm_storeu_ps(a.m[2], c2);
+    _mm_storeu_ps(a.m[3], c3);
+    return a;
+#else
+    M4f r;
+    for (int c = 0; c < 4; ++c) {
+        for (int i = 0; i < 4; ++i) {
+            r.m[c][i] = a.m[i][c];
+        }
+    }
+    return r;
+#endif // LA_SSE2
+}
+
+// The 2x2 minors of the two upper and the two lower rows, shared by
+// m4f_det() and m4f_inverse()
+typedef struct {
+    float s[6];
+    float c[6];
+} La_M4f_Minors;
+
+static inline La_M4f_Minors la_m4f_minors(const M4f *a)
+{
+    // a.m[column][row], so the element at row i, column j is m[j][i]
+    #define LA_A(i, j) a->m[j][i]
+    La_M4f_Minors r;
+    r.s[0] = LA_A(0, 0)*LA_A(1, 1) - LA_A(1, 0)*LA_A(0, 1);
+    r.s[1] = LA_A(0, 0)*LA_A(1, 2) - LA_A(1, 0)*LA_A(0, 2);
+    r.s[2] = LA_A(0, 0)*LA_A(1, 3) - LA_A(1, 0)*LA_A(0, 3);
+    r.s[3] = LA_A(0, 1)*LA_A(1, 2) - LA_A(1, 1)*LA_A(0, 2);
+    r.s[4] = LA_A(0, 1)*LA_A(1, 3) - LA_A(1, 1)*LA_A(0, 3);
+    r.s[5] = LA_A(0, 2)*LA_A(1, 3) - LA_A(1, 2)*LA_A(0, 3);
+    r.c[5] = LA_A(2, 2)*LA_A(3, 3) - LA_A(3, 2)*LA_A(2, 3);
+    r.c[4] = LA_A(2, 1)*LA_A(3, 3) - LA_A(3, 1)*LA_A(2, 3);
+    r.c[3] = LA_A(2, 1)*LA_A(3, 2) - LA_A(3, 1)*LA_A(2, 2);
+    r.c[2] = LA_A(2, 0)*LA_A(3, 3) - LA_A(3, 0)*LA_A(2, 3);
+    r.c[1] = LA_A(2, 0)*LA_A(3, 2) - LA_A(3, 0)*LA_A(2, 2);
+    r.c[0] = LA_A(2, 0)*LA_A(3, 1) - LA_A(3, 0)*LA_A(2, 1);
+    #undef LA_A
+    return r;
+}
+
+LADEF float m4f_det(M4f a)
+{
+    La_M4f_Minors k = la_m4f_minors(&a);
+    return k.s[0]*k.c[5] - k.s[1]*k.c[4] + k.s[2]*k.c[3] + k.s[3]*k.c[2] - k.s[4]*k.c[1] + k.s[5]*k.c[0];
+}
+
+LADEF M4f m4f_inverse(M4f a)
+{
+    La_M4f_Minors k = la_m4f_minors(&a);
+    float inv_det = 1.0f / (k.s[0]*k.c[5] - k.s[1]*k.c[4] + k.s[2]*k.c[3] + k.s[3]*k.c[2] - k.s[4]*k.c[1] + k.s[5]*k.c[0]);
+
+    #define LA_A(i, j) a.m[j][i]
+    #define LA_R(i, j) r.m[j][i]
+    M4f r;
+    LA_R(0, 0) = ( LA_A(1, 1)*k.c[5] - LA_A(1, 2)*k.c[4] + LA_A(1, 3)*k.c[3])*inv_det;
+    LA_R(0, 1) = (-LA_A(0, 1)*k.c[5] + LA_A(0, 2)*k.c[4] - LA_A(0, 3)*k.c[3])*inv_det;
+    LA_R(0, 2) = ( LA_A(3, 1)*k.s[5] - LA_A(3, 2)*k.s[4] + LA_A(3, 3)*k.s[3])*inv_det;
+    LA_R(0, 3) = (-LA_A(2, 1)*k.s[5] + LA_A(2, 2)*k.s[4] - LA_A(2, 3)*k.s[3])*inv_det;
+    LA_R(1, 0) = (-LA_A(1, 0)*k.c[5] + LA_A(1, 2)*k.c[2] - LA_A(1, 3)*k.c[1])*inv_det;
+    LA_R(1, 1) = ( LA_A(0, 0)*k.c[5] - LA_A(0, 2)*k.c[2] + LA_A(0, 3)*k.c[1])*inv_det;
+    LA_R(1, 2) = (-LA_A(3, 0)*k.s[5] + LA_A(3, 2)*k.s[2] - LA_A(3, 3)*k.s[1])*inv_det;
+    LA_R(1, 3) = ( LA_A(2, 0)*k.s[5] - LA_A(2, 2)*k.s[2] + LA_A(2, 3)*k.s[1])*inv_det;
+    LA_R(2, 0) = ( LA_A(1, 0)*k.c[4] - LA_A(1, 1)*k.c[2] + LA_A(1, 3)*k.c[0])*inv_det;
+    LA_R(2, 1) = (-LA_A(0, 0)*k.c[4] + LA_A(0, 1)*k.c[2] - LA_A(0, 3)*k.c[0])*inv_det;
+    LA_R(2, 2) = ( LA_A(3, 0)*k.s[4] - LA_A(3, 1)*k.s[2] + LA_A(3, 3)*k.s[0])*inv_det;
+    LA_R(2, 3) = (-LA_A(2, 0)*k.s[4] + LA_A(2, 1)*k.s[2] - LA_A(2, 3)*k.s[0])*inv_det;
+    LA_R(3, 0) = (-LA_A(1, 0)*k.c[3] + LA_A(1, 1)*k.c[1] - LA_A(1, 2)*k.c[0])*inv_det;
+    LA_R(3, 1) = ( LA_A(0, 0)*k.c[3] - LA_A(0, 1)*k.c[1] + LA_A(0, 2)*k.c[0])*inv_det;
+    LA_R(3, 2) = (-LA_A(3, 0)*k.s[3] + LA_A(3, 1)*k.s[1] - LA_A(3, 2)*k.s[0])*inv_det;
+    LA_R(3, 3) = ( LA_A(2, 0)*k.s[3] - LA_A(2, 1)*k.s[1] + LA_A(2, 2)*k.s[0])*inv_det;
+    #undef LA_A
+    #undef LA_R
+    return r;
+}
+
+LADEF void m4f_mul_v4f_n(V4f *out, M4f a, const V4f *v, size_t n)
+{
+    for (size_t i = 0; i < n; ++i) {
+        out[i] = m4f_mul_v4f(a, v[i]);
+    }
+}
+
+LADEF M4f m4f_ortho(float left, float right, float bottom, float top, float znear, float zfar)
+{
+    M4f r = {0};
+    r.m[0][0] = 2.0f / (right - left);
+    r.m[1][1] = 2.0f / (top - bottom);
+    r.m[2][2] = -2.0f / (zfar - znear);
+    r.m[3][0] = -(right + left) / (right - left);
+    r.m[3][1] = -(top + bottom) / (top - bottom);
+    r.m[3][2] = -(zfar + znear) / (zfar - znear);
+    r.m[3][3] = 1.0f;
+    return r;
+}
+
+LADEF A2f a2f_id(void)
+{
+    A2f r = {0};
+    r.m[0][0] = 1.0f;
+    r.m[1][1] = 1.0f;
+    return r;
+}
+
+LADEF A2f a2f_translate(V2f t)
+{
+    A2f r = a2f_id();
+    r.m[2][0] = t.x;
+    r.m[2][1] = t.y;
+    return r;
+}
+
+LADEF A2f a2f_scale(V2f s)
+{
+    A2f r = {0};
+    r.m[0][0] = s.x;
+    r.m[1][1] = s.y;
+    return r;
+}
+
+LADEF A2f a2f_rotate(float angle)
+{
+    A2f r = {0};
+    float c = cosf(angle);
+    float s = sinf(angle);
+    r.m[0][0] = c;
+    r.m[0][1] = s;
+    r.m[1][0] = -s;
+    r.m[1][1] = c;
+    return r;
+}
+
+LADEF A2f a2f_mul(A2f a, A2f b)
+{
+    A2f r;
+    for (int c = 0; c < 3; ++c) {
+        for (int i = 0; i < 2; ++i) {
+            r.m[c][i] = a.m[0][i]*b.m[c][0] + a.m[1][i]*b.m[c][1];
+        }
+    }
+    r.m[2][0] += a.m[2][0];
+    r.m[2][1] += a.m[2][1];
+    return r;
+}
+
+LADEF V2f a2f_apply(A2f a, V2f p)
+{
+    V2f r;
+    r.x = a.m[0][0]*p.x + a.m[1][0]*p.y + a.m[2][0];
+    r.y = a.m[0][1]*p.x + a.m[1][1]*p.y + a.m[2][1];
+    return r;
+}
+
+LADEF A2f a2f_inverse(A2f a)
+{
+    float inv_det = 1.0f / (a.m[0][0]*a.m[1][1] - a.m[1][0]*a.m[0][1]);
+    A2f r;
+    r.m[0][0] =  a.m[1][1]*inv_det;
+    r.m[0][1] = -a.m[0][1]*inv_det;
+    r.m[1][0] = -a.m[1][0]*inv_det;
+    r.m[1][1] =  a.m[0][0]*inv_det;
+    r.m[2][0] = -(r.m[0][0]*a.m[2][0] + r.m[1][0]*a.m[2][1]);
+    r.m[2][1] = -(r.m[0][1]*a.m[2][0] + r.m[1][1]*a.m[2][1]);
+    return r;
+}
+
+LADEF void a2f_apply_n(V2f *out, A2f a, const V2f *p, size_t n)
+{
+    size_t i = 0;
+#if LA_SSE2
+    // Two points per register: x0 y0 x1 y1
+    __m128 c0 = _mm_setr_ps(a.m[0][0], a.m[0][1], a.m[0][0], a.m[0][1]);
+    __m128 c1 = _mm_setr_ps(a.m[1][0], a.m[1][1], a.m[1][0], a.m[1][1]);
+    __m128 t = _mm_setr_ps(a.m[2][0], a.m[2][1], a.m[2][0], a.m[2][1]);
+    for (; i < (n & ~(size_t) 1); i += 2) {
+        __m128 v = _mm_loadu_ps(&p[i].x);
+        __m128 x = _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 2, 0, 0));
+        __m128 y = _mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 3, 1, 1));
+        _mm_storeu_ps(&out[i].x, _mm_add_ps(_mm_add_ps(_mm_mul_ps(c0, x), _mm_mul_ps(c1, y)), t));
+    }
+#endif // LA_SSE2
+    for (; i < n; ++i) {
+        out[i] = a2f_apply(a, p[i]);
+    }
+}
+
+#define LA_FAST_ROUND 12582912.0f // Adding and subtracting 1.5*2^23 rounds to the nearest integer
+#define LA_FAST_SINCOS_MAX 4194304.0f
+#define LA_FAST_2_OVER_PI 0.636619772367581343f
+#define LA_FAST_PIO2_1 1.5703125f
+#define LA_FAST_PIO2_2 4.837512969970703125e-4f
+#define LA_FAST_PIO2_3 7.54978995489188216e-8f
+#define LA_FAST_SIN_1 -1.6666654611e-1f
+#define LA_FAST_SIN_2 8.3321608736e-3f
+#define LA_FAST_SIN_3 -1.9515295891e-4f
+#define LA_FAST_COS_1 4.166664568298827e-2f
+#define LA_FAST_COS_2 -1.388731625493765e-3f
+#define LA_FAST_COS_3 2.443315711809948e-5f
+#define LA_FAST_EXP_MAX 88.72283905206835f
+#define LA_FAST_EXP_MIN -87.33654475f
+#define LA_FAST_LOG2E 1.44269504088896341f
+#define LA_FAST_LN2_HI 0.693359375f
+#define LA_FAST_LN2_LO -2.12194440e-4f
+#define LA_FAST_EXP_0 1.9875691500e-4f
+#define LA_FAST_EXP_1 1.3981999507e-3f
+#define LA_FAST_EXP_2 8.3334519073e-3f
+#define LA_FAST_EXP_3 4.1665795894e-2f
+#define LA_FAST_EXP_4 1.6666665459e-1f
+#define LA_FAST_EXP_5 5.0000001201e-1f
+#define LA_FAST_SQRTHF 0.707106781186547524f
+#define LA_FAST_FLT_MIN 1.17549435e-38f
+// rsqrt(x*2^24) = rsqrt(x)*2^-12 brings the denormals into the normal range
+#define LA_FAST_RSQRT_SCALE 16777216.0f
+#define LA_FAST_RSQRT_UNSCALE 4096.0f
+#define LA_FAST_LOG_0 7.0376836292e-2f
+#define LA_FAST_LOG_1 -1.1514610310e-1f
+#define LA_FAST_LOG_2 1.1676998740e-1f
+#define LA_FAST_LOG_3 -1.2420140846e-1f
+#define LA_FAST_LOG_4 1.4249322787e-1f
+#define LA_FAST_LOG_5 -1.6668057665e-1f
+#define LA_FAST_LOG_6 2.0000714765e-1f
+#define LA_FAST_LOG_7 -2.4999993993e-1f
+#define LA_FAST_LOG_8 3.3333331174e-1f
+
+// The polynomials are the ones of Cephes, the vectorized versions below
+// repeat the scalar ones operation by operation
+static inline float la_sincosf_fast(float x, int quadrant)
+{
+    if (!(fabsf(x) <= LA_FAST_SINCOS_MAX)) return x - x;
+    float k = (x*LA_FAST_2_OVER_PI + LA_FAST_ROUND) - LA_FAST_ROUND;
+    int q = (int) k + quadrant;
+    float r = ((x - k*LA_FAST_PIO2_1) - k*LA_FAST_PIO2_2) - k*LA_FAST_PIO2_3;
+    float z = r*r;
+    float s = ((LA_FAST_SIN_3*z + LA_FAST_SIN_2)*z + LA_FAST_SIN_1)*z*r + r;
+    float c = ((LA_FAST_COS_3*z + LA_FAST_COS_2)*z + LA_FAST_COS_1)*z*z - 0.5f*z + 1.0f;
+    float v = (q & 1) ? c : s;
+    return (q & 2) ? -v : v;
+}
+
+LADEF float sinf_fast(float x)
+{
+    return la_sincosf_fast(x, 0);
+}
+
+LADEF float cosf_fast(float x)
+{
+    return la_sincosf_fast(x, 1);
+}
+
+static inline float la_pow2f(int n)
+{
+    union { float f; unsigned int u; } b;
+    b.u = (unsigned int) (n + 127) << 23;
+    return b.f;
+}
+
+LADEF float expf_fast(float x)
+{
+    if (x != x) return x;
+    if (x > LA_FAST_EXP_MAX) return INFINITY;
+    if (x < LA_FAST_EXP_MIN) return 0.0f;
+    float k = (x*LA_FAST_LOG2E + LA_FAST_ROUND) - LA_FAST_ROUND;
+    float r = (x - k*LA_FAST_LN2_HI) - k*LA_FAST_LN2_LO;
+    float z = r*r;
+    float p = ((((LA_FAST_EXP_0*r + LA_FAST_EXP_1)*r + LA_FAST_EXP_2)*r + LA_FAST_EXP_3)*r + LA_FAST_EXP_4)*r + LA_FAST_EXP_5;
+    float y = p*z + r + 1.0f;
+    // 2^128 does not fit into a float, so scale in two steps
+    int n = (int) k;
+    int n1 = n >> 1;
+    return y*la_pow2f(n1)*la_pow2f(n - n1);
+}
+
+LADEF float logf_fast(float x)
+{
+    if (x != x || x < 0.0f) return NAN;
+    if (x < LA_FAST_FLT_MIN) return -INFINITY;
+    if (x == INFINITY) return INFINITY;
+    union { float f; unsigned int u; } b;
+    b.f = x;
+    int e = (int) ((b.u >> 23) & 0xff) - 126;
+    b.u = (b.u & 0x807fffff) | 0x3f000000;
+    float m = b.f;
+    if (m < LA_FAST_SQRTHF) {
+        e -= 1;
+        m = m - 1.0f + m;
+    } else {
+        m = m - 1.0f;
+    }
+    float z = m*m;
+    float y = ((((((((LA_FAST_LOG_0*m + LA_FAST_LOG_1)*m + LA_FAST_LOG_2)*m + LA_FAST_LOG_3)*m + LA_FAST_LOG_4)*m
+                   + LA_FAST_LOG_5)*m + LA_FAST_LOG_6)*m + LA_FAST_LOG_7)*m + LA_FAST_LOG_8)*m*z;
+    float fe = (float) e;
+    y = y + fe*LA_FAST_LN2_LO;
+    y = y - 0.5f*z;
+    return (m + y) + fe*LA_FAST_LN2_HI;
+}
+
+LADEF float powf_fast(float x, float y)
+{
+    if (y == 0.0f) return 1.0f;
+    return expf_fast(y*logf_fast(x));
+}
+
+// The estimate of rsqrtss differs between the CPU vendors, so the results
+// of rsqrtf_fast() do too. rsqrtss treats the denormals as 0, so they are
+// scaled into the normal range first.
+LADEF float rsqrtf_fast(float x)
+{
+#if LA_SSE2
+    int denormal = x > 0.0f && x < LA_FAST_FLT_MIN;
+    if (denormal) x = x*LA_FAST_RSQRT_SCALE;
+    float y = _mm_cvtss_f32(_mm_rsqrt_ss(_mm_set_ss(x)));
+    // One Newton-Raphson step doubles the 12 bits of the estimate, where it is finite
+    if (x > 0.0f && x < INFINITY) y = y*(1.5f - 0.5f*x*y*y);
+    return denormal ? y*LA_FAST_RSQRT_UNSCALE : y;
+#else
+    return 1.0f / sqrtf(x);
+#endif // LA_SSE2
+}
+
+#if LA_SSE2
+static inline __m128 la_select_ps(__m128 mask, __m128 a, __m128 b)
+{
+    return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+}
+
+static inline __m128 la_round_ps(__m128 x)
+{
+    return _mm_sub_ps(_mm_add_ps(x, _mm_set1_ps(LA_FAST_ROUND)), _mm_set1_ps(LA_FAST_ROUND));
+}
+
+static inline __m128 la_sincos_fast_ps(__m128 x, int quadrant)
+{
+    __m128 k = la_round_ps(_mm_mul_ps(x, _mm_set1_ps(LA_FAST_2_OVER_PI)));
+    __m128i q = _mm_add_epi32(_mm_cvttps_epi32(k), _mm_set1_epi32(quadrant));
+    __m128 r = _mm_sub_ps(x, _mm_mul_ps(k, _mm_set1_ps(LA_FAST_PIO2_1)));
+    r = _mm_sub_ps(r, _mm_mul_ps(k, _mm_set1_ps(LA_FAST_PIO2_2)));
+    r = _mm_sub_ps(r, _mm_mul_ps(k, _mm_set1_ps(LA_FAST_PIO2_3)));
+    __m128 z = _mm_mul_ps(r, r);
+
+    __m128 s = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(LA_FAST_SIN_3), z), _mm_set1_ps(LA_FAST_SIN_2));
+    s = _mm_add_ps(_mm_mul_ps(s, z), _mm_set1_ps(LA_FAST_SIN_1));
+    s = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(s, z), r), r);
+
+    __m128 c = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(LA_FAST_COS_3), z), _mm_set1_ps(LA_FAST_COS_2));
+    c = _mm_add_ps(_mm_mul_ps(c, z), _mm_set1_ps(LA_FAST_COS_1));
+    c = _mm_sub_ps(_mm_mul_ps(_mm_mul_ps(c, z), z), _mm_mul_ps(_mm_set1_ps(0.5f), z));
+    c = _mm_add_ps(c, _mm_set1_ps(1.0f));
+
+    __m128i one = _mm_set1_epi32(1);
+    __m128 odd = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(q, one), one));
+    __m128 sign = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(q, _mm_set1_epi32(2)), 30));
+    __m128 v = _mm_xor_ps(la_select_ps(odd, c, s), sign);
+
+    __m128 abs_x = _mm_andnot_ps(_mm_set1_ps(-0.0f), x);
+    __m128 out_of_range = _mm_cmpnle_ps(abs_x, _mm_set1_ps(LA_FAST_SINCOS_MAX));
+    return la_select_ps(out_of_range, _mm_sub_ps(x, x), v);
+}
+
+static inline __m128 la_pow2_ps(__m128i n)
+{
+    return _mm_castsi128_ps(_mm_slli_epi32(_mm_add_epi32(n, _mm_set1_epi32(127)), 23));
+}
+
+static inline __m128 la_exp_fast_ps(__m128 x)
+{
+    __m128 k = la_round_ps(_mm_mul_ps(x, _mm_set1_ps(LA_FAST_LOG2E)));
+    __m128 r = _mm_sub_ps(x, _mm_mul_ps(k, _mm_set1_ps(LA_FAST_LN2_HI)));
+    r = _mm_sub_ps(r, _mm_mul_ps(k, _mm_set1_ps(LA_FAST_LN2_LO)));
+    __m128 z = _mm_mul_ps(r, r);
+    __m128 p = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(LA_FAST_EXP_0), r), _mm_set1_ps(LA_FAST_EXP_1));
+    p = _mm_add_ps(_mm_mul_ps(p, r), _mm_set1_ps(LA_FAST_EXP_2));
+    p = _mm_add_ps(_mm_mul_ps(p, r), _mm_set1_ps(LA_FAST_EXP_3));
+    p = _mm_add_ps(_mm_mul_ps(p, r), _mm_set1_ps(LA_FAST_EXP_4));
+    p = _mm_add_ps(_mm_mul_ps(p, r), _mm_set1_ps(LA_FAST_EXP_5));
+    __m128 y = _mm_add_ps(_mm_add_ps(_mm_mul_ps(p, z), r), _mm_set1_ps(1.0f));
+
+    __m128i n = _mm_cvttps_epi32(k);
+    __m128i n1 = _mm_srai_epi32(n, 1);
+    y = _mm_mul_ps(_mm_mul_ps(y, la_pow2_ps(n1)), la_pow2_ps(_mm_sub_epi32(n, n1)));
+
+    y = la_select_ps(_mm_cmplt_ps(x, _mm_set1_ps(LA_FAST_EXP_MIN)), _mm_setzero_ps(), y);
+    y = la_select_ps(_mm_cmpgt_ps(x, _mm_set1_ps(LA_FAST_EXP_MAX)), _mm_set1_ps(INFINITY), y);
+    return la_select_ps(_mm_cmpunord_ps(x, x), x, y);
+}
+
+static inline __m128 la_log_fast_ps(__m128 x)
+{
+    __m128i bits = _mm_castps_si128(x);
+    __m128i e = _mm_sub_epi32(_mm_and_si128(_mm_srli_epi32(bits, 23), _mm_set1_epi32(0xff)), _mm_set1_epi32(126));
+    __m128 m = _mm_castsi128_ps(_mm_or_si128(_mm_and_si128(bits, _mm_set1_epi32((int) 0x807fffff)), _mm_set1_epi32(0x3f000000)));
+    __m128 small = _mm_cmplt_ps(m, _mm_set1_ps(LA_FAST_SQRTHF));
+    e = _mm_sub_epi32(e, _mm_and_si128(_mm_castps_si128(small), _mm_set1_epi32(1)));
+    m = _mm_add_ps(_mm_sub_ps(m, _mm_set1_ps(1.0f)), _mm_and_ps(small, m));
+
+    __m128 z = _mm_mul_ps(m, m);
+    __m128 y = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(LA_FAST_LOG_0), m), _mm_set1_ps(LA_FAST_LOG_1));
+    y = _mm_add_ps(_mm_mul_ps(y, m), _mm_set1_ps(LA_FAST_LOG_2));
+    y = _mm_add_ps(_mm_mul_ps(y, m), _mm_set1_ps(LA_FAST_LOG_3));
+    y = _mm_add_ps(_mm_mul_ps(y, m), _mm_set1_ps(LA_FAST_LOG_4));
+    y = _mm_add_ps(_mm_mul_ps(y, m), _mm_set1_ps(LA_FAST_LOG_5));
+    y = _mm_add_ps(_mm_mul_ps(y, m), _mm_set1_ps(LA_FAST_LOG_6));
+    y = _mm_add_ps(_mm_mul_ps(y, m), _mm_set1_ps(LA_FAST_LOG_7));
+    y = _mm_add_ps(_mm_mul_ps(y, m), _mm_set1_ps(LA_FAST_LOG_8));
+    y = _mm_mul_ps(_mm_mul_ps(y, m), z);
+    __m128 fe = _mm_cvtepi32_ps(e);
+    y = _mm_add_ps(y, _mm_mul_ps(fe, _mm_set1_ps(LA_FAST_LN2_LO)));
+    y = _mm_sub_ps(y, _mm_mul_ps(_mm_set1_ps(0.5f), z));
+    __m128 r = _mm_add_ps(_mm_add_ps(m, y), _mm_mul_ps(fe, _mm_set1_ps(LA_FAST_LN2_HI)));
+
+    r = la_select_ps(_mm_cmpeq_ps(x, _mm_set1_ps(INFINITY)), x, r);
+    r = la_select_ps(_mm_cmplt_ps(x, _mm_set1_ps(LA_FAST_FLT_MIN)), _mm_set1_ps(-INFINITY), r);
+    __m128 invalid = _mm_or_ps(_mm_cmpunord_ps(x, x), _mm_cmplt_ps(x, _mm_setzero_ps()));
+    return la_select_ps(invalid, _mm_set1_ps(NAN), r);
+}
+
+static inline __m128 la_pow_fast_ps(__m128 x, __m128 y)
+{
+    __m128 r = la_exp_fast_ps(_mm_mul_ps(y, la_log_fast_ps(x)));
+    return la_select_ps(_mm_cmpeq_ps(y, _mm_setzero_ps()), _mm_set1_ps(1.0f), r);
+}
+
+static inline __m128 la_rsqrt_fast_ps(__m128 x)
+{
+    __m128 denormal = _mm_and_ps(_mm_cmpgt_ps(x, _mm_setzero_ps()), _mm_cmplt_ps(x, _mm_set1_ps(LA_FAST_FLT_MIN)));
+    x = la_select_ps(denormal, _mm_mul_ps(x, _mm_set1_ps(LA_FAST_RSQRT_SCALE)), x);
+    __m128 y = _mm_rsqrt_ps(x);
+    __m128 t = _mm_mul_ps(_mm_mul_ps(_mm_mul_ps(_mm_set1_ps(0.5f), x), y), y);
+    __m128 refined = _mm_mul_ps(y, _mm_sub_ps(_mm_set1_ps(1.5f), t));
+    __m128 finite = _mm_and_ps(_mm_cmpgt_ps(x, _mm_setzero_ps()), _mm_cmplt_ps(x, _mm_set1_ps(INFINITY)));
+    y = la_select_ps(finite, refined, y);
+    return la_select_ps(denormal, _mm_mul_ps(y, _mm_set1_ps(LA_FAST_RSQRT_UNSCALE)), y);
+}
+#endif // LA_SSE2
+
+LADEF V2f v2f_sin_fast(V2f a)
+{
+#if LA_SSE2
+    return la_store2f(la_sincos_fast_ps(la_load2f(a, 0.0f), 0));
+#else
+    a.x = sinf_fast(a.x);
+    a.y = sinf_fast(a.y);
+    return a;
+#endif // LA_SSE2
+}
+
+LADEF V2f v2f_cos_fast(V2f a)
+{
+#if LA_SSE2
+    return la_store2f(la_sincos_fast_ps(la_load2f(a, 0.0f), 1));
+#else
+    a.x = cosf_fast(a.x);
+    a.y = cosf_fast(a.y);
+    return a;
+#endif // LA_SSE2
+}
+
+LADEF V2f v2f_exp_fast(V2f a)
+{
+#if LA_SSE2
+    return la_store2f(la_exp_fast_ps(la_load2f(a, 0.0f)));
+#else
+    a.x = expf_fast(a.x);
+    a.y = expf_fast(a.y);
+    return a;
+#endif // LA_SSE2
+}
+
+LADEF V2f v2f_log_fast(V2f a)
+{
+#if LA_SSE2
+    return la_store2f(la_log_fast_ps(la_load2f(a, 1.0f)));
+#else
+    a.x = logf_fast(a.x);
+    a.y = logf_fast(a.y);
+    return a;
+#endif // LA_SSE2
+}
+
+LADEF V2f v2f_pow_fast(V2f base, V2f exp)
+{
+#if LA_SSE2
+    return la_store2f(la_pow_fast_ps(la_load2f(base, 1.0f), la_load2f(exp, 1.0f)));
+#else
+    base.x = powf_fast(base.x, exp.x);
+    base.y = powf_fast(base.y, exp.y);
+    return base;
+#endif // LA_SSE2
+}
+
+LADEF V2f v2f_rsqrt_fast(V2f a)
+{
+#if LA_SSE2
+    return la_store2f(la_rsqrt_fast_ps(la_load2f(a, 1.0f)));
+#else
+    a.x = rsqrtf_fast(a.x);
+    a.y = rsqrtf_fast(a.y);
+    return a;
+#endif // LA_SSE2
+}
+
+LADEF V3f v3f_sin_fast(V3f a)
+{
+    a.x = sinf_fast(a.x);
+    a.y = sinf_fast(a.y);
+    a.z = sinf_fast(a.z);
+    return a;
+}
+
+LADEF V3f v3f_cos_fast(V3f a)
+{
+    a.x = cosf_fast(a.x);
+    a.y = cosf_fast(a.y);
+    a.z = cosf_fast(a.z);
+    return a;
+}
+
+LADEF V3f v3f_exp_fast(V3f a)
+{
+    a.x = expf_fast(a.x);
+    a.y = expf_fast(a.y);
+    a.z = expf_fast(a.z);
+    return a;
+}
+
+LADEF V3f v3f_log_fast(V3f a)
+{
+    a.x = logf_fast(a.x);
+    a.y = logf_fast(a.y);
+    a.z = logf_fast(a.z);
+    return a;
+}
+
+LADEF V3f v3f_pow_fast(V3f base, V3f exp)
+{
+    base.x = powf_fast(base.x, exp.x);
+    base.y = powf_fast(base.y, exp.y);
+    base.z = powf_fast(base.z, exp.z);
+    return base;
+}
+
+LADEF V3f v3f_rsqrt_fast(V3f a)
+{
+    a.x = rsqrtf_fast(a.x);
+    a.y = rsqrtf_fast(a.y);
+    a.z = rsqrtf_fast(a.z);
+    return a;
+}
+
+LADEF V4f v4f_sin_fast(V4f a)
+{
+#if LA_SSE2
+    return la_store4f(la_sincos_fast_ps(la_load4f(a), 0));
+#else
+    a.x = sinf_fast(a.x);
+    a.y = sinf_fast(a.y);
+    a.z = sinf_fast(a.z);
+    a.w = sinf_fast(a.w);
+    return a;
+#endif // LA_SSE2
+}
+
+LADEF V4f v4f_cos_fast(V4f a)
+{
+#if LA_SSE2
+    return la_store4f(la_sincos_fast_ps(la_load4f(a), 1));
+#else
+    a.x = cosf_fast(a.x);
+    a.y = cosf_fast(a.y);
+    a.z = cosf_fast(a.z);
+    a.w = cosf_fast(a.w);
+    return a;
+#endif // LA_SSE2
+}
+
+LADEF V4f v4f_exp_fast(V4f a)
+{
+#if LA_SSE2
+    return la_store4f(la_exp_fast_ps(la_load4f(a)));
+#else
+    a.x = expf_fast(a.x);
+    a.y = expf_fast(a.y);
+    a.z = expf_fast(a.z);
+    a.w = expf_fast(a.w);
+    return a;
+#endif // LA_SSE2
+}
+
+LADEF V4f v4f_log_fast(V4f a)
+{
+#if LA_SSE2
+    return la_store4f(la_log_fast_ps(la_load4f(a)));
+#else
+    a.x = logf_fast(a.x);
+    a.y = logf_fast(a.y);
+    a.z = logf_fast(a.z);
+    a.w = logf_fast(a.w);
+    return a;
+#endif // LA_SSE2
+}
+
+LADEF V4f v4f_pow_fast(V4f base, V4f exp)
+{
+#if LA_SSE2
+    return la_store4f(la_pow_fast_ps(la_load4f(base), la_load4f(exp)));
+#else
+    base.x = powf_fast(base.x, exp.x);
+    base.y = powf_fast(base.y, exp.y);
+    base.z = powf_fast(base.z, exp.z);
+    base.w = powf_fast(base.w, exp.w);
+    return base;
+#endif // LA_SSE2
+}
+
+LADEF V4f v4f_rsqrt_fast(V4f a)
+{
+#if LA_SSE2
+    return la_store4f(la_rsqrt_fast_ps(la_load4f(a)));
+#else
+    a.x = rsqrtf_fast(a.x);
+    a.y = rsqrtf_fast(a.y);
+    a.z = rsqrtf_fast(a.z);
+    a.w = rsqrtf_fast(a.w);
+    return a;
+#endif // LA_SSE2
+}
+
+LADEF void floats_sin_fast_n(float *out, const float *a, size_t n)
+{
+    size_t i = 0;
+#if LA_SSE2
+    for (; i < (n & ~(size_t) 3); i += 4) {
+        _mm_storeu_ps(out + i, la_sincos_fast_ps(_mm_loadu_ps(a + i), 0));
+    }
+#endif // LA_SSE2
+    for (; i < n; ++i) {
+        out[i] = sinf_fast(a[i]);
+    }
+}
+
+LADEF void floats_cos_fast_n(float *out, const float *a, size_t n)
+{
+    size_t i = 0;
+#if LA_SSE2
+    for (; i < (n & ~(size_t) 3); i += 4) {
+        _mm_storeu_ps(out + i, la_sincos_fast_ps(_mm_loadu_ps(a + i), 1));
+    }
+#endif // LA_SSE2
+    for (; i < n; ++i) {
+        out[i] = cosf_fast(a[i]);
+    }
+}
+
+LADEF void floats_exp_fast_n(float *out, const float *a, size_t n)
+{
+    size_t i = 0;
+#if LA_SSE2
+    for (; i < (n & ~(size_t) 3); i += 4) {
+        _mm_storeu_ps(out + i, la_exp_fast_ps(_mm_loadu_ps(a + i)));
+    }
+#endif // LA_SSE2
+    for (; i < n; ++i) {
+        out[i] = expf_fast(a[i]);
+    }
+}
+
+LADEF void floats_log_fast_n(float *out, const float *a, size_t n)
+{
+    size_t i = 0;
+#if LA_SSE2
+    for (; i < (n & ~(size_t) 3); i += 4) {
+        _mm_storeu_ps(out + i, la_log_fast_ps(_mm_loadu_ps(a + i)));
+    }
+#endif // LA_SSE2
+    for (; i < n; ++i) {
+        out[i] = logf_fast(a[i]);
+    }
+}
+
+LADEF void floats_pow_fast_n(float *out, const float *base, const float *exp, size_t n)
+{
+    size_t i = 0;
+#if LA_SSE2
+    for (; i < (n & ~(size_t) 3); i += 4) {
+        _mm_storeu_ps(out + i, la_pow_fast_ps(_mm_loadu_ps(base + i), _mm_loadu_ps(exp + i)));
+    }
+#endif // LA_SSE2
+    for (; i < n; ++i) {
+        out[i] = powf_fast(base[i], exp[i]);
+    }
+}
+
+LADEF void floats_rsqrt_fast_n(float *out, const float *a, size_t n)
+{
+    size_t i = 0;
+#if LA_SSE2
+    for (; i < (n & ~(size_t) 3); i += 4) {
+        _mm_storeu_ps(out + i, la_rsqrt_fast_ps(_mm_loadu_ps(a + i)));
+    }
+#endif // LA_SSE2
+    for (; i < n; ++i) {
+        out[i] = rsqrtf_fast(a[i]);
+    }
+}
+
+#if LA_SSE2
+static inline __m128 la_load3fa(V3fa a) { return _mm_load_ps(&a.x); }
+static inline V3fa la_store3fa(__m128 r) { V3fa a; _mm_store_ps(&a.x, r); return a; }
+static inline __m128 la_load4fa(V4fa a) { return _mm_load_ps(&a.x); }
+static inline V4fa la_store4fa(__m128 r) { V4fa a; _mm_store_ps(&a.x, r); return a; }
+static inline __m128i la_load3ia(V3ia a) { return _mm_load_si128((const __m128i*) &a); }
+static inline V3ia la_store3ia(__m128i r) { V3ia a; _mm_store_si128((__m128i*) &a, r); return a; }
+static inline __m128i la_load4ia(V4ia a) { return _mm_load_si128((const __m128i*) &a); }
+static inline V4ia la_store4ia(__m128i r) { V4ia a; _mm_store_si128((__m128i*) &a, r); return a; }
+static inline __m128i la_load3ua(V3ua a) { return _mm_load_si128((const __m128i*) &a); }
+static inline V3ua la_store3ua(__m128i r) { V3ua a; _mm_store_si128((__m128i*) &a, r); return a; }
+static inline __m128i la_load4ua(V4ua a) { return _mm_load_si128((const __m128i*) &a); }
+static inline V4ua la_store4ua(__m128i r) { V4ua a; _mm_store_si128((__m128i*) &a, r); return a; }
+#endif // LA_SSE2
+
+#if LA_AVX
+// V3da and V4da are only aligned to 16, a whole AVX register is loaded unaligned
+static inline __m256d la_load3da(V3da a) { return _mm256_loadu_pd(&a.x); }
+static inline V3da la_store3da(__m256d r) { V3da a; _mm256_storeu_pd(&a.x, r); return a; }
+static inline __m256d la_load4da(V4da a) { return _mm256_loadu_pd(&a.x); }
+static inline V4da la_store4da(__m256d r) { V4da a; _mm256_storeu_pd(&a.x, r); return a; }
+#endif // LA_AVX
+
+LADEF void *la_aligned_alloc(size_t alignment, size_t size)
+{
+#ifdef _MSC_VER
+    return _aligned_malloc(size, alignment);
+#else
+    // aligned_alloc() only takes the sizes that are multiples of the alignment
+    return aligned_alloc(alignment, (size + alignment - 1) & ~(alignment - 1));
+#endif // _MSC_VER
+}
+
+LADEF void la_aligned_free(void *p)
+{
+#ifdef _MSC_VER
+    _aligned_free(p);
+#else
+    free(p);
+#endif // _MSC_VER
+}
+
+LADEF V3fa v3fa(float x, float y, float z)
+{
+    V3fa v;
+    v.x = x;
+    v.y = y;
+    v.z = z;
+    v.pad = 0;
+    return v;
+}
+
+LADEF V3fa v3faf(float x)
+{
+    return v3fa(x, x, x);
+}
+
+LADEF V3fa v3fa3f(V3f a)
+{
+    return v3fa(a.x, a.y, a.z);
+}
+
+LADEF V3f v3f3fa(V3fa a)
+{
+    return v3f(a.x, a.y, a.z);
+}
+
+LADEF V3fa v3fa_sum(V3fa a, V3fa b)
+{
+#if LA_SSE2
+    return la_store3fa(_mm_add_ps(la_load3fa(a), la_load3fa(b)));
+#else
+    a.x += b.x;
+    a.y += b.y;
+    a.z += b.z;
+    return a;
+#endif // LA_SSE2
+}
+
+LADEF V3fa v3fa_sub(V3fa a, V3fa b)
+{
+#if LA_SSE2
+    return la_store3fa(_mm_sub_ps(la_load3fa(a), la_load3fa(b)));
+#else
+    a.x -= b.x;
+    a.y -= b.y;
+    a.z -= b.z;
+    return a;
+#endif // LA_SSE2
+}
+
+LADEF V3fa v3fa_mul(V3fa a, V3fa b)
+{
+#if LA_SSE2
+    return la_store3fa(_mm_mul_ps(la_load3fa(a), la_load3fa(b)));
+#else
+    a.x *= b.x;
+    a.y *= b.y;
+    a.z *= b.z;
+    return a;
+#endif // LA_SSE2
+}
+
+LADEF V3fa v3fa_div(V3fa a, V3fa b)
+{
+#if LA_SSE2
+    return la_store3fa(_mm_div_ps(la_load3fa(a), la_load3fa(b)));
+#else
+    a.x /= b.x;
+    a.y /= b.y;
+    a.z /= b.z;
+    return a;
+#endif // LA_SSE2
+}
+
+LADEF V3fa v3fa_sqrt(V3fa a)
+{
+#if LA_SSE2
+    return la_store3fa(_mm_sqrt_ps(la_load3fa(a)));
+#else
+    a.x = sqrtf(a.x);
+    a.y = sqrtf(a.y);
+    a.z = sqrtf(a.z);
+    return a;
+#endif // LA_SSE2
+}
+
+LADEF V3fa v3fa_pow(V3fa base, V3fa exp)
+{
+    base.x = powf(base.x, exp.x);
+    base.y = powf(base.y, exp.y);
+    base.z = powf(base.z, exp.z);
+    return base;
+}
+
+LADEF V3fa v3fa_sin(V3fa a)
+{
+    a.x = sinf(a.x);
+    a.y = sinf(a.y);
+    a.z = sinf(a.z);
+    return a;
+}
+
+LADEF V3fa v3fa_cos(V3fa a)
+{
+    a.x = cosf(a.x);
+    a.y = cosf(a.y);
+    a.z = cosf(a.z);
+    return a;
+}
+
+LADEF V3fa v3fa_min(V3fa a, V3fa b)
+{
+#if LA_SSE2
+    return la_store3fa(la_fmin_ps(la_load3fa(a), la_load3fa(b)));
+#else
+    a.x = fminf(a.x, b.x);
+    a.y = fminf(a.y, b.y);
+    a.z = fminf(a.z, b.z);
+    return a;
+#endif // LA_SSE2
+}
+
+LADEF V3fa v3fa_max(V3fa a, V3fa b)
+{
+#if LA_SSE2
+    return la_store3fa(la_fmax_ps(la_load3fa(a), la_load3fa(b)));
+#else
+    a.x = fmaxf(a.x, b.x);
+    a.y = fmaxf(a.y, b.y);
+    a.z = fmaxf(a.z, b.z);
+    return a;
+#endif // LA_SSE2
+}
+
+LADEF V3fa v3fa_lerp(V3fa a, V3fa b, V3fa t)
+{
+#if LA_SSE2
+    __m128 va = la_load3fa(a);
+    return la_store3fa(_mm_add_ps(va, _mm_mul_ps(_mm_sub_ps(la_load3fa(b), va), la_load3fa(t))));
+#else
+    a.x = lerpf(a.x, b.x, t.x);
+    a.y = lerpf(a.y, b.y, t.y);
+    a.z = lerpf(a.z, b.z, t.z);
+    return a;
+#endif // LA_SSE2
+}
+
+LADEF V3fa v3fa_floor(V3fa a)
+{
+#if LA_SSE41
+    return la_store3fa(_mm_floor_ps(la_load3fa(a)));
+#else
+    a.x = floorf(a.x);
+    a.y = floorf(a.y);
+    a.z = floorf(a.z);
+    return a;
+#endif // LA_SSE41
+}
+
+LADEF V3fa v3fa_ceil(V3fa a)
+{
+#if LA_SSE41
+    return la_store3fa(_mm_ceil_ps(la_load3fa(a)));
+#else
+    a.x = ceilf(a.x);
+    a.y = ceilf(a.y);
+    a.z = ceilf(a.z);
+    return a;
+#endif // LA_SSE41
+}
+
+LADEF V3fa v3fa_clamp(V3fa x, V3fa a, V3fa b)
+{
+#if LA_SSE2
+    return la_store3fa(la_fmin_ps(la_fmax_ps(la_load3fa(a), la_load3fa(x)), la_load3fa(b)));
+#else
+    x.x = clampf(x.x, a.x, b.x);
+    x.y = clampf(x.y, a.y, b.y);
+    x.z = clampf(x.z, a.z, b.z);
+    return x;
+#endif // LA_SSE2
+}
+
+LADEF float v3fa_sqrlen(V3fa a)
+{
+    return a.x*a.x + a.y*a.y + a.z*a.z;
+}
+
+LADEF float v3fa_len(V3fa a)
+{
+    return sqrtf(v3fa_sqrlen(a));
+}
+
+LADEF void v3fa_sum_n(V3fa *out, const V3fa *a, const V3fa *b, size_t n)
+{
+#if LA_SSE2
+    for (size_t i = 0; i < n; ++i) {
+        _mm_store_ps(&out[i].x, _mm_add_ps(_mm_load_ps(&a[i].x), _mm_load_ps(&b[i].x)));
+    }
+#else
+    floats_sum_n((float*) out, (const float*) a, (const float*) b, n * 4);
+#endif // LA_SSE2
+}
+
+LADEF void v3fa_sub_n(V3fa *out, const V3fa *a, const V3fa *b, size_t n)
+{
+#if LA_SSE2
+    for (size_t i = 0; i < n; ++i) {
+        _mm_store_ps(&out[i].x, _mm_sub_ps(_mm_load_ps(&a[i].x), _mm_load_ps(&b[i].x)));
+    }
+#else
+    floats_sub_n((float*) out, (const float*) a, (const float*) b, n * 4);
+#endif // LA_SSE2
+}
+
+LADEF void v3fa_mul_n(V3fa *out, const V3fa *a, const V3fa *b, size_t n)
+{
+#if LA_SSE2
+    for (size_t i = 0; i < n; ++i) {
+        _mm_store_ps(&out[i].x, _mm_mul_ps(_mm_load_ps(&a[i].x), _mm_load_ps(&b[i].x)));
+    }
+#else
+    floats_mul_n((float*) out, (const float*) a, (const float*) b, n * 4);
+#endif // LA_SSE2
+}
+
+LADEF void v3fa_div_n(V3fa *out, const V3fa *a, const V3fa *b, size_t n)
+{
+#if LA_SSE2
+    for (size_t i = 0; i < n; ++i) {
+        _mm_store_ps(&out[i].x, _mm_div_ps(_mm_load_ps(&a[i].x), _mm_load_ps(&b[i].x)));
+    }
+#else
+    floats_div_n((float*) out, (const float*) a, (const float*) b, n * 4);
+#endif // LA_SSE2
+}
+
+LADEF void v3fa_sqrt_n(V3fa *out, const V3fa *a, size_t n)
+{
+#if LA_SSE2
+    for (size_t i = 0; i < n; ++i) {
+        _mm_store_ps(&out[i].x, _mm_sqrt_ps(_mm_load_ps(&a[i].x)));
+    }
+#else
+    floats_sqrt_n((float*) out, (const float*) a, n * 4);
+#endif // LA_SSE2
+}
+
+LADEF void v3fa_min_n(V3fa *out, const V3fa *a, const V3fa *b, size_t n)
+{
+#if LA_SSE2
+    for (size_t i = 0; i < n; ++i) {
+        _mm_store_ps(&out[i].x, la_fmin_ps(_mm_load_ps(&a[i].x), _mm_load_ps(&b[i].x)));
+    }
+#else
+    floats_min_n((float*) out, (const float*) a, (const float*) b, n * 4);
+#endif // LA_SSE2
+}
+
+LADEF void v3fa_max_n(V3fa *out, const V3fa *a, const V3fa *b, size_t n)
+{
+#if LA_SSE2
+    for (size_t i = 0; i < n; ++i) {
+        _mm_store_ps(&out[i].x, la_fmax_ps(_mm_load_ps(&a[i].x), _mm_load_ps(&b[i].x)));
+    }
+#else
+    floats_max_n((float*) out, (const float*) a, (const float*) b, n * 4);
+#endif // LA_SSE2
+}
+
+LADEF void v3fa_lerp_n(V3fa *out, const V3fa *a, const V3fa *b, const V3fa *t, size_t n)
+{
+#if LA_SSE2
+    for (size_t i = 0; i < n; ++i) {
+        __m128 va = _mm_load_ps(&a[i].x);
+        _mm_store_ps(&out[i].x, _mm_add_ps(va, _mm_mul_ps(_mm_sub_ps(_mm_load_ps(&b[i].x), va), _mm_load_ps(&t[i].x))));
+    }
+#else
+    floats_lerp_n((float*) out, (const float*) a, (const float*) b, (const float*) t, n * 4);
+#endif // LA_SSE2
+}
+
+LADEF void v3fa_clamp_n(V3fa *out, const V3fa *x, const V3fa *a, const V3fa *b, size_t n)
+{
+#if LA_SSE2
+    for (size_t i = 0; i < n; ++i) {
+        _mm_store_ps(&out[i].x, la_fmin_ps(la_fmax_ps(_mm_load_ps(&a[i].x), _mm_load_ps(&x[i].x)), _mm_load_ps(&b[i].x)));
+    }
+#else
+    floats_clamp_n((float*) out, (const float*) x, (const float*) a, (const float*) b, n * 4);
+#endif // LA_SSE2
+}
+
+LADEF void v3fa_len_n(float *out, const V3fa *a, size_t n)
+{
+    size_t i = 0;
+#if LA_SSE2
+    for (; i < (n & ~(size_t) 3); i += 4) {
+        __m128 vx = _mm_load_ps(&a[i].x);
+        __m128 vy = _mm_load_ps(&a[i + 1].x);
+        __m128 vz = _mm_load_ps(&a[i + 2].x);
+        __m128 vw = _mm_load_ps(&a[i + 3].x);
+        _MM_TRANSPOSE4_PS(vx, vy, vz, vw);
+        (void) vw;
+        __m128 s = _mm_mul_ps(vx, vx);
+        s = _mm_add_ps(s, _mm_mul_ps(vy, vy));
+        s = _mm_add_ps(s, _mm_mul_ps(vz, vz));
+        _mm_storeu_ps(out + i, _mm_sqrt_ps(s));
+    }
+#endif // LA_SSE2
+    for (; i < n; ++i) {
+        out[i] = v3fa_len(a[i]);
+    }
+}
+
+LADEF V4fa v4fa(float x, float y, float z, float w)
+{
+    V4fa v;
+    v.x = x;
+    v.y = y;
+    v.z = z;
+    v.w = w;
+    return v;
+}
+
+LADEF V4fa v4faf(float x)
+{
+    return v4fa(x, x, x, x);
+}
+
+LADEF V4fa v4fa4f(V4f a)
+{
+    return v4fa(a.x, a.y, a.z, a.w);
+}
+
+LADEF V4f v4f4fa(V4fa a)
+{
+    return v4f(a.x, a.y, a.z, a.w);
+}
+
+LADEF V4fa v4fa_sum(V4fa a, V4fa b)
+{
+#if LA_SSE2
+    return la_store4fa(_mm_add_ps(la_load4fa(a), la_load4fa(b)));
+#else
+    a.x += b.x;
+    a.y += b.y;
+    a.z += b.z;
+    a.w += b.w;
+    return a;
+#endif // LA_SSE2
+}
+
+LADEF V4fa v4fa_sub(V4fa a, V4fa b)
+{
+#if LA_SSE2
+    return la_store4fa(_mm_sub_ps(la_load4fa(a), la_load4fa(b)));
+#else
+    a.x -= b.x;
+    a.y -= b.y;
+    a.z -= b.z;
+    a.w -= b.w;
+    return a;
+#endif // LA_SSE2
+}
+
+LADEF V4fa v4fa_mul(V4fa a, V4fa b)
+{
+#if LA_SSE2
+    return la_store4fa(_mm_mul_ps(la_load4fa(a), la_load4fa(b)));
+#else
+    a.x *= b.x;
+    a.y *= b.y;
+    a.z *= b.z;
+    a.w *= b.w;
+    return a;
+#endif // LA_SSE2
+}
+
+LADEF V4fa v4fa_div(V4fa a, V4fa b)
+{
+#if LA_SSE2
+    return la_store4fa(_mm_div_ps(la_load4fa(a), la_load4fa(b)));
+#else
+    a.x /= b.x;
+    a.y /= b.y;
+    a.z /= b.z;
+    a.w /= b.w;
+    return a;
+#endif // LA_SSE2
+}
+
+LADEF V4fa v4fa_sqrt(V4fa a)
+{
+#if LA_SSE2
+    return la_store4fa(_mm_sqrt_ps(la_load4fa(a)));
+#else
+    a.x = sqrtf(a.x);
+    a.y = sqrtf(a.y);
+    a.z = sqrtf(a.z);
+    a.w = sqrtf(a.w);
+    return a;
+#endif // LA_SSE2
+}
+
+LADEF V4fa v4fa_pow(V4fa base, V4fa exp)
+{
+    base.x = powf(base.x, exp.x);
+    base.y = powf(base.y, exp.y);
+    base.z = powf(base.z, exp.z);
+    base.w = powf(base.w, exp.w);
+    return base;
+}
+
+LADEF V4fa v4fa_sin(V4fa a)
+{
+    a.x = sinf(a.x);
+    a.y = sinf(a.y);
+    a.z = sinf(a.z);
+    a.w = sinf(a.w);
+    return a;
+}
+
+LADEF V4fa v4fa_cos(V4fa a)
+{
+    a.x = cosf(a.x);
+    a.y = cosf(a.y);
+    a.z = cosf(a.z);
+    a.w = cosf(a.w);
+    return a;
+}
+
+LADEF V4fa v4fa_min(V4fa a, V4fa b)
+{
+#if LA_SSE2
+    return la_store4fa(la_fmin_ps(la_load4fa(a), la_load4fa(b)));
+#else
+    a.x = fminf(a.x, b.x);
+    a.y = fminf(a.y, b.y);
+    a.z = fminf(a.z, b.z);
+    a.w = fminf(a.w, b.w);
+    return a;
+#endif // LA_SSE2
+}
+
+LADEF V4fa v4fa_max(V4fa a, V4fa b)
+{
+#if LA_SSE2
+    return la_store4fa(la_fmax_ps(la_load4fa(a), la_load4fa(b)));
+#else
+    a.x = fmaxf(a.x, b.x);
+    a.y = fmaxf(a.y, b.y);
+    a.z = fmaxf(a.z, b.z);
+    a.w = fmaxf(a.w, b.w);
+    return a;
+#endif // LA_SSE2
+}
+
+LADEF V4fa v4fa_lerp(V4fa a, V4fa b, V4fa t)
+{
+#if LA_SSE2
+    __m128 va = la_load4fa(a);
+    return la_store4fa(_mm_add_ps(va, _mm_mul_ps(_mm_sub_ps(la_load4fa(b), va), la_load4fa(t))));
+#else
+    a.x = lerpf(a.x, b.x, t.x);
+    a.y = lerpf(a.y, b.y, t.y);
+    a.z = lerpf(a.z, b.z, t.z);
+    a.w = lerpf(a.w, b.w, t.w);
+    return a;
+#endif // LA_SSE2
+}
+
+LADEF V4fa v4fa_floor(V4fa a)
+{
+#if LA_SSE41
+    return la_store4fa(_mm_floor_ps(la_load4fa(a)));
+#else
+    a.x = floorf(a.x);
+    a.y = floorf(a.y);
+    a.z = floorf(a.z);
+    a.w = floorf(a.w);
+    return a;
+#endif // LA_SSE41
+}
+
+LADEF V4fa v4fa_ceil(V4fa a)
+{
+#if LA_SSE41
+    return la_store4fa(_mm_ceil_ps(la_load4fa(a)));
+#else
+    a.x = ceilf(a.x);
+    a.y = ceilf(a.y);
+    a.z = ceilf(a.z);
+    a.w = ceilf(a.w);
+    return a;
+#endif // LA_SSE41
+}
+
+LADEF V4fa v4fa_clamp(V4fa x, V4fa a, V4fa b)
+{
+#if LA_SSE2
+    return la_store4fa(la_fmin_ps(la_fmax_ps(la_load4fa(a), la_load4fa(x)), la_load4fa(b)));
+#else
+    x.x = clampf(x.x, a.x, b.x);
+    x.y = clampf(x.y, a.y, b.y);
+    x.z = clampf(x.z, a.z, b.z);
+    x.w = clampf(x.w, a.w, b.w);
+    return x;
+#endif // LA_SSE2
+}
+
+LADEF float v4fa_sqrlen(V4fa a)
+{
+    return a.x*a.x + a.y*a.y + a.z*a.z + a.w*a.w;
+}
+
+LADEF float v4fa_len(V4fa a)
+{
+    return sqrtf(v4fa_sqrlen(a));
+}
+
+LADEF void v4fa_sum_n(V4fa *out, const V4fa *a, const V4fa *b, size_t n)
+{
+#if LA_SSE2
+    for (size_t i = 0; i < n; ++i) {
+        _mm_store_ps(&out[i].x, _mm_add_ps(_mm_load_ps(&a[i].x), _mm_load_ps(&b[i].x)));
+    }
+#else
+    floats_sum_n((float*) out, (const float*) a, (const float*) b, n * 4);
+#endif // LA_SSE2
+}
+
+LADEF void v4fa_sub_n(V4fa *out, const V4fa *a, const V4fa *b, size_t n)
+{
+#if LA_SSE2
+    for (size_t i = 0; i < n; ++i) {
+        _mm_store_ps(&out[i].x, _mm_sub_ps(_mm_load_ps(&a[i].x), _mm_load_ps(&b[i].x)));
+    }
+#else
+    floats_sub_n((float*) out, (const float*) a, (const float*) b, n * 4);
+#endif // LA_SSE2
+}
+
+LADEF void v4fa_mul_n(V4fa *out, const V4fa *a, const V4fa *b, size_t n)
+{
+#if LA_SSE2
+    for (size_t i = 0; i < n; ++i) {
+        _mm_store_ps(&out[i].x, _mm_mul_ps(_mm_load_ps(&a[i].x), _mm_load_ps(&b[i].x)));
+    }
+#else
+    floats_mul_n((float*) out, (const float*) a, (const float*) b, n * 4);
+#endif // LA_SSE2
+}
+
+LADEF void v4fa_div_n(V4fa *out, const V4fa *a, const V4fa *b, size_t n)
+{
+#if LA_SSE2
+    for (size_t i = 0; i < n; ++i) {
+        _mm_store_ps(&out[i].x, _mm_div_ps(_mm_load_ps(&a[i].x), _mm_load_ps(&b[i].x)));
+    }
+#else
+    floats_div_n((float*) out, (const float*) a, (const float*) b, n * 4);
+#endif // LA_SSE2
+}
+
+LADEF void v4fa_sqrt_n(V4fa *out, const V4fa *a, size_t n)
+{
+#if LA_SSE2
+    for (size_t i = 0; i < n; ++i) {
+        _mm_store_ps(&out[i].x, _mm_sqrt_ps(_mm_load_ps(&a[i].x)));
+    }
+#else
+    floats_sqrt_n((float*) out, (const float*) a, n * 4);
+#endif // LA_SSE2
+}
+
+LADEF void v4fa_min_n(V4fa *out, const V4fa *a, const V4fa *b, size_t n)
+{
+#if LA_SSE2
+    for (size_t i = 0; i < n; ++i) {
+        _mm_store_ps(&out[i].x, la_fmin_ps(_mm_load_ps(&a[i].x), _mm_load_ps(&b[i].x)));
+    }
+#else
+    floats_min_n((float*) out, (const float*) a, (const float*) b, n * 4);
+#endif // LA_SSE2
+}
+
+LADEF void v4fa_max_n(V4fa *out, const V4fa *a, const V4fa *b, size_t n)
+{
+#if LA_SSE2
+    for (size_t i = 0; i < n; ++i) {
+        _mm_store_ps(&out[i].x, la_fmax_ps(_mm_load_ps(&a[i].x), _mm_load_ps(&b[i].x)));
+    }
+#else
+    floats_max_n((float*) out, (const float*) a, (const float*) b, n * 4);
+#endif // LA_SSE2
+}
+
+LADEF void v4fa_lerp_n(V4fa *out, const V4fa *a, const V4fa *b, const V4fa *t, size_t n)
+{
+#if LA_SSE2
+    for (size_t i = 0; i < n; ++i) {
+        __m128 va = _mm_load_ps(&a[i].x);
+        _mm_store_ps(&out[i].x, _mm_add_ps(va, _mm_mul_ps(_mm_sub_ps(_mm_load_ps(&b[i].x), va), _mm_load_ps(&t[i].x))));
+    }
+#else
+    floats_lerp_n((float*) out, (const float*) a, (const float*) b, (const float*) t, n * 4);
+#endif // LA_SSE2
+}
+
+LADEF void v4fa_clamp_n(V4fa *out, const V4fa *x, const V4fa *a, const V4fa *b, size_t n)
+{
+#if LA_SSE2
+    for (size_t i = 0; i < n; ++i) {
+        _mm_store_ps(&out[i].x, la_fmin_ps(la_fmax_ps(_mm_load_ps(&a[i].x), _mm_load_ps(&x[i].x)), _mm_load_ps(&b[i].x)));
+    }
+#else
+    floats_clamp_n((float*) out, (const float*) x, (const float*) a, (const float*) b, n * 4);
+#endif // LA_SSE2
+}
+
+LADEF void v4fa_len_n(float *out, const V4fa *a, size_t n)
+{
+    size_t i = 0;
+#if LA_SSE2
+    for (; i < (n & ~(size_t) 3); i += 4) {
+        __m128 vx = _mm_load_ps(&a[i].x);
+        __m128 vy = _mm_load_ps(&a[i + 1].x);
+        __m128 vz = _mm_load_ps(&a[i + 2].x);
+        __m128 vw = _mm_load_ps(&a[i + 3].x);
+        _MM_TRANSPOSE4_PS(vx, vy, vz, vw);
+        __m128 s = _mm_mul_ps(vx, vx);
+        s = _mm_add_ps(s, _mm_mul_ps(vy, vy));
+        s = _mm_add_ps(s, _mm_mul_ps(vz, vz));
+        s = _mm_add_ps(s, _mm_mul_ps(vw, vw));
+        _mm_storeu_ps(out + i, _mm_sqrt_ps(s));
+    }
+#endif // LA_SSE2
+    for (; i < n; ++i) {
+        out[i] = v4fa_len(a[i]);
+    }
+}
+
+LADEF V3da v3da(double x, double y, double z)
+{
+    V3da v;
+    v.x = x;
+    v.y = y;
+    v.z = z;
+    v.pad = 0;
+    return v;
+}
+
+LADEF V3da v3dad(double x)
+{
+    return v3da(x, x, x);
+}
+
+LADEF V3da v3da3d(V3d a)
+{
+    return v3da(a.x, a.y, a.z);
+}
+
+LADEF V3d v3d3da(V3da a)
+{
+    return v3d(a.x, a.y, a.z);
+}
+
+LADEF V3da v3da_sum(V3da a, V3da b)
+{
+#if LA_AVX
+    return la_store3da(_mm256_add_pd(la_load3da(a), la_load3da(b)));
+#else
+    a.x += b.x;
+    a.y += b.y;
+    a.z += b.z;
+    return a;
+#endif // LA_AVX
+}
+
+LADEF V3da v3da_sub(V3da a, V3da b)
+{
+#if LA_AVX
+    return la_store3da(_mm256_sub_pd(la_load3da(a), la_load3da(b)));
+#else
+    a.x -= b.x;
+    a.y -= b.y;
+    a.z -= b.z;
+    return a;
+#endif // LA_AVX
+}
+
+LADEF V3da v3da_mul(V3da a, V3da b)
+{
+#if LA_AVX
+    return la_store3da(_mm256_mul_pd(la_load3da(a), la_load3da(b)));
+#else
+    a.x *= b.x;
+    a.y *= b.y;
+    a.z *= b.z;
+    return a;
+#endif // LA_AVX
+}
+
+LADEF V3da v3da_div(V3da a, V3da b)
+{
+#if LA_AVX
+    return la_store3da(_mm256_div_pd(la_load3da(a), la_load3da(b)));
+#else
+    a.x /= b.x;
+    a.y /= b.y;
+    a.z /= b.z;
+    return a;
+#endif // LA_AVX
+}
+
+LADEF V3da v3da_sqrt(V3da a)
+{
+#if LA_AVX
+    return la_store3da(_mm256_sqrt_pd(la_load3da(a)));
+#else
+    a.x = sqrt(a.x);
+    a.y = sqrt(a.y);
+    a.z = sqrt(a.z);
+    return a;
+#endif // LA_AVX
+}
+
+LADEF V3da v3da_pow(V3da base, V3da exp)
+{
+    base.x = pow(base.x, exp.x);
+    base.y = pow(base.y, exp.y);
+    base.z = pow(base.z, exp.z);
+    return base;
+}
+
+LADEF V3da v3da_sin(V3da a)
+{
+    a.x = sin(a.x);
+    a.y = sin(a.y);
+    a.z = sin(a.z);
+    return a;
+}
+
+LADEF V3da v3da_cos(V3da a)
+{
+    a.x = cos(a.x);
+    a.y = cos(a.y);
+    a.z = cos(a.z);
+    return a;
+}
+
+LADEF V3da v3da_min(V3da a, V3da b)
+{
+#if LA_AVX
+    return la_store3da(la_fmin_pd(la_load3da(a), la_load3da(b)));
+#else
+    a.x = fmin(a.x, b.x);
+    a.y = fmin(a.y, b.y);
+    a.z = fmin(a.z, b.z);
+    return a;
+#endif // LA_AVX
+}
+
+LADEF V3da v3da_max(V3da a, V3da b)
+{
+#if LA_AVX
+    return la_store3da(la_fmax_pd(la_load3da(a), la_load3da(b)));
+#else
+    a.x = fmax(a.x, b.x);
+    a.y = fmax(a.y, b.y);
+    a.z = fmax(a.z, b.z);
+    return a;
+#endif // LA_AVX
+}
+
+LADEF V3da v3da_lerp(V3da a, V3da b, V3da t)
+{
+#if LA_AVX
+    __m256d va = la_load3da(a);
+    return la_store3da(_mm256_add_pd(va, _mm256_mul_pd(_mm256_sub_pd(la_load3da(b), va), la_load3da(t))));
+#else
+    a.x = lerp(a.x, b.x, t.x);
+    a.y = lerp(a.y, b.y, t.y);
+    a.z = lerp(a.z, b.z, t.z);
+    return a;
+#endif // LA_AVX
+}
+
+LADEF V3da v3da_floor(V3da a)
+{
+#if LA_AVX
+    return la_store3da(_mm256_floor_pd(la_load3da(a)));
+#else
+    a.x = floor(a.x);
+    a.y = floor(a.y);
+    a.z = floor(a.z);
+    return a;
+#endif // LA_AVX
+}
+
+LADEF V3da v3da_ceil(V3da a)
+{
+#if LA_AVX
+    return la_store3da(_mm256_ceil_pd(la_load3da(a)));
+#else
+    a.x = ceil(a.x);
+    a.y = ceil(a.y);
+    a.z = ceil(a.z);
+    return a;
+#endif // LA_AVX
+}
+
+LADEF V3da v3da_clamp(V3da x, V3da a, V3da b)
+{
+#if LA_AVX
+    return la_store3da(la_fmin_pd(la_fmax_pd(la_load3da(a), la_load3da(x)), la_load3da(b)));
+#else
+    x.x = clampd(x.x, a.x, b.x);
+    x.y = clampd(x.y, a.y, b.y);
+    x.z = clampd(x.z, a.z, b.z);
+    return x;
+#endif // LA_AVX
+}
+
+LADEF double v3da_sqrlen(V3da a)
+{
+    return a.x*a.x + a.y*a.y + a.z*a.z;
+}
+
+LADEF double v3da_len(V3da a)
+{
+    return sqrt(v3da_sqrlen(a));
+}
+
+LADEF void v3da_sum_n(V3da *out, const V3da *a, const V3da *b, size_t n)
+{
+#if LA_AVX
+    for (size_t i = 0; i < n; ++i) {
+        _mm256_storeu_pd(&out[i].x, _mm256_add_pd(_mm256_loadu_pd(&a[i].x), _mm256_loadu_pd(&b[i].x)));
+    }
+#elif LA_SSE2
+    for (size_t i = 0; i < n; ++i) {
+        _mm_store_pd(&out[i].x, _mm_add_pd(_mm_load_pd(&a[i].x), _mm_load_pd(&b[i].x)));
+        _mm_store_pd(&out[i].z, _mm_add_pd(_mm_load_pd(&a[i].z), _mm_load_pd(&b[i].z)));
+    }
+#else
+    doubles_sum_n((double*) out, (const double*) a, (const double*) b, n * 4);
+#endif // LA_AVX
+}
+
+LADEF void v3da_sub_n(V3da *out, const V3da *a, const V3da *b, size_t n)
+{
+#if LA_AVX
+    for (size_t i = 0; i < n; ++i) {
+        _mm256_storeu_pd(&out[i].x, _mm256_sub_pd(_mm256_loadu_pd(&a[i].x), _mm256_loadu_pd(&b[i].x)));
+    }
+#elif LA_SSE2
+    for (size_t i = 0; i < n; ++i) {
+        _mm_store_pd(&out[i].x, _mm_sub_pd(_mm_load_pd(&a[i].x), _mm_load_pd(&b[i].x)));
+        _mm_store_pd(&out[i].z, _mm_sub_pd(_mm_load_pd(&a[i].z), _mm_load_pd(&b[i].z)));
+    }
+#else
+    doubles_sub_n((double*) out, (const double*) a, (const double*) b, n * 4);
+#endif // LA_AVX
+}
+
+LADEF void v3da_mul_n(V3da *out, const V3da *a, const V3da *b, size_t n)
+{
+#if LA_AVX
+    for (size_t i = 0; i < n; ++i) {
+        _mm256_storeu_pd(&out[i].x, _mm256_mul_pd(_mm256_loadu_pd(&a[i].x), _mm256_loadu_pd(&b[i].x)));
+    }
+#elif LA_SSE2
+    for (size_t i = 0; i < n; ++i) {
+        _mm_store_pd(&out[i].x, _mm_mul_pd(_mm_load_pd(&a[i].x), _mm_load_pd(&b[i].x)));
+        _mm_store_pd(&out[i].z, _mm_mul_pd(_mm_load_pd(&a[i].z), _mm_load_pd(&b[i].z)));
+    }
+#else
+    doubles_mul_n((double*) out, (const double*) a, (const double*) b, n * 4);
+#endif // LA_AVX
+}
+
+LADEF void v3da_div_n(V3da *out, const V3da *a, const V3da *b, size_t n)
+{
+#if LA_AVX
+    for (size_t i = 0; i < n; ++i) {
+        _mm256_storeu_pd(&out[i].x, _mm256_div_pd(_mm256_loadu_pd(&a[i].x), _mm256_loadu_pd(&b[i].x)));
+    }
+#elif LA_SSE2
+    for (size_t i = 0; i < n; ++i) {
+        _mm_store_pd(&out[i].x, _mm_div_pd(_mm_load_pd(&a[i].x), _mm_load_pd(&b[i].x)));
+        _mm_store_pd(&out[i].z, _mm_div_pd(_mm_load_pd(&a[i].z), _mm_load_pd(&b[i].z)));
+    }
+#else
+    doubles_div_n((double*) out, (const double*) a, (const double*) b, n * 4);
+#endif // LA_AVX
+}
+
+LADEF void v3da_sqrt_n(V3da *out, const V3da *a, size_t n)
+{
+#if LA_AVX
+    for (size_t i = 0; i < n; ++i) {
+        _mm256_storeu_pd(&out[i].x, _mm256_sqrt_pd(_mm256_loadu_pd(&a[i].x)));
+    }
+#elif LA_SSE2
+    for (size_t i = 0; i < n; ++i) {
+        _mm_store_pd(&out[i].x, _mm_sqrt_pd(_mm_load_pd(&a[i].x)));
+        _mm_store_pd(&out[i].z, _mm_sqrt_pd(_mm_load_pd(&a[i].z)));
+    }
+#else
+    doubles_sqrt_n((double*) out, (const double*) a, n * 4);
+#endif // LA_AVX
+}
+
+LADEF void v3da_min_n(V3da *out, const V3da *a, const V3da *b, size_t n)
+{
+#if LA_AVX
+    for (size_t i = 0; i < n; ++i) {
+        _mm256_storeu_pd(&out[i].x, la_fmin_pd(_mm256_loadu_pd(&a[i].x), _mm256_loadu_pd(&b[i].x)));
+    }
+#elif LA_SSE2
+    for (size_t i = 0; i < n; ++i) {
+        _mm_store_pd(&out[i].x, la_fmin_pd128(_mm_load_pd(&a[i].x), _mm_load_pd(&b[i].x)));
+        _mm_store_pd(&out[i].z, la_fmin_pd128(_mm_load_pd(&a[i].z), _mm_load_pd(&b[i].z)));
+    }
+#else
+    doubles_min_n((double*) out, (const double*) a, (const double*) b, n * 4);
+#endif // LA_AVX
+}
+
+LADEF void v3da_max_n(V3da *out, const V3da *a, const V3da *b, size_t n)
+{
+#if LA_AVX
+    for (size_t i = 0; i < n; ++i) {
+        _mm256_storeu_pd(&out[i].x, la_fmax_pd(_mm256_loadu_pd(&a[i].x), _mm256_loadu_pd(&b[i].x)));
+    }
+#elif LA_SSE2
+    for (size_t i = 0; i < n; ++i) {
+        _mm_store_pd(&out[i].x, la_fmax_pd128(_mm_load_pd(&a[i].x), _mm_load_pd(&b[i].x)));
+        _mm_store_pd(&out[i].z, la_fmax_pd128(_mm_load_pd(&a[i].z), _mm_load_pd(&b[i].z)));
+    }
+#else
+    doubles_max_n((double*) out, (const double*) a, (const double*) b, n * 4);
+#endif // LA_AVX
+}
+
+LADEF void v3da_lerp_n(V3da *out, const V3da *a, const V3da *b, const V3da *t, size_t n)
+{
+#if LA_AVX
+    for (size_t i = 0; i < n; ++i) {
+        __m256d va = _mm256_loadu_pd(&a[i].x);
+        _mm256_storeu_pd(&out[i].x, _mm256_add_pd(va, _mm256_mul_pd(_mm256_sub_pd(_mm256_loadu_pd(&b[i].x), va), _mm256_loadu_pd(&t[i].x))));
+    }
+#elif LA_SSE2
+    for (size_t i = 0; i < n; ++i) {
+        __m128d lo = _mm_load_pd(&a[i].x);
+        __m128d hi = _mm_load_pd(&a[i].z);
+        _mm_store_pd(&out[i].x, _mm_add_pd(lo, _mm_mul_pd(_mm_sub_pd(_mm_load_pd(&b[i].x), lo), _mm_load_pd(&t[i].x))));
+        _mm_store_pd(&out[i].z, _mm_add_pd(hi, _mm_mul_pd(_mm_sub_pd(_mm_load_pd(&b[i].z), hi), _mm_load_pd(&t[i].z))));
+    }
+#else
+    doubles_lerp_n((double*) out, (const double*) a, (const double*) b, (const double*) t, n * 4);
+#endif // LA_AVX
+}
+
+LADEF void v3da_clamp_n(V3da *out, const V3da *x, const V3da *a, const V3da *b, size_t n)
+{
+#if LA_AVX
+    for (size_t i = 0; i < n; ++i) {
+        _mm256_storeu_pd(&out[i].x, la_fmin_pd(la_fmax_pd(_mm256_loadu_pd(&a[i].x), _mm256_loadu_pd(&x[i].x)), _mm256_loadu_pd(&b[i].x)));
+    }
+#elif LA_SSE2
+    for (size_t i = 0; i < n; ++i) {
+        _mm_store_pd(&out[i].x, la_fmin_pd128(la_fmax_pd128(_mm_load_pd(&a[i].x), _mm_load_pd(&x[i].x)), _mm_load_pd(&b[i].x)));
+        _mm_store_pd(&out[i].z, la_fmin_pd128(la_fmax_pd128(_mm_load_pd(&a[i].z), _mm_load_pd(&x[i].z)), _mm_load_pd(&b[i].z)));
+    }
+#else
+    doubles_clamp_n((double*) out, (const double*) x, (const double*) a, (const double*) b, n * 4);
+#endif // LA_AVX
+}
+
+LADEF void v3da_len_n(double *out, const V3da *a, size_t n)
+{
+    size_t i = 0;
+#if LA_AVX
+    for (; i < (n & ~(size_t) 3); i += 4) {
+        __m256d r0 = _mm256_loadu_pd(&a[i].x);
+        __m256d r1 = _mm256_loadu_pd(&a[i + 1].x);
+        __m256d r2 = _mm256_loadu_pd(&a[i + 2].x);
+        __m256d r3 = _mm256_loadu_pd(&a[i + 3].x);
+        // x0 x1 z0 z1, y0 y1 w0 w1, x2 x3 z2 z3, y2 y3 w2 w3
+        __m256d t0 = _mm256_unpacklo_pd(r0, r1);
+        __m256d t1 = _mm256_unpackhi_pd(r0, r1);
+        __m256d t2 = _mm256_unpacklo_pd(r2, r3);
+        __m256d t3 = _mm256_unpackhi_pd(r2, r3);
+        __m256d vx = _mm256_permute2f128_pd(t0, t2, 0x20);
+        __m256d vy = _mm256_permute2f128_pd(t1, t3, 0x20);
+        __m256d vz = _mm256_permute2f128_pd(t0, t2, 0x31);
+        __m256d s = _mm256_mul_pd(vx, vx);
+        s = _mm256_add_pd(s, _mm256_mul_pd(vy, vy));
+        s = _mm256_add_pd(s, _mm256_mul_pd(vz, vz));
+        _mm256_storeu_pd(out + i, _mm256_sqrt_pd(s));
+    }
+#endif // LA_AVX
+    for (; i < n; ++i) {
+        out[i] = v3da_len(a[i]);
+    }
+}
+
+LADEF V4da v4da(double x, double y, double z, double w)
+{
+    V4da v;
+    v.x = x;
+    v.y = y;
+    v.z = z;
+    v.w = w;
+    return v;
+}
+
+LADEF V4da v4dad(double x)
+{
+    return v4da(x, x, x, x);
+}
+
+LADEF V4da v4da4d(V4d a)
+{
+    return v4da(a.x, a.y, a.z, a.w);
+}
+
+LADEF V4d v4d4da(V4da a)
+{
+    return v4d(a.x, a.y, a.z, a.w);
+}
+
+LADEF V4da v4da_sum(V4da a, V4da b)
+{
+#if LA_AVX
+    return la_store4da(_mm256_add_pd(la_load4da(a), la_load4da(b)));
+#else
+    a.x += b.x;
+    a.y += b.y;
+    a.z += b.z;
+    a.w += b.w;
+    return a;
+#endif // LA_AVX
+}
+
+LADEF V4da v4da_sub(V4da a, V4da b)
+{
+#if LA_AVX
+    return la_store4da(_mm256_sub_pd(la_load4da(a), la_load4da(b)));
+#else
+    a.x -= b.x;
+    a.y -= b.y;
+    a.z -= b.z;
+    a.w -= b.w;
+    return a;
+#endif // LA_AVX
+}
+
+LADEF V4da v4da_mul(V4da a, V4da b)
+{
+#if LA_AVX
+    return la_store4da(_mm256_mul_pd(la_load4da(a), la_load4da(b)));
+#else
+    a.x *= b.x;
+    a.y *= b.y;
+    a.z *= b.z;
+    a.w *= b.w;
+    return a;
+#endif // LA_AVX
+}
+
+LADEF V4da v4da_div(V4da a, V4da b)
+{
+#if LA_AVX
+    return la_store4da(_mm256_div_pd(la_load4da(a), la_load4da(b)));
+#else
+    a.x /= b.x;
+    a.y /= b.y;
+    a.z /= b.z;
+    a.w /= b.w;
+    return a;
+#endif // LA_AVX
+}
+
+LADEF V4da v4da_sqrt(V4da a)
+{
+#if LA_AVX
+    return la_store4da(_mm256_sqrt_pd(la_load4da(a)));
+#else
+    a.x = sqrt(a.x);
+    a.y = sqrt(a.y);
+    a.z = sqrt(a.z);
+    a.w = sqrt(a.w);
+    return a;
+#endif // LA_AVX
+}
+
+LADEF V4da v4da_pow(V4da base, V4da exp)
+{
+    base.x = pow(base.x, exp.x);
+    base.y = pow(base.y, exp.y);
+    base.z = pow(base.z, exp.z);
+    base.w = pow(base.w, exp.w);
+    return base;
+}
+
+LADEF V4da v4da_sin(V4da a)
+{
+    a.x = sin(a.x);
+    a.y = sin(a.y);
+    a.z = sin(a.z);
+    a.w = sin(a.w);
+    return a;
+}
+
+LADEF V4da v4da_cos(V4da a)
+{
+    a.x = cos(a.x);
+    a.y = cos(a.y);
+    a.z = cos(a.z);
+    a.w = cos(a.w);
+    return a;
+}
+
+LADEF V4da v4da_min(V4da a, V4da b)
+{
+#if LA_AVX
+    return la_store4da(la_fmin_pd(la_load4da(a), la_load4da(b)));
+#else
+    a.x = fmin(a.x, b.x);
+    a.y = fmin(a.y, b.y);
+    a.z = fmin(a.z, b.z);
+    a.w = fmin(a.w, b.w);
+    return a;
+#endif // LA_AVX
+}
+
+LADEF V4da v4da_max(V4da a, V4da b)
+{
+#if LA_AVX
+    return la_store4da(la_fmax_pd(la_load4da(a), la_load4da(b)));
+#else
+    a.x = fmax(a.x, b.x);
+    a.y = fmax(a.y, b.y);
+    a.z = fmax(a.z, b.z);
+    a.w = fmax(a.w, b.w);
+    return a;
+#endif // LA_AVX
+}
+
+LADEF V4da v4da_lerp(V4da a, V4da b, V4da t)
+{
+#if LA_AVX
+    __m256d va = la_load4da(a);
+    return la_store4da(_mm256_add_pd(va, _mm256_mul_pd(_mm256_sub_pd(la_load4da(b), va), la_load4da(t))));
+#else
+    a.x = lerp(a.x, b.x, t.x);
+    a.y = lerp(a.y, b.y, t.y);
+    a.z = lerp(a.z, b.z, t.z);
+    a.w = lerp(a.w, b.w, t.w);
+    return a;
+#endif // LA_AVX
+}
+
+LADEF V4da v4da_floor(V4da a)
+{
+#if LA_AVX
+    return la_store4da(_mm256_floor_pd(la_load4da(a)));
+#else
+    a.x = floor(a.x);
+    a.y = floor(a.y);
+    a.z = floor(a.z);
+    a.w = floor(a.w);
+    return a;
+#endif // LA_AVX
+}
+
+LADEF V4da v4da_ceil(V4da a)
+{
+#if LA_AVX
+    return la_store4da(_mm256_ceil_pd(la_load4da(a)));
+#else
+    a.x = ceil(a.x);
+    a.y = ceil(a.y);
+    a.z = ceil(a.z);
+    a.w = ceil(a.w);
+    return a;
+#endif // LA_AVX
+}
+
+LADEF V4da v4da_clamp(V4da x, V4da a, V4da b)
+{
+#if LA_AVX
+    return la_store4da(la_fmin_pd(la_fmax_pd(la_load4da(a), la_load4da(x)), la_load4da(b)));
+#else
+    x.x = clampd(x.x, a.x, b.x);
+    x.y = clampd(x.y, a.y, b.y);
+    x.z = clampd(x.z, a.z, b.z);
+    x.w = clampd(x.w, a.w, b.w);
+    return x;
+#endif // LA_AVX
+}
+
+LADEF double v4da_sqrlen(V4da a)
+{
+    return a.x*a.x + a.y*a.y + a.z*a.z + a.w*a.w;
+}
+
+LADEF double v4da_len(V4da a)
+{
+    return sqrt(v4da_sqrlen(a));
+}
+
+LADEF void v4da_sum_n(V4da *out, const V4da *a, const V4da *b, size_t n)
+{
+#if LA_AVX
+    for (size_t i = 0; i < n; ++i) {
+        _mm256_storeu_pd(&out[i].x, _mm256_add_pd(_mm256_loadu_pd(&a[i].x), _mm256_loadu_pd(&b[i].x)));
+    }
+#elif LA_SSE2
+    for (size_t i = 0; i < n; ++i) {
+        _mm_store_pd(&out[i].x, _mm_add_pd(_mm_load_pd(&a[i].x), _mm_load_pd(&b[i].x)));
+        _mm_store_pd(&out[i].z, _mm_add_pd(_mm_load_pd(&a[i].z), _mm_load_pd(&b[i].z)));
+    }
+#else
+    doubles_sum_n((double*) out, (const double*) a, (const double*) b, n * 4);
+#endif // LA_AVX
+}
+
+LADEF void v4da_sub_n(V4da *out, const V4da *a, const V4da *b, size_t n)
+{
+#if LA_AVX
+    for (size_t i = 0; i < n; ++i) {
+        _mm256_storeu_pd(&out[i].x, _mm256_sub_pd(_mm256_loadu_pd(&a[i].x), _mm256_loadu_pd(&b[i].x)));
+    }
+#elif LA_SSE2
+    for (size_t i = 0; i < n; ++i) {
+        _mm_store_pd(&out[i].x, _mm_sub_pd(_mm_load_pd(&a[i].x), _mm_load_pd(&b[i].x)));
+        _mm_store_pd(&out[i].z, _mm_sub_pd(_mm_load_pd(&a[i].z), _mm_load_pd(&b[i].z)));
+    }
+#else
+    doubles_sub_n((double*) out, (const double*) a, (const double*) b, n * 4);
+#endif // LA_AVX
+}
+
+LADEF void v4da_mul_n(V4da *out, const V4da *a, const V4da *b, size_t n)
+{
+#if LA_AVX
+    for (size_t i = 0; i < n; ++i) {
+        _mm256_storeu_pd(&out[i].x, _mm256_mul_pd(_mm256_loadu_pd(&a[i].x), _mm256_loadu_pd(&b[i].x)));
+    }
+#elif LA_SSE2
+    for (size_t i = 0; i < n; ++i) {
+        _mm_store_pd(&out[i].x, _mm_mul_pd(_mm_load_pd(&a[i].x), _mm_load_pd(&b[i].x)));
+        _mm_store_pd(&out[i].z, _mm_mul_pd(_mm_load_pd(&a[i].z), _mm_load_pd(&b[i].z)));
+    }
+#else
+    doubles_mul_n((double*) out, (const double*) a, (const double*) b, n * 4);
+#endif // LA_AVX
+}
+
+LADEF void v4da_div_n(V4da *out, const V4da *a, const V4da *b, size_t n)
+{
+#if LA_AVX
+    for (size_t i = 0; i < n; ++i) {
+        _mm256_storeu_pd(&out[i].x, _mm256_div_pd(_mm256_loadu_pd(&a[i].x), _mm256_loadu_pd(&b[i].x)));
+    }
+#elif LA_SSE2
+    for (size_t i = 0; i < n; ++i) {
+        _mm_store_pd(&out[i].x, _mm_div_pd(_mm_load_pd(&a[i].x), _mm_load_pd(&b[i].x)));
+        _mm_store_pd(&out[i].z, _mm_div_pd(_mm_load_pd(&a[i].z), _mm_load_pd(&b[i].z)));
+    }
+#else
+    doubles_div_n((double*) out, (const double*) a, (const double*) b, n * 4);
+#endif // LA_AVX
+}
+
+LADEF void v4da_sqrt_n(V4da *out, const V4da *a, size_t n)
+{
+#if LA_AVX
+    for (size_t i = 0; i < n; ++i) {
+        _mm256_storeu_pd(&out[i].x, _mm256_sqrt_pd(_mm256_loadu_pd(&a[i].x)));
+    }
+#elif LA_SSE2
+    for (size_t i = 0; i < n; ++i) {
+        _mm_store_pd(&out[i].x, _mm_sqrt_pd(_mm_load_pd(&a[i].x)));
+        _mm_store_pd(&out[i].z, _mm_sqrt_pd(_mm_load_pd(&a[i].z)));
+    }
+#else
+    doubles_sqrt_n((double*) out, (const double*) a, n * 4);
+#endif // LA_AVX
+}
+
+LADEF void v4da_min_n(V4da *out, const V4da *a, const V4da *b, size_t n)
+{
+#if LA_AVX
+    for (size_t i = 0; i < n; ++i) {
+        _mm256_storeu_pd(&out[i].x, la_fmin_pd(_mm256_loadu_pd(&a[i].x), _mm256_loadu_pd(&b[i].x)));
+    }
+#elif LA_SSE2
+    for (size_t i = 0; i < n; ++i) {
+        _mm_store_pd(&out[i].x, la_fmin_pd128(_mm_load_pd(&a[i].x), _mm_load_pd(&b[i].x)));
+        _mm_store_pd(&out[i].z, la_fmin_pd128(_mm_load_pd(&a[i].z), _mm_load_pd(&b[i].z)));
+    }
+#else
+    doubles_min_n((double*) out, (const double*) a, (const double*) b, n * 4);
+#endif // LA_AVX
+}
+
+LADEF void v4da_max_n(V4da *out, const V4da *a, const V4da *b, size_t n)
+{
+#if LA_AVX
+    for (size_t i = 0; i < n; ++i) {
+        _mm256_storeu_pd(&out[i].x, la_fmax_pd(_mm256_loadu_pd(&a[i].x), _mm256_loadu_pd(&b[i].x)));
+    }
+#elif LA_SSE2
+    for (size_t i = 0; i < n; ++i) {
+        _mm_store_pd(&out[i].x, la_fmax_pd128(_mm_load_pd(&a[i].x), _mm_load_pd(&b[i].x)));
+        _mm_store_pd(&out[i].z, la_fmax_pd128(_mm_load_pd(&a[i].z), _mm_load_pd(&b[i].z)));
+    }
+#else
+    doubles_max_n((double*) out, (const double*) a, (const double*) b, n * 4);
+#endif // LA_AVX
+}
+
+LADEF void v4da_lerp_n(V4da *out, const V4da *a, const V4da *b, const V4da *t, size_t n)
+{
+#if LA_AVX
+    for (size_t i = 0; i < n; ++i) {
+        __m256d va = _mm256_loadu_pd(&a[i].x);
+        _mm256_storeu_pd(&out[i].x, _mm256_add_pd(va, _mm256_mul_pd(_mm256_sub_pd(_mm256_loadu_pd(&b[i].x), va), _mm256_loadu_pd(&t[i].x))));
+    }
+#elif LA_SSE2
+    for (size_t i = 0; i < n; ++i) {
+        __m128d lo = _mm_load_pd(&a[i].x);
+        __m128d hi = _mm_load_pd(&a[i].z);
+        _mm_store_pd(&out[i].x, _mm_add_pd(lo, _mm_mul_pd(_mm_sub_pd(_mm_load_pd(&b[i].x), lo), _mm_load_pd(&t[i].x))));
+        _mm_store_pd(&out[i].z, _mm_add_pd(hi, _mm_mul_pd(_mm_sub_pd(_mm_load_pd(&b[i].z), hi), _mm_load_pd(&t[i].z))));
+    }
+#else
+    doubles_lerp_n((double*) out, (const double*) a, (const double*) b, (const double*) t, n * 4);
+#endif // LA_AVX
+}
+
+LADEF void v4da_clamp_n(V4da *out, const V4da *x, const V4da *a, const V4da *b, size_t n)
+{
+#if LA_AVX
+    for (size_t i = 0; i < n; ++i) {
+        _mm256_storeu_pd(&out[i].x, la_fmin_pd(la_fmax_pd(_mm256_loadu_pd(&a[i].x), _mm256_loadu_pd(&x[i].x)), _mm256_loadu_pd(&b[i].x)));
+    }
+#elif LA_SSE2
+    for (size_t i = 0; i < n; ++i) {
+        _mm_store_pd(&out[i].x, la_fmin_pd128(la_fmax_pd128(_mm_load_pd(&a[i].x), _mm_load_pd(&x[i].x)), _mm_load_pd(&b[i].x)));
+        _mm_store_pd(&out[i].z, la_fmin_pd128(la_fmax_pd128(_mm_load_pd(&a[i].z), _mm_load_pd(&x[i].z)), _mm_load_pd(&b[i].z)));
+    }
+#else
+    doubles_clamp_n((double*) out, (const double*) x, (const double*) a, (const double*) b, n * 4);
+#endif // LA_AVX
+}
+
+LADEF void v4da_len_n(double *out, const V4da *a, size_t n)
+{
+    size_t i = 0;
+#if LA_AVX
+    for (; i < (n & ~(size_t) 3); i += 4) {
+        __m256d r0 = _mm256_loadu_pd(&a[i].x);
+        __m256d r1 = _mm256_loadu_pd(&a[i + 1].x);
+        __m256d r2 = _mm256_loadu_pd(&a[i + 2].x);
+        __m256d r3 = _mm256_loadu_pd(&a[i + 3].x);
+        // x0 x1 z0 z1, y0 y1 w0 w1, x2 x3 z2 z3, y2 y3 w2 w3
+        __m256d t0 = _mm256_unpacklo_pd(r0, r1);
+        __m256d t1 = _mm256_unpackhi_pd(r0, r1);
+        __m256d t2 = _mm256_unpacklo_pd(r2, r3);
+        __m256d t3 = _mm256_unpackhi_pd(r2, r3);
+        __m256d vx = _mm256_permute2f128_pd(t0, t2, 0x20);
+        __m256d vy = _mm256_permute2f128_pd(t1, t3, 0x20);
+        __m256d vz = _mm256_permute2f128_pd(t0, t2, 0x31);
+        __m256d vw = _mm256_permute2f128_pd(t1, t3, 0x31);
+        __m256d s = _mm256_mul_pd(vx, vx);
+        s = _mm256_add_pd(s, _mm256_mul_pd(vy, vy));
+        s = _mm256_add_pd(s, _mm256_mul_pd(vz, vz));
+        s = _mm256_add_pd(s, _mm256_mul_pd(vw, vw));
+        _mm256_storeu_pd(out + i, _mm256_sqrt_pd(s));
+    }
+#endif // LA_AVX
+    for (; i < n; ++i) {
+        out[i] = v4da_len(a[i]);
+    }
+}
+
+LADEF V3ia v3ia(int x, int y, int z)
+{
+    V3ia v;
+    v.x = x;
+    v.y = y;
+    v.z = z;
+    v.pad = 0;
+    return v;
+}
+
+LADEF V3ia v3iai(int x)
+{
+    return v3ia(x, x, x);
+}
+
+LADEF V3ia v3ia3i(V3i a)
+{
+    return v3ia(a.x, a.y, a.z);
+}
+
+LADEF V3i v3i3ia(V3ia a)
+{
+    return v3i(a.x, a.y, a.z);
+}
+
+LADEF V3ia v3ia_sum(V3ia a, V3ia b)
+{
+#if LA_SSE2
+    return la_store3ia(_mm_add_epi32(la_load3ia(a), la_load3ia(b)));
+#else
+    a.x += b.x;
+    a.y += b.y;
+    a.z += b.z;
+    return a;
+#endif // LA_SSE2
+}
+
+LADEF V3ia v3ia_sub(V3ia a, V3ia b)
+{
+#if LA_SSE2
+    return la_store3ia(_mm_sub_epi32(la_load3ia(a), la_load3ia(b)));
+#else
+    a.x -= b.x;
+    a.y -= b.y;
+    a.z -= b.z;
+    return a;
+#endif // LA_SSE2
+}
+
+LADEF V3ia v3ia_mul(V3ia a, V3ia b)
+{
+#if LA_SSE41
+    return la_store3ia(_mm_mullo_epi32(la_load3ia(a), la_load3ia(b)));
+#else
+    a.x *= b.x;
+    a.y *= b.y;
+    a.z *= b.z;
+    return a;
+#endif // LA_SSE41
+}
+
+LADEF V3ia v3ia_div(V3ia a, V3ia b)
+{
+    a.x /= b.x;
+    a.y /= b.y;
+    a.z /= b.z;
+    return a;
+}
+
+LADEF V3ia v3ia_min(V3ia a, V3ia b)
+{
+#if LA_SSE41
+    return la_store3ia(_mm_min_epi32(la_load3ia(a), la_load3ia(b)));
+#else
+    a.x = mini(a.x, b.x);
+    a.y = mini(a.y, b.y);
+    a.z = mini(a.z, b.z);
+    return a;
+#endif // LA_SSE41
+}
+
+LADEF V3ia v3ia_max(V3ia a, V3ia b)
+{
+#if LA_SSE41
+    return la_store3ia(_mm_max_epi32(la_load3ia(a), la_load3ia(b)));
+#else
+    a.x = maxi(a.x, b.x);
+    a.y = maxi(a.y, b.y);
+    a.z = maxi(a.z, b.z);
+    return a;
+#endif // LA_SSE41
+}
+
+LADEF V3ia v3ia_clamp(V3ia x, V3ia a, V3ia b)
+{
+#if LA_SSE41
+    return la_store3ia(_mm_min_epi32(_mm_max_epi32(la_load3ia(a), la_load3ia(x)), la_load3ia(b)));
+#else
+    x.x = clampi(x.x, a.x, b.x);
+    x.y = clampi(x.y, a.y, b.y);
+    x.z = clampi(x.z, a.z, b.z);
+    return x;
+#endif // LA_SSE41
+}
+
+LADEF int v3ia_sqrlen(V3ia a)
+{
+    return a.x*a.x + a.y*a.y + a.z*a.z;
+}
+
+LADEF void v3ia_sum_n(V3ia *out, const V3ia *a, const V3ia *b, size_t n)
+{
+#if LA_SSE2
+    for (size_t i = 0; i < n; ++i) {
+        _mm_store_si128((__m128i*) &out[i], _mm_add_epi32(_mm_load_si128((const __m128i*) &a[i]), _mm_load_si128((const __m128i*) &b[i])));
+    }
+#else
+    ints_sum_n((int*) out, (const int*) a, (const int*) b, n * 4);
+#endif // LA_SSE2
+}
+
+LADEF void v3ia_sub_n(V3ia *out, const V3ia *a, const V3ia *b, size_t n)
+{
+#if LA_SSE2
+    for (size_t i = 0; i < n; ++i) {
+        _mm_store_si128((__m128i*) &out[i], _mm_sub_epi32(_mm_load_si128((const __m128i*) &a[i]), _mm_load_si128((const __m128i*) &b[i])));
+    }
+#else
+    ints_sub_n((int*) out, (const int*) a, (const int*) b, n * 4);
+#endif // LA_SSE2
+}
+
+LADEF void v3ia_mul_n(V3ia *out, const V3ia *a, const V3ia *b, size_t n)
+{
+#if LA_SSE41
+    for (size_t i = 0; i < n; ++i) {
+        _mm_store_si128((__m128i*) &out[i], _mm_mullo_epi32(_mm_load_si128((const __m128i*) &a[i]), _mm_load_si128((const __m128i*) &b[i])));
+    }
+#else
+    ints_mul_n((int*) out, (const int*) a, (const int*) b, n * 4);
+#endif // LA_SSE41
+}
+
+LADEF void v3ia_div_n(V3ia *out, const V3ia *a, const V3ia *b, size_t n)
+{
+    for (size_t i = 0; i < n; ++i) {
+        out[i] = v3ia_div(a[i], b[i]);
+    }
+}
+
+LADEF void v3ia_min_n(V3ia *out, const V3ia *a, const V3ia *b, size_t n)
+{
+#if LA_SSE41
+    for (size_t i = 0; i < n; ++i) {
+        _mm_store_si128((__m128i*) &out[i], _mm_min_epi32(_mm_load_si128((const __m128i*) &a[i]), _mm_load_si128((const __m128i*) &b[i])));
+    }
+#else
+    ints_min_n((int*) out, (const int*) a, (const int*) b, n * 4);
+#endif // LA_SSE41
+}
+
+LADEF void v3ia_max_n(V3ia *out, const V3ia *a, const V3ia *b, size_t n)
+{
+#if LA_SSE41
+    for (size_t i = 0; i < n; ++i) {
+        _mm_store_si128((__m128i*) &out[i], _mm_max_epi32(_mm_load_si128((const __m128i*) &a[i]), _mm_load_si128((const __m128i*) &b[i])));
+    }
+#else
+    ints_max_n((int*) out, (const int*) a, (const int*) b, n * 4);
+#endif // LA_SSE41
+}
+
+LADEF void v3ia_clamp_n(V3ia *out, const V3ia *x, const V3ia *a, const V3ia *b, size_t n)
+{
+#if LA_SSE41
+    for (size_t i = 0; i < n; ++i) {
+        _mm_store_si128((__m128i*) &out[i], _mm_min_epi32(_mm_max_epi32(_mm_load_si128((const __m128i*) &a[i]), _mm_load_si128((const __m128i*) &x[i])), _mm_load_si128((const __m128i*) &b[i])));
+    }
+#else
+    ints_clamp_n((int*) out, (const int*) x, (const int*) a, (const int*) b, n * 4);
+#endif // LA_SSE41
+}
+
+LADEF V4ia v4ia(int x, int y, int z, int w)
+{
+    V4ia v;
+    v.x = x;
+    v.y = y;
+    v.z = z;
+    v.w = w;
+    return v;
+}
+
+LADEF V4ia v4iai(int x)
+{
+    return v4ia(x, x, x, x);
+}
+
+LADEF V4ia v4ia4i(V4i a)
+{
+    return v4ia(a.x, a.y, a.z, a.w);
+}
+
+LADEF V4i v4i4ia(V4ia a)
+{
+    return v4i(a.x, a.y, a.z, a.w);
+}
+
+LADEF V4ia v4ia_sum(V4ia a, V4ia b)
+{
+#if LA_SSE2
+    return la_store4ia(_mm_add_epi32(la_load4ia(a), la_load4ia(b)));
+#else
+    a.x += b.x;
+    a.y += b.y;
+    a.z += b.z;
+    a.w += b.w;
+    return a;
+#endif // LA_SSE2
+}
+
+LADEF V4ia v4ia_sub(V4ia a, V4ia b)
+{
+#if LA_SSE2
+    return la_store4ia(_mm_sub_epi32(la_load4ia(a), la_load4ia(b)));
+#else
+    a.x -= b.x;
+    a.y -= b.y;
+    a.z -= b.z;
+    a.w -= b.w;
+    return a;
+#endif // LA_SSE2
+}
+
+LADEF V4ia v4ia_mul(V4ia a, V4ia b)
+{
+#if LA_SSE41
+    return la_store4ia(_mm_mullo_epi32(la_load4ia(a), la_load4ia(b)));
+#else
+    a.x *= b.x;
+    a.y *= b.y;
+    a.z *= b.z;
+    a.w *= b.w;
+    return a;
+#endif // LA_SSE41
+}
+
+LADEF V4ia v4ia_div(V4ia a, V4ia b)
+{
+    a.x /= b.x;
+    a.y /= b.y;
+    a.z /= b.z;
+    a.w /= b.w;
+    return a;
+}
+
+LADEF V4ia v4ia_min(V4ia a, V4ia b)
+{
+#if LA_SSE41
+    return la_store4ia(_mm_min_epi32(la_load4ia(a), la_load4ia(b)));
+#else
+    a.x = mini(a.x, b.x);
+    a.y = mini(a.y, b.y);
+    a.z = mini(a.z, b.z);
+    a.w = mini(a.w, b.w);
+    return a;
+#endif // LA_SSE41
+}
+
+LADEF V4ia v4ia_max(V4ia a, V4ia b)
+{
+#if LA_SSE41
+    return la_store4ia(_mm_max_epi32(la_load4ia(a), la_load4ia(b)));
+#else
+    a.x = maxi(a.x, b.x);
+    a.y = maxi(a.y, b.y);
+    a.z = maxi(a.z, b.z);
+    a.w = maxi(a.w, b.w);
+    return a;
+#endif // LA_SSE41
+}
+
+LADEF V4ia v4ia_clamp(V4ia x, V4ia a, V4ia b)
+{
+#if LA_SSE41
+    return la_store4ia(_mm_min_epi32(_mm_max_epi32(la_load4ia(a), la_load4ia(x)), la_load4ia(b)));
+#else
+    x.x = clampi(x.x, a.x, b.x);
+    x.y = clampi(x.y, a.y, b.y);
+    x.z = clampi(x.z, a.z, b.z);
+    x.w = clampi(x.w, a.w, b.w);
+    return x;
+#endif // LA_SSE41
+}
+
+LADEF int v4ia_sqrlen(V4ia a)
+{
+    return a.x*a.x + a.y*a.y + a.z*a.z + a.w*a.w;
+}
+
+LADEF void v4ia_sum_n(V4ia *out, const V4ia *a, const V4ia *b, size_t n)
+{
+#if LA_SSE2
+    for (size_t i = 0; i < n; ++i) {
+        _mm_store_si128((__m128i*) &out[i], _mm_add_epi32(_mm_load_si128((const __m128i*) &a[i]), _mm_load_si128((const __m128i*) &b[i])));
+    }
+#else
+    ints_sum_n((int*) out, (const int*) a, (const int*) b, n * 4);
+#endif // LA_SSE2
+}
+
+LADEF void v4ia_sub_n(V4ia *out, const V4ia *a, const V4ia *b, size_t n)
+{
+#if LA_SSE2
+    for (size_t i = 0; i < n; ++i) {
+        _mm_store_si128((__m128i*) &out[i], _mm_sub_epi32(_mm_load_si128((const __m128i*) &a[i]), _mm_load_si128((const __m128i*) &b[i])));
+    }
+#else
+    ints_sub_n((int*) out, (const int*) a, (const int*) b, n * 4);
+#endif // LA_SSE2
+}
+
+LADEF void v4ia_mul_n(V4ia *out, const V4ia *a, const V4ia *b, size_t n)
+{
+#if LA_SSE41
+    for (size_t i = 0; i < n; ++i) {
+        _mm_store_si128((__m128i*) &out[i], _mm_mullo_epi32(_mm_load_si128((const __m128i*) &a[i]), _mm_load_si128((const __m128i*) &b[i])));
+    }
+#else
+    ints_mul_n((int*) out, (const int*) a, (const int*) b, n * 4);
+#endif // LA_SSE41
+}
+
+LADEF void v4ia_div_n(V4ia *out, const V4ia *a, const V4ia *b, size_t n)
+{
+    ints_div_n((int*) out, (const int*) a, (const int*) b, n * 4);
+}
+
+LADEF void v4ia_min_n(V4ia *out, const V4ia *a, const V4ia *b, size_t n)
+{
+#if LA_SSE41
+    for (size_t i = 0; i < n; ++i) {
+        _mm_store_si128((__m128i*) &out[i], _mm_min_epi32(_mm_load_si128((const __m128i*) &a[i]), _mm_load_si128((const __m128i*) &b[i])));
+    }
+#else
+    ints_min_n((int*) out, (const int*) a, (const int*) b, n * 4);
+#endif // LA_SSE41
+}
+
+LADEF void v4ia_max_n(V4ia *out, const V4ia *a, const V4ia *b, size_t n)
+{
+#if LA_SSE41
+    for (size_t i = 0; i < n; ++i) {
+        _mm_store_si128((__m128i*) &out[i], _mm_max_epi32(_mm_load_si128((const __m128i*) &a[i]), _mm_load_si128((const __m128i*) &b[i])));
+    }
+#else
+    ints_max_n((int*) out, (const int*) a, (const int*) b, n * 4);
+#endif // LA_SSE41
+}
+
+LADEF void v4ia_clamp_n(V4ia *out, const V4ia *x, const V4ia *a, const V4ia *b, size_t n)
+{
+#if LA_SSE41
+    for (size_t i = 0; i < n; ++i) {
+        _mm_store_si128((__m128i*) &out[i], _mm_min_epi32(_mm_max_epi32(_mm_load_si128((const __m128i*) &a[i]), _mm_load_si128((const __m128i*) &x[i])), _mm_load_si128((const __m128i*) &b[i])));
+    }
+#else
+    ints_clamp_n((int*) out, (const int*) x, (const int*) a, (const int*) b, n * 4);
+#endif // LA_SSE41
+}
+
+LADEF V3ua v3ua(unsigned int x, unsigned int y, unsigned int z)
+{
+    V3ua v;
+    v.x = x;
+    v.y = y;
+    v.z = z;
+    v.pad = 0;
+    return v;
+}
+
+LADEF V3ua v3uau(unsigned int x)
+{
+    return v3ua(x, x, x);
+}
+
+LADEF V3ua v3ua3u(V3u a)
+{
+    return v3ua(a.x, a.y, a.z);
+}
+
+LADEF V3u v3u3ua(V3ua a)
+{
+    return v3u(a.x, a.y, a.z);
+}
+
+LADEF V3ua v3ua_sum(V3ua a, V3ua b)
+{
+#if LA_SSE2
+    return la_store3ua(_mm_add_epi32(la_load3ua(a), la_load3ua(b)));
+#else
+    a.x += b.x;
+    a.y += b.y;
+    a.z += b.z;
+    return a;
+#endif // LA_SSE2
+}
+
+LADEF V3ua v3ua_sub(V3ua a, V3ua b)
+{
+#if LA_SSE2
+    return la_store3ua(_mm_sub_epi32(la_load3ua(a), la_load3ua(b)));
+#else
+    a.x -= b.x;
+    a.y -= b.y;
+    a.z -= b.z;
+    return a;
+#endif // LA_SSE2
+}
+
+LADEF V3ua v3ua_mul(V3ua a, V3ua b)
+{
+#if LA_SSE41
+    return la_store3ua(_mm_mullo_epi32(la_load3ua(a), la_load3ua(b)));
+#else
+    a.x *= b.x;
+    a.y *= b.y;
+    a.z *= b.z;
+    return a;
+#endif // LA_SSE41
+}
+
+LADEF V3ua v3ua_div(V3ua a, V3ua b)
+{
+    a.x /= b.x;
+    a.y /= b.y;
+    a.z /= b.z;
+    return a;
+}
+
+LADEF V3ua v3ua_min(V3ua a, V3ua b)
+{
+#if LA_SSE41
+    return la_store3ua(_mm_min_epu32(la_load3ua(a), la_load3ua(b)));
+#else
+    a.x = minu(a.x, b.x);
+    a.y = minu(a.y, b.y);
+    a.z = minu(a.z, b.z);
+    return a;
+#endif // LA_SSE41
+}
+
+LADEF V3ua v3ua_max(V3ua a, V3ua b)
+{
+#if LA_SSE41
+    return la_store3ua(_mm_max_epu32(la_load3ua(a), la_load3ua(b)));
+#else
+    a.x = maxu(a.x, b.x);
+    a.y = maxu(a.y, b.y);
+    a.z = maxu(a.z, b.z);
+    return a;
+#endif // LA_SSE41
+}
+
+LADEF V3ua v3ua_clamp(V3ua x, V3ua a, V3ua b)
+{
+#if LA_SSE41
+    return la_store3ua(_mm_min_epu32(_mm_max_epu32(la_load3ua(a), la_load3ua(x)), la_load3ua(b)));
+#else
+    x.x = clampu(x.x, a.x, b.x);
+    x.y = clampu(x.y, a.y, b.y);
+    x.z = clampu(x.z, a.z, b.z);
+    return x;
+#endif // LA_SSE41
+}
+
+LADEF unsigned int v3ua_sqrlen(V3ua a)
+{
+    return a.x*a.x + a.y*a.y + a.z*a.z;
+}
+
+LADEF void v3ua_sum_n(V3ua *out, const V3ua *a, const V3ua *b, size_t n)
+{
+#if LA_SSE2
+    for (size_t i = 0; i < n; ++i) {
+        _mm_store_si128((__m128i*) &out[i], _mm_add_epi32(_mm_load_si128((const __m128i*) &a[i]), _mm_load_si128((const __m128i*) &b[i])));
+    }
+#else
+    uints_sum_n((unsigned int*) out, (const unsigned int*) a, (const unsigned int*) b, n * 4);
+#endif // LA_SSE2
+}
+
+LADEF void v3ua_sub_n(V3ua *out, const V3ua *a, const V3ua *b, size_t n)
+{
+#if LA_SSE2
+    for (size_t i = 0; i < n; ++i) {
+        _mm_store_si128((__m128i*) &out[i], _mm_sub_epi32(_mm_load_si128((const __m128i*) &a[i]), _mm_load_si128((const __m128i*) &b[i])));
+    }
+#else
+    uints_sub_n((unsigned int*) out, (const unsigned int*) a, (const unsigned int*) b, n * 4);
+#endif // LA_SSE2
+}
+
+LADEF void v3ua_mul_n(V3ua *out, const V3ua *a, const V3ua *b, size_t n)
+{
+#if LA_SSE41
+    for (size_t i = 0; i < n; ++i) {
+        _mm_store_si128((__m128i*) &out[i], _mm_mullo_epi32(_mm_load_si128((const __m128i*) &a[i]), _mm_load_si128((const __m128i*) &b[i])));
+    }
+#else
+    uints_mul_n((unsigned int*) out, (const unsigned int*) a, (const unsigned int*) b, n * 4);
+#endif // LA_SSE41
+}
+
+LADEF void v3ua_div_n(V3ua *out, const V3ua *a, const V3ua *b, size_t n)
+{
+    for (size_t i = 0; i < n; ++i) {
+        out[i] = v3ua_div(a[i], b[i]);
+    }
+}
+
+LADEF void v3ua_min_n(V3ua *out, const V3ua *a, const V3ua *b, size_t n)
+{
+#if LA_SSE41
+    for (size_t i = 0; i < n; ++i) {
+        _mm_store_si128((__m128i*) &out[i], _mm_min_epu32(_mm_load_si128((const __m128i*) &a[i]), _mm_load_si128((const __m128i*) &b[i])));
+    }
+#else
+    uints_min_n((unsigned int*) out, (const unsigned int*) a, (const unsigned int*) b, n * 4);
+#endif // LA_SSE41
+}
+
+LADEF void v3ua_max_n(V3ua *out, const V3ua *a, const V3ua *b, size_t n)
+{
+#if LA_SSE41
+    for (size_t i = 0; i < n; ++i) {
+        _mm_store_si128((__m128i*) &out[i], _mm_max_epu32(_mm_load_si128((const __m128i*) &a[i]), _mm_load_si128((const __m128i*) &b[i])));
+    }
+#else
+    uints_max_n((unsigned int*) out, (const unsigned int*) a, (const unsigned int*) b, n * 4);
+#endif // LA_SSE41
+}
+
+LADEF void v3ua_clamp_n(V3ua *out, const V3ua *x, const V3ua *a, const V3ua *b, size_t n)
+{
+#if LA_SSE41
+    for (size_t i = 0; i < n; ++i) {
+        _mm_store_si128((__m128i*) &out[i], _mm_min_epu32(_mm_max_epu32(_mm_load_si128((const __m128i*) &a[i]), _mm_load_si128((const __m128i*) &x[i])), _mm_load_si128((const __m128i*) &b[i])));
+    }
+#else
+    uints_clamp_n((unsigned int*) out, (const unsigned int*) x, (const unsigned int*) a, (const unsigned int*) b, n * 4);
+#endif // LA_SSE41
+}
+
+LADEF V4ua v4ua(unsigned int x, unsigned int y, unsigned int z, unsigned int w)
+{
+    V4ua v;
+    v.x = x;
+    v.y = y;
+    v.z = z;
+    v.w = w;
+    return v;
+}
+
+LADEF V4ua v4uau(unsigned int x)
+{
+    return v4ua(x, x, x, x);
+}
+
+LADEF V4ua v4ua4u(V4u a)
+{
+    return v4ua(a.x, a.y, a.z, a.w);
+}
+
+LADEF V4u v4u4ua(V4ua a)
+{
+    return v4u(a.x, a.y, a.z, a.w);
+}
+
+LADEF V4ua v4ua_sum(V4ua a, V4ua b)
+{
+#if LA_SSE2
+    return la_store4ua(_mm_add_epi32(la_load4ua(a), la_load4ua(b)));
+#else
+    a.x += b.x;
+    a.y += b.y;
+    a.z += b.z;
+    a.w += b.w;
+    return a;
+#endif // LA_SSE2
+}
+
+LADEF V4ua v4ua_sub(V4ua a, V4ua b)
+{
+#if LA_SSE2
+    return la_store4ua(_mm_sub_epi32(la_load4ua(a), la_load4ua(b)));
+#else
+    a.x -= b.x;
+    a.y -= b.y;
+    a.z -= b.z;
+    a.w -= b.w;
+    return a;
+#endif // LA_SSE2
+}
+
+LADEF V4ua v4ua_mul(V4ua a, V4ua b)
+{
+#if LA_SSE41
+    return la_store4ua(_mm_mullo_epi32(la_load4ua(a), la_load4ua(b)));
+#else
+    a.x *= b.x;
+    a.y *= b.y;
+    a.z *= b.z;
+    a.w *= b.w;
+    return a;
+#endif // LA_SSE41
+}
+
+LADEF V4ua v4ua_div(V4ua a, V4ua b)
+{
+    a.x /= b.x;
+    a.y /= b.y;
+    a.z /= b.z;
+    a.w /= b.w;
+    return a;
+}
+
+LADEF V4ua v4ua_min(V4ua a, V4ua b)
+{
+#if LA_SSE41
+    return la_store4ua(_mm_min_epu32(la_load4ua(a), la_load4ua(b)));
+#else
+    a.x = minu(a.x, b.x);
+    a.y = minu(a.y, b.y);
+    a.z = minu(a.z, b.z);
+    a.w = minu(a.w, b.w);
+    return a;
+#endif // LA_SSE41
+}
+
+LADEF V4ua v4ua_max(V4ua a, V4ua b)
+{
+#if LA_SSE41
+    return la_store4ua(_mm_max_epu32(la_load4ua(a), la_load4ua(b)));
+#else
+    a.x = maxu(a.x, b.x);
+    a.y = maxu(a.y, b.y);
+    a.z = maxu(a.z, b.z);
+    a.w = maxu(a.w, b.w);
+    return a;
+#endif // LA_SSE41
+}
+
+LADEF V4ua v4ua_clamp(V4ua x, V4ua a, V4ua b)
+{
+#if LA_SSE41
+    return la_store4ua(_mm_min_epu32(_mm_max_epu32(la_load4ua(a), la_load4ua(x)), la_load4ua(b)));
+#else
+    x.x = clampu(x.x, a.x, b.x);
+    x.y = clampu(x.y, a.y, b.y);
+    x.z = clampu(x.z, a.z, b.z);
+    x.w = clampu(x.w, a.w, b.w);
+    return x;
+#endif // LA_SSE41
+}
+
+LADEF unsigned int v4ua_sqrlen(V4ua a)
+{
+    return a.x*a.x + a.y*a.y + a.z*a.z + a.w*a.w;
+}
+
+LADEF void v4ua_sum_n(V4ua *out, const V4ua *a, const V4ua *b, size_t n)
+{
+#if LA_SSE2
+    for (size_t i = 0; i < n; ++i) {
+        _mm_store_si128((__m128i*) &out[i], _mm_add_epi32(_mm_load_si128((const __m128i*) &a[i]), _mm_load_si128((const __m128i*) &b[i])));
+    }
+#else
+    uints_sum_n((unsigned int*) out, (const unsigned int*) a, (const unsigned int*) b, n * 4);
+#endif // LA_SSE2
+}
+
+LADEF void v4ua_sub_n(V4ua *out, const V4ua *a, const V4ua *b, size_t n)
+{
+#if LA_SSE2
+    for (size_t i = 0; i < n; ++i) {
+        _mm_store_si128((__m128i*) &out[i], _mm_sub_epi32(_mm_load_si128((const __m128i*) &a[i]), _mm_load_si128((const __m128i*) &b[i])));
+    }
+#else
+    uints_sub_n((unsigned int*) out, (const unsigned int*) a, (const unsigned int*) b, n * 4);
+#endif // LA_SSE2
+}
+
+LADEF void v4ua_mul_n(V4ua *out, const V4ua *a, const V4ua *b, size_t n)
+{
+#if LA_SSE41
+    for (size_t i = 0; i < n; ++i) {
+        _mm_store_si128((__m128i*) &out[i], _mm_mullo_epi32(_mm_load_si128((const __m128i*) &a[i]), _mm_load_si128((const __m128i*) &b[i])));
+    }
+#else
+    uints_mul_n((unsigned int*) out, (const unsigned int*) a, (const unsigned int*) b, n * 4);
+#endif // LA_SSE41
+}
+
+LADEF void v4ua_div_n(V4ua *out, const V4ua *a, const V4ua *b, size_t n)
+{
+    uints_div_n((unsigned int*) out, (const unsigned int*) a, (const unsigned int*) b, n * 4);
+}
+
+LADEF void v4ua_min_n(V4ua *out, const V4ua *a, const V4ua *b, size_t n)
+{
+#if LA_SSE41
+    for (size_t i = 0; i < n; ++i) {
+        _mm_store_si128((__m128i*) &out[i], _mm_min_epu32(_mm_load_si128((const __m128i*) &a[i]), _mm_load_si128((const __m128i*) &b[i])));
+    }
+#else
+    uints_min_n((unsigned int*) out, (const unsigned int*) a, (const unsigned int*) b, n * 4);
+#endif // LA_SSE41
+}
+
+LADEF void v4ua_max_n(V4ua *out, const V4ua *a, const V4ua *b, size_t n)
+{
+#if LA_SSE41
+    for (size_t i = 0; i < n; ++i) {
+        _mm_store_si128((__m128i*) &out[i], _mm_max_epu32(_mm_load_si128((const __m128i*) &a[i]), _mm_load_si128((const __m128i*) &b[i])));
+    }
+#else
+    uints_max_n((unsigned int*) out, (const unsigned int*) a, (const unsigned int*) b, n * 4);
+#endif // LA_SSE41
+}
+
+LADEF void v4ua_clamp_n(V4ua *out, const V4ua *x, const V4ua *a, const V4ua *b, size_t n)
+{
+#if LA_SSE41
+    for (size_t i = 0; i < n; ++i) {
+        _mm_store_si128((__m128i*) &out[i], _mm_min_epu32(_mm_max_epu32(_mm_load_si128((const __m128i*) &a[i]), _mm_load_si128((const __m128i*) &x[i])), _mm_load_si128((const __m128i*) &b[i])));
+    }
+#else
+    uints_clamp_n((unsigned int*) out, (const unsigned int*) x, (const unsigned int*) a, (const unsigned int*) b, n * 4);
+#endif // LA_SSE41
+}
+
 #endif // LA_IMPLEMENTATION
@@ -0,0 +1,819 @@
+// Accuracy checks and microbenchmarks of la.h.
+//
+// Every element-wise operation of every vector type is checked against the
+// scalar reference (the same libm or la.h scalar function applied to each
+// component) over the edge cases below: zeros of both signs, denormals,
+// infinities, NaN, clamp bounds in the wrong order, division by zero (only
+// for the floating point types, it is undefined for the integer ones). The
+// batch kernels are checked against the single-value operations, the *_fast
+// functions against libm within the bounds documented in la.h, the aligned
+// vectors against the unaligned ones and the matrices against the
+// definitions. Any mismatch is reported and la_bench
+// exits with 1 before measuring anything.
+//
+// Build it with and without -DLA_SIMD to check and measure both paths.
+//
+// Usage: ./la_bench [repetitions], 0 repetitions only runs the checks.
+
+#include <float.h>
+#include <limits.h>
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define LA_IMPLEMENTATION
+#include "la.h"
+
+#define ARRAY_LEN(xs) (sizeof(xs) / sizeof((xs)[0]))
+#define BATCH_LEN 37
+#define BENCH_LEN 1024
+#define DEFAULT_REPETITIONS 2000
+#define FAILURES_PRINTED 20
+
+static const float float_cases[] = {
+    0.0f, -0.0f, 1.0f, -1.0f, 0.5f, -0.5f, 2.5f, -2.5f, 3.75f, 100.25f, 1e-3f,
+    1e-40f, -1e-40f, 1e30f, -1e30f, FLT_MAX, INFINITY, -INFINITY, NAN,
+};
+
+static const double double_cases[] = {
+    0.0, -0.0, 1.0, -1.0, 0.5, -0.5, 2.5, -2.5, 3.75, 100.25, 1e-3,
+    1e-310, -1e-310, 1e300, -1e300, DBL_MAX, INFINITY, -INFINITY, NAN,
+};
+
+// Small enough for sqrlen of a V4i not to overflow
+static const int int_cases[] = {
+    0, 1, -1, 2, -3, 7, -8, 100, -100, 12345, 23170, -23170,
+};
+
+static const unsigned int uint_cases[] = {
+    0, 1, 2, 3, 7, 100, 65535, 65536, 0x7fffffffu, 0x80000000u, 0xfffffffeu, UINT_MAX,
+};
+
+static size_t failures = 0;
+
+static void check(const char *op, size_t i, bool ok, double got, double expected)
+{
+    if (ok) return;
+    if (failures < FAILURES_PRINTED) {
+        fprintf(stderr, "ERROR: %s: case %zu: got %.9g, expected %.9g\n", op, i, got, expected);
+    }
+    failures += 1;
+}
+
+// Bit for bit, any NaN is the same as any other NaN
+static bool same_float(float a, float b)
+{
+    return memcmp(&a, &b, sizeof(a)) == 0 || (a != a && b != b);
+}
+
+static bool same_double(double a, double b)
+{
+    return memcmp(&a, &b, sizeof(a)) == 0 || (a != a && b != b);
+}
+
+static bool same_int(int a, int b)
+{
+    return a == b;
+}
+
+static bool same_uint(unsigned int a, unsigned int b)
+{
+    return a == b;
+}
+
+#define SAME(a, b) _Generic((a), float: same_float, double: same_double, int: same_int, unsigned int: same_uint)(a, b)
+// C does not specify which of the zeros fmin(-0, 0) and fmax(-0, 0) return
+#define SAME_ZERO(a, b) (SAME(a, b) || ((a) == 0 && (b) == 0))
+
+#define REF_SUM(a, b) ((a) + (b))
+#define REF_SUB(a, b) ((a) - (b))
+#define REF_MUL(a, b) ((a) * (b))
+#define REF_DIV(a, b) ((a) / (b))
+#define REF_SQRT(a) _Generic((a), float: sqrtf, double: sqrt)(a)
+#define REF_POW(a, b) _Generic((a), float: powf, double: pow)(a, b)
+#define REF_SIN(a) _Generic((a), float: sinf, double: sin)(a)
+#define REF_COS(a) _Generic((a), float: cosf, double: cos)(a)
+#define REF_FLOOR(a) _Generic((a), float: floorf, double: floor)(a)
+#define REF_CEIL(a) _Generic((a), float: ceilf, double: ceil)(a)
+#define REF_MIN(a, b) _Generic((a), float: fminf, double: fmin, int: mini, unsigned int: minu)(a, b)
+#define REF_MAX(a, b) _Generic((a), float: fmaxf, double: fmax, int: maxi, unsigned int: maxu)(a, b)
+#define REF_LERP(a, b, t) _Generic((a), float: lerpf, double: lerp)(a, b, t)
+#define REF_CLAMP(x, a, b) _Generic((x), float: clampf, double: clampd, int: clampi, unsigned int: clampu)(x, a, b)
+
+#define ANY(a, b) true
+#define NONZERO(a, b) ((b) != 0)
+
+#define COUNT(v) (sizeof(v) / sizeof((v).x))
+#define COMP(v, k) ((&(v).x)[k])
+// Every component takes a different case, so all the pairs of the cases
+// meet in the first component
+#define LOAD(v, cases, i)                                                                    \
+    for (size_t k = 0; k < COUNT(v); ++k) COMP(v, k) = cases[((i) + 5*k) % ARRAY_LEN(cases)]
+
+#define CHECK_UNARY(T, t, op, ref, cases)                                                    \
+    for (size_t i = 0; i < ARRAY_LEN(cases); ++i) {                                          \
+        T a;                                                                                 \
+        LOAD(a, cases, i);                                                                   \
+        T r = t##_##op(a);                                                                   \
+        for (size_t k = 0; k < COUNT(r); ++k) {                                              \
+            check(#t"_"#op, i, SAME(COMP(r, k), ref(COMP(a, k))),                            \
+                  (double) COMP(r, k), (double) ref(COMP(a, k)));                            \
+        }                                                                                    \
+    }
+
+#define CHECK_BINARY(T, t, op, ref, cases, valid, same)                                      \
+    for (size_t i = 0; i < ARRAY_LEN(cases)*ARRAY_LEN(cases); ++i) {                         \
+        T a, b;                                                                              \
+        LOAD(a, cases, i);                                                                   \
+        LOAD(b, cases, i / ARRAY_LEN(cases));                                                \
+        bool ok = true;                                                                      \
+        for (size_t k = 0; k < COUNT(a); ++k) ok = ok && valid(COMP(a, k), COMP(b, k));      \
+        if (!ok) continue;                                                                   \
+        T r = t##_##op(a, b);                                                                \
+        for (size_t k = 0; k < COUNT(r); ++k) {                                              \
+            check(#t"_"#op, i, same(COMP(r, k), ref(COMP(a, k), COMP(b, k))),                \
+                  (double) COMP(r, k), (double) ref(COMP(a, k), COMP(b, k)));                \
+        }                                                                                    \
+    }
+
+#define CHECK_TERNARY(T, t, op, ref, cases, same)                                            \
+    for (size_t i = 0; i < ARRAY_LEN(cases)*ARRAY_LEN(cases)*ARRAY_LEN(cases); ++i) {        \
+        T a, b, c;                                                                           \
+        LOAD(a, cases, i);                                                                   \
+        LOAD(b, cases, i / ARRAY_LEN(cases));                                                \
+        LOAD(c, cases, i / ARRAY_LEN(cases) / ARRAY_LEN(cases));                             \
+        T r = t##_##op(a, b, c);                                                             \
+        for (size_t k = 0; k < COUNT(r); ++k) {                                              \
+            check(#t"_"#op, i, same(COMP(r, k), ref(COMP(a, k), COMP(b, k), COMP(c, k))),    \
+                  (double) COMP(r, k), (double) ref(COMP(a, k), COMP(b, k), COMP(c, k)));    \
+        }                                                                                    \
+    }
+
+#define CHECK_SQRLEN(T, S, t, cases)                                                         \
+    for (size_t i = 0; i < ARRAY_LEN(cases); ++i) {                                          \
+        T a;                                                                                 \
+        LOAD(a, cases, i);                                                                   \
+        S expected = COMP(a, 0)*COMP(a, 0);                                                  \
+        for (size_t k = 1; k < COUNT(a); ++k) expected += COMP(a, k)*COMP(a, k);             \
+        check(#t"_sqrlen", i, SAME(t##_sqrlen(a), expected),                                 \
+              (double) t##_sqrlen(a), (double) expected);                                    \
+    }
+
+#define CHECK_LEN(T, t, cases)                                                               \
+    for (size_t i = 0; i < ARRAY_LEN(cases); ++i) {                                          \
+        T a;                                                                                 \
+        LOAD(a, cases, i);                                                                   \
+        check(#t"_len", i, SAME(t##_len(a), REF_SQRT(t##_sqrlen(a))),                        \
+              (double) t##_len(a), (double) REF_SQRT(t##_sqrlen(a)));                        \
+    }
+
+// The batch kernels against the single-value operations, BATCH_LEN is odd so
+// the scalar tails of the vectorized loops are covered too
+#define BATCH_LOAD(xs, cases, shift, valid)                                                  \
+    for (size_t j = 0; j < BATCH_LEN; ++j) {                                                 \
+        LOAD(xs[j], cases, 7*j + (shift));                                                   \
+        for (size_t k = 0; k < COUNT(xs[j]); ++k) {                                          \
+            if (!valid(0, COMP(xs[j], k))) COMP(xs[j], k) = 1;                               \
+        }                                                                                    \
+    }
+
+#define CHECK_BATCH(T, t, op, r, expected, same)                                             \
+    for (size_t j = 0; j < BATCH_LEN; ++j) {                                                 \
+        T e = expected;                                                                      \
+        for (size_t k = 0; k < COUNT(e); ++k) {                                              \
+            check(#t"_"#op"_n", j, same(COMP(r[j], k), COMP(e, k)),                          \
+                  (double) COMP(r[j], k), (double) COMP(e, k));                              \
+        }                                                                                    \
+    }
+
+#define CHECK_BATCH_UNARY(T, t, op, cases, same)                                             \
+    {                                                                                        \
+        T a[BATCH_LEN], r[BATCH_LEN];                                                        \
+        BATCH_LOAD(a, cases, 0, ANY);                                                        \
+        t##_##op##_n(r, a, BATCH_LEN);                                                       \
+        CHECK_BATCH(T, t, op, r, t##_##op(a[j]), same);                                      \
+    }
+
+#define CHECK_BATCH_BINARY(T, t, op, cases, valid, same)                                     \
+    {                                                                                        \
+        T a[BATCH_LEN], b[BATCH_LEN], r[BATCH_LEN];                                          \
+        BATCH_LOAD(a, cases, 0, ANY);                                                        \
+        BATCH_LOAD(b, cases, 3, valid);                                                      \
+        t##_##op##_n(r, a, b, BATCH_LEN);                                                    \
+        CHECK_BATCH(T, t, op, r, t##_##op(a[j], b[j]), same);                                \
+    }
+
+#define CHECK_BATCH_TERNARY(T, t, op, cases, same)                                           \
+    {                                                                                        \
+        T a[BATCH_LEN], b[BATCH_LEN], c[BATCH_LEN], r[BATCH_LEN];                            \
+        BATCH_LOAD(a, cases, 0, ANY);                                                        \
+        BATCH_LOAD(b, cases, 3, ANY);                                                        \
+        BATCH_LOAD(c, cases, 11, ANY);                                                       \
+        t##_##op##_n(r, a, b, c, BATCH_LEN);                                                 \
+        CHECK_BATCH(T, t, op, r, t##_##op(a[j], b[j], c[j]), same);                          \
+    }
+
+#define SOA_CALL_2(t, out, soa, n) t##_len_soa(out, soa[0], soa[1], n)
+#define SOA_CALL_3(t, out, soa, n) t##_len_soa(out, soa[0], soa[1], soa[2], n)
+#define SOA_CALL_4(t, out, soa, n) t##_len_soa(out, soa[0], soa[1], soa[2], soa[3], n)
+
+#define CHECK_BATCH_LEN(T, S, N, t, cases)                                                   \
+    {                                                                                        \
+        T a[BATCH_LEN];                                                                      \
+        S soa[N][BATCH_LEN], aos_len[BATCH_LEN], soa_len[BATCH_LEN];                         \
+        BATCH_LOAD(a, cases, 0, ANY);                                                        \
+        for (size_t j = 0; j < BATCH_LEN; ++j) {                                             \
+            for (size_t k = 0; k < N; ++k) soa[k][j] = COMP(a[j], k);                        \
+        }                                                                                    \
+        t##_len_n(aos_len, a, BATCH_LEN);                                                    \
+        SOA_CALL_##N(t, soa_len, soa, BATCH_LEN);                                            \
+        for (size_t j = 0; j < BATCH_LEN; ++j) {                                             \
+            check(#t"_len_n", j, SAME(aos_len[j], t##_len(a[j])),                            \
+                  (double) aos_len[j], (double) t##_len(a[j]));                              \
+            check(#t"_len_soa", j, SAME(soa_len[j], t##_len(a[j])),                          \
+                  (double) soa_len[j], (double) t##_len(a[j]));                              \
+        }                                                                                    \
+    }
+
+#define REAL_VECTORS(X)                   \
+    X(V2f, float, 2, v2f, float_cases)    \
+    X(V3f, float, 3, v3f, float_cases)    \
+    X(V4f, float, 4, v4f, float_cases)    \
+    X(V2d, double, 2, v2d, double_cases)  \
+    X(V3d, double, 3, v3d, double_cases)  \
+    X(V4d, double, 4, v4d, double_cases)
+
+#define INTEGER_VECTORS(X)                       \
+    X(V2i, int, 2, v2i, int_cases)               \
+    X(V3i, int, 3, v3i, int_cases)               \
+    X(V4i, int, 4, v4i, int_cases)               \
+    X(V2u, unsigned int, 2, v2u, uint_cases)     \
+    X(V3u, unsigned int, 3, v3u, uint_cases)     \
+    X(V4u, unsigned int, 4, v4u, uint_cases)
+
+#define DEFINE_CHECK_REAL(T, S, N, t, cases)                                                 \
+    static void check_##t(void)                                                              \
+    {                                                                                        \
+        CHECK_BINARY(T, t, sum, REF_SUM, cases, ANY, SAME)                                   \
+        CHECK_BINARY(T, t, sub, REF_SUB, cases, ANY, SAME)                                   \
+        CHECK_BINARY(T, t, mul, REF_MUL, cases, ANY, SAME)                                   \
+        CHECK_BINARY(T, t, div, REF_DIV, cases, ANY, SAME)                                   \
+        CHECK_UNARY(T, t, sqrt, REF_SQRT, cases)                                             \
+        CHECK_BINARY(T, t, pow, REF_POW, cases, ANY, SAME)                                   \
+        CHECK_UNARY(T, t, sin, REF_SIN, cases)                                               \
+        CHECK_UNARY(T, t, cos, REF_COS, cases)                                               \
+        CHECK_BINARY(T, t, min, REF_MIN, cases, ANY, SAME_ZERO)                              \
+        CHECK_BINARY(T, t, max, REF_MAX, cases, ANY, SAME_ZERO)                              \
+        CHECK_TERNARY(T, t, lerp, REF_LERP, cases, SAME)                                     \
+        CHECK_UNARY(T, t, floor, REF_FLOOR, cases)                                           \
+        CHECK_UNARY(T, t, ceil, REF_CEIL, cases)                                             \
+        CHECK_TERNARY(T, t, clamp, REF_CLAMP, cases, SAME_ZERO)                              \
+        CHECK_SQRLEN(T, S, t, cases)                                                         \
+        CHECK_LEN(T, t, cases)                                                               \
+        CHECK_BATCH_BINARY(T, t, sum, cases, ANY, SAME)                                      \
+        CHECK_BATCH_BINARY(T, t, sub, cases, ANY, SAME)                                      \
+        CHECK_BATCH_BINARY(T, t, mul, cases, ANY, SAME)                                      \
+        CHECK_BATCH_BINARY(T, t, div, cases, ANY, SAME)                                      \
+        CHECK_BATCH_UNARY(T, t, sqrt, cases, SAME)                                           \
+        CHECK_BATCH_BINARY(T, t, min, cases, ANY, SAME_ZERO)                                 \
+        CHECK_BATCH_BINARY(T, t, max, cases, ANY, SAME_ZERO)                                 \
+        CHECK_BATCH_TERNARY(T, t, lerp, cases, SAME)                                         \
+        CHECK_BATCH_TERNARY(T, t, clamp, cases, SAME_ZERO)                                   \
+        CHECK_BATCH_LEN(T, S, N, t, cases)                                                   \
+    }
+
+#define DEFINE_CHECK_INTEGER(T, S, N, t, cases)                                              \
+    static void check_##t(void)                                                              \
+    {                                                                                        \
+        CHECK_BINARY(T, t, sum, REF_SUM, cases, ANY, SAME)                                   \
+        CHECK_BINARY(T, t, sub, REF_SUB, cases, ANY, SAME)                                   \
+        CHECK_BINARY(T, t, mul, REF_MUL, cases, ANY, SAME)                                   \
+        CHECK_BINARY(T, t, div, REF_DIV, cases, NONZERO, SAME)                               \
+        CHECK_BINARY(T, t, min, REF_MIN, cases, ANY, SAME_ZERO)                              \
+        CHECK_BINARY(T, t, max, REF_MAX, cases, ANY, SAME_ZERO)                              \
+        CHECK_TERNARY(T, t, clamp, REF_CLAMP, cases, SAME_ZERO)                              \
+        CHECK_SQRLEN(T, S, t, cases)                                                         \
+        CHECK_BATCH_BINARY(T, t, sum, cases, ANY, SAME)                                      \
+        CHECK_BATCH_BINARY(T, t, sub, cases, ANY, SAME)                                      \
+        CHECK_BATCH_BINARY(T, t, mul, cases, ANY, SAME)                                      \
+        CHECK_BATCH_BINARY(T, t, div, cases, NONZERO, SAME)                                  \
+        CHECK_BATCH_BINARY(T, t, min, cases, ANY, SAME_ZERO)                                 \
+        CHECK_BATCH_BINARY(T, t, max, cases, ANY, SAME_ZERO)                                 \
+        CHECK_BATCH_TERNARY(T, t, clamp, cases, SAME_ZERO)                                   \
+    }
+
+REAL_VECTORS(DEFINE_CHECK_REAL)
+INTEGER_VECTORS(DEFINE_CHECK_INTEGER)
+
+// The aligned vectors against the unaligned ones, the padding is not compared
+#define CHECK_ALIGNED_RESULT(t, op, r, e, same)                                              \
+    for (size_t k = 0; k < COUNT(e); ++k) {                                                  \
+        check(#t"a_"#op, i, same(COMP(r, k), COMP(e, k)), (double) COMP(r, k), (double) COMP(e, k)); \
+    }
+
+#define CHECK_ALIGNED_UNARY(T, t, to, from, op, cases, same)                                 \
+    for (size_t i = 0; i < ARRAY_LEN(cases); ++i) {                                          \
+        T a;                                                                                 \
+        LOAD(a, cases, i);                                                                   \
+        T r = from(t##a_##op(to(a)));                                                        \
+        T e = t##_##op(a);                                                                   \
+        CHECK_ALIGNED_RESULT(t, op, r, e, same)                                              \
+    }
+
+#define CHECK_ALIGNED_BINARY(T, t, to, from, op, cases, valid, same)                         \
+    for (size_t i = 0; i < ARRAY_LEN(cases)*ARRAY_LEN(cases); ++i) {                         \
+        T a, b;                                                                              \
+        LOAD(a, cases, i);                                                                   \
+        LOAD(b, cases, i / ARRAY_LEN(cases));                                                \
+        bool ok = true;                                                                      \
+        for (size_t k = 0; k < COUNT(a); ++k) ok = ok && valid(COMP(a, k), COMP(b, k));      \
+        if (!ok) continue;                                                                   \
+        T r = from(t##a_##op(to(a), to(b)));                                                 \
+        T e = t##_##op(a, b);                                                                \
+        CHECK_ALIGNED_RESULT(t, op, r, e, same)                                              \
+    }
+
+#define CHECK_ALIGNED_TERNARY(T, t, to, from, op, cases, same)                               \
+    for (size_t i = 0; i < ARRAY_LEN(cases)*ARRAY_LEN(cases)*ARRAY_LEN(cases); ++i) {        \
+        T a, b, c;                                                                           \
+        LOAD(a, cases, i);                                                                   \
+        LOAD(b, cases, i / ARRAY_LEN(cases));                                                \
+        LOAD(c, cases, i / ARRAY_LEN(cases) / ARRAY_LEN(cases));                             \
+        T r = from(t##a_##op(to(a), to(b), to(c)));                                          \
+        T e = t##_##op(a, b, c);                                                             \
+        CHECK_ALIGNED_RESULT(t, op, r, e, same)                                              \
+    }
+
+#define CHECK_ALIGNED_SCALAR(T, t, to, op, cases)                                            \
+    for (size_t i = 0; i < ARRAY_LEN(cases); ++i) {                                          \
+        T a;                                                                                 \
+        LOAD(a, cases, i);                                                                   \
+        check(#t"a_"#op, i, SAME(t##a_##op(to(a)), t##_##op(a)),                             \
+              (double) t##a_##op(to(a)), (double) t##_##op(a));                              \
+    }
+
+// `batch` and `single` are the calls of the batch kernel and of the matching
+// single-value operation
+#define CHECK_ALIGNED_BATCH(T, TA, t, to, from, op, cases, valid, same, batch, single)       \
+    {                                                                                        \
+        TA a[BATCH_LEN], b[BATCH_LEN], c[BATCH_LEN], r[BATCH_LEN];                           \
+        for (size_t j = 0; j < BATCH_LEN; ++j) {                                             \
+            T x, y, z;                                                                       \
+            LOAD(x, cases, 7*j);                                                             \
+            LOAD(y, cases, 7*j + 3);                                                         \
+            LOAD(z, cases, 7*j + 11);                                                        \
+            for (size_t k = 0; k < COUNT(y); ++k) {                                          \
+                if (!valid(0, COMP(y, k))) COMP(y, k) = 1;                                   \
+            }                                                                                \
+            a[j] = to(x);                                                                    \
+            b[j] = to(y);                                                                    \
+            c[j] = to(z);                                                                    \
+        }                                                                                    \
+        (void) b;                                                                            \
+        (void) c;                                                                            \
+        batch;                                                                               \
+        for (size_t i = 0; i < BATCH_LEN; ++i) {                                             \
+            T rs = from(r[i]);                                                               \
+            T e = from(single);                                                              \
+            CHECK_ALIGNED_RESULT(t, op##_n, rs, e, same)                                     \
+        }                                                                                    \
+    }
+
+#define ALIGNED_REAL_VECTORS(X)                                                              \
+    X(V3f, V3fa, v3f, v3fa3f, v3f3fa, float_cases)                                           \
+    X(V4f, V4fa, v4f, v4fa4f, v4f4fa, float_cases)                                           \
+    X(V3d, V3da, v3d, v3da3d, v3d3da, double_cases)                                          \
+    X(V4d, V4da, v4d, v4da4d, v4d4da, double_cases)
+
+#define ALIGNED_INTEGER_VECTORS(X)                                                           \
+    X(V3i, V3ia, v3i, v3ia3i, v3i3ia, int_cases)                                             \
+    X(V4i, V4ia, v4i, v4ia4i, v4i4ia, int_cases)                                             \
+    X(V3u, V3ua, v3u, v3ua3u, v3u3ua, uint_cases)                                            \
+    X(V4u, V4ua, v4u, v4ua4u, v4u4ua, uint_cases)
+
+#define CHECK_ALIGNED_COMMON(T, TA, t, to, from, cases, div_valid)                           \
+    CHECK_ALIGNED_BINARY(T, t, to, from, sum, cases, ANY, SAME)                              \
+    CHECK_ALIGNED_BINARY(T, t, to, from, sub, cases, ANY, SAME)                              \
+    CHECK_ALIGNED_BINARY(T, t, to, from, mul, cases, ANY, SAME)                              \
+    CHECK_ALIGNED_BINARY(T, t, to, from, div, cases, div_valid, SAME)                        \
+    CHECK_ALIGNED_BINARY(T, t, to, from, min, cases, ANY, SAME_ZERO)                         \
+    CHECK_ALIGNED_BINARY(T, t, to, from, max, cases, ANY, SAME_ZERO)                         \
+    CHECK_ALIGNED_TERNARY(T, t, to, from, clamp, cases, SAME_ZERO)                           \
+    CHECK_ALIGNED_SCALAR(T, t, to, sqrlen, cases)                                            \
+    CHECK_ALIGNED_BATCH(T, TA, t, to, from, sum, cases, ANY, SAME,                           \
+                        t##a_sum_n(r, a, b, BATCH_LEN), t##a_sum(a[i], b[i]))                \
+    CHECK_ALIGNED_BATCH(T, TA, t, to, from, sub, cases, ANY, SAME,                           \
+                        t##a_sub_n(r, a, b, BATCH_LEN), t##a_sub(a[i], b[i]))                \
+    CHECK_ALIGNED_BATCH(T, TA, t, to, from, mul, cases, ANY, SAME,                           \
+                        t##a_mul_n(r, a, b, BATCH_LEN), t##a_mul(a[i], b[i]))                \
+    CHECK_ALIGNED_BATCH(T, TA, t, to, from, div, cases, div_valid, SAME,                     \
+                        t##a_div_n(r, a, b, BATCH_LEN), t##a_div(a[i], b[i]))                \
+    CHECK_ALIGNED_BATCH(T, TA, t, to, from, min, cases, ANY, SAME_ZERO,                      \
+                        t##a_min_n(r, a, b, BATCH_LEN), t##a_min(a[i], b[i]))                \
+    CHECK_ALIGNED_BATCH(T, TA, t, to, from, max, cases, ANY, SAME_ZERO,                      \
+                        t##a_max_n(r, a, b, BATCH_LEN), t##a_max(a[i], b[i]))                \
+    CHECK_ALIGNED_BATCH(T, TA, t, to, from, clamp, cases, ANY, SAME_ZERO,                    \
+                        t##a_clamp_n(r, a, b, c, BATCH_LEN), t##a_clamp(a[i], b[i], c[i]))
+
+#define DEFINE_CHECK_ALIGNED_REAL(T, TA, t, to, from, cases)                                 \
+    static void check_##t##a(void)                                                           \
+    {                                                                                        \
+        CHECK_ALIGNED_COMMON(T, TA, t, to, from, cases, ANY)                                 \
+        CHECK_ALIGNED_UNARY(T, t, to, from, sqrt, cases, SAME)                               \
+        CHECK_ALIGNED_BINARY(T, t, to, from, pow, cases, ANY, SAME)                          \
+        CHECK_ALIGNED_UNARY(T, t, to, from, sin, cases, SAME)                                \
+        CHECK_ALIGNED_UNARY(T, t, to, from, cos, cases, SAME)                                \
+        CHECK_ALIGNED_TERNARY(T, t, to, from, lerp, cases, SAME)                             \
+        CHECK_ALIGNED_UNARY(T, t, to, from, floor, cases, SAME)                              \
+        CHECK_ALIGNED_UNARY(T, t, to, from, ceil, cases, SAME)                               \
+        CHECK_ALIGNED_SCALAR(T, t, to, len, cases)                                           \
+        CHECK_ALIGNED_BATCH(T, TA, t, to, from, sqrt, cases, ANY, SAME,                      \
+                            t##a_sqrt_n(r, a, BATCH_LEN), t##a_sqrt(a[i]))                   \
+        CHECK_ALIGNED_BATCH(T, TA, t, to, from, lerp, cases, ANY, SAME,                      \
+                            t##a_lerp_n(r, a, b, c, BATCH_LEN), t##a_lerp(a[i], b[i], c[i])) \
+    }
+
+#define DEFINE_CHECK_ALIGNED_INTEGER(T, TA, t, to, from, cases)                              \
+    static void check_##t##a(void)                                                           \
+    {                                                                                        \
+        CHECK_ALIGNED_COMMON(T, TA, t, to, from, cases, NONZERO)                             \
+    }
+
+ALIGNED_REAL_VECTORS(DEFINE_CHECK_ALIGNED_REAL)
+ALIGNED_INTEGER_VECTORS(DEFINE_CHECK_ALIGNED_INTEGER)
+
+static long long float_ulps(float a, double expected)
+{
+    float b = (float) expected;
+    if (a == b || (a != a && b != b)) return 0;
+    if (a != a || b != b || isinf(a) || isinf(b)) return LLONG_MAX;
+    int ia, ib;
+    memcpy(&ia, &a, sizeof(ia));
+    memcpy(&ib, &b, sizeof(ib));
+    // Map the sign-magnitude bits to a monotonic integer line
+    long long la = ia < 0 ? (long long) INT_MIN - ia : ia;
+    long long lb = ib < 0 ? (long long) INT_MIN - ib : ib;
+    return la > lb ? la - lb : lb - la;
+}
+
+#define FAST_SAMPLES 1000003
+
+// The bounds are the ones documented next to the declarations in la.h
+static void check_fast(void)
+{
+    for (size_t i = 0; i < FAST_SAMPLES; ++i) {
+        float x = -8192.0f + 16384.0f*(float) i/FAST_SAMPLES;
+        check("sinf_fast", i, fabs(sinf_fast(x) - sin(x)) <= 8e-8, sinf_fast(x), sin(x));
+        check("cosf_fast", i, fabs(cosf_fast(x) - cos(x)) <= 8e-8, cosf_fast(x), cos(x));
+
+        x = -87.3f + 176.0f*(float) i/FAST_SAMPLES;
+        check("expf_fast", i, float_ulps(expf_fast(x), exp(x)) <= 1, expf_fast(x), exp(x));
+
+        // Spread over all the exponents of the normal floats
+        x = ldexpf(1.0f + (float) (i % 1024)/1024.0f, (int) (i % 254) - 126);
+        check("logf_fast", i, float_ulps(logf_fast(x), log(x)) <= 1, logf_fast(x), log(x));
+        check("rsqrtf_fast", i, float_ulps(rsqrtf_fast(x), 1.0/sqrt(x)) <= 4, rsqrtf_fast(x), 1.0/sqrt(x));
+    }
+
+    // The denormals, where the estimate of rsqrtss is +inf, and the neighbours of FLT_MIN
+    float tiny[2*23 + 5];
+    size_t tiny_count = 0;
+    for (int k = 0; k < 23; ++k) {
+        uint32_t bits[] = {1u << k, (1u << k) | 1u};
+        for (size_t j = 0; j < ARRAY_LEN(bits); ++j) memcpy(&tiny[tiny_count++], &bits[j], sizeof(float));
+    }
+    tiny[tiny_count++] = nextafterf(nextafterf(FLT_MIN, 0.0f), 0.0f);
+    tiny[tiny_count++] = nextafterf(FLT_MIN, 0.0f);
+    tiny[tiny_count++] = FLT_MIN;
+    tiny[tiny_count++] = nextafterf(FLT_MIN, INFINITY);
+    tiny[tiny_count++] = nextafterf(nextafterf(FLT_MIN, INFINITY), INFINITY);
+    float tiny_r[ARRAY_LEN(tiny)];
+    floats_rsqrt_fast_n(tiny_r, tiny, tiny_count);
+    for (size_t i = 0; i < tiny_count; ++i) {
+        double expected = 1.0/sqrt((double) tiny[i]);
+        check("rsqrtf_fast", i, float_ulps(rsqrtf_fast(tiny[i]), expected) <= 4, rsqrtf_fast(tiny[i]), expected);
+        check("floats_rsqrt_fast_n", i, same_float(tiny_r[i], rsqrtf_fast(tiny[i])), tiny_r[i], rsqrtf_fast(tiny[i]));
+    }
+
+    static const struct { const char *op; float got, expected; } specials[] = {
+        {"sinf_fast(inf)", 0.0f, NAN},
+        {"logf_fast(0)", 0.0f, -INFINITY},
+        {"logf_fast(-1)", 0.0f, NAN},
+        {"logf_fast(inf)", 0.0f, INFINITY},
+        {"expf_fast(100)", 0.0f, INFINITY},
+        {"expf_fast(-100)", 0.0f, 0.0f},
+        {"powf_fast(0, 2)", 0.0f, 0.0f},
+        {"powf_fast(NaN, 0)", 0.0f, 1.0f},
+    };
+    const float got[ARRAY_LEN(specials)] = {
+        sinf_fast(INFINITY), logf_fast(0.0f), logf_fast(-1.0f), logf_fast(INFINITY),
+        expf_fast(100.0f), expf_fast(-100.0f), powf_fast(0.0f, 2.0f), powf_fast(NAN, 0.0f),
+    };
+    for (size_t i = 0; i < ARRAY_LEN(specials); ++i) {
+        check(specials[i].op, i, same_float(got[i], specials[i].expected), got[i], specials[i].expected);
+    }
+
+    // The vectorized variants against the scalar ones, bit for bit
+    float xs[BATCH_LEN], ys[BATCH_LEN], r[BATCH_LEN];
+    for (size_t j = 0; j < BATCH_LEN; ++j) {
+        xs[j] = float_cases[j % ARRAY_LEN(float_cases)]*(float) (j + 1);
+        ys[j] = float_cases[(7*j + 3) % ARRAY_LEN(float_cases)];
+    }
+#define CHECK_FAST_UNARY(op)                                                                 \
+    floats_##op##_fast_n(r, xs, BATCH_LEN);                                                  \
+    for (size_t j = 0; j < BATCH_LEN; ++j) {                                                 \
+        check("floats_"#op"_fast_n", j, same_float(r[j], op##f_fast(xs[j])), r[j], op##f_fast(xs[j])); \
+        V4f v = v4f_##op##_fast(v4ff(xs[j]));                                                \
+        V3f u = v3f_##op##_fast(v3ff(xs[j]));                                                \
+        V2f w = v2f_##op##_fast(v2ff(xs[j]));                                                \
+        check("v4f_"#op"_fast", j, same_float(v.w, r[j]), v.w, r[j]);                        \
+        check("v3f_"#op"_fast", j, same_float(u.z, r[j]), u.z, r[j]);                        \
+        check("v2f_"#op"_fast", j, same_float(w.y, r[j]), w.y, r[j]);                        \
+    }
+    CHECK_FAST_UNARY(sin)
+    CHECK_FAST_UNARY(cos)
+    CHECK_FAST_UNARY(exp)
+    CHECK_FAST_UNARY(log)
+    CHECK_FAST_UNARY(rsqrt)
+#undef CHECK_FAST_UNARY
+    floats_pow_fast_n(r, xs, ys, BATCH_LEN);
+    for (size_t j = 0; j < BATCH_LEN; ++j) {
+        float expected = ys[j] == 0.0f ? 1.0f : expf_fast(ys[j]*logf_fast(xs[j]));
+        check("powf_fast", j, same_float(powf_fast(xs[j], ys[j]), expected), powf_fast(xs[j], ys[j]), expected);
+        check("floats_pow_fast_n", j, same_float(r[j], expected), r[j], expected);
+        V4f v = v4f_pow_fast(v4ff(xs[j]), v4ff(ys[j]));
+        check("v4f_pow_fast", j, same_float(v.x, expected), v.x, expected);
+    }
+}
+
+static float matrix_case(size_t i)
+{
+    return (float) ((i*37 + 11) % 19) * 0.25f - 2.0f;
+}
+
+static bool close_to(float a, float b)
+{
+    return fabsf(a - b) <= 1e-4f * fmaxf(1.0f, fabsf(b));
+}
+
+#define CHECK_MATRIX(M, V, N, mt, vt)                                                        \
+    {                                                                                        \
+        M a, b;                                                                              \
+        for (size_t i = 0; i < N*N; ++i) {                                                   \
+            a.m[i/N][i%N] = matrix_case(i);                                                  \
+            b.m[i/N][i%N] = matrix_case(i + 5);                                              \
+        }                                                                                    \
+        for (size_t i = 0; i < N; ++i) a.m[i][i] += 10.0f;                                   \
+        M ab = mt##_mul(a, b), at = mt##_transpose(a), ai = mt##_inverse(a);                 \
+        M aai = mt##_mul(a, ai);                                                             \
+        for (size_t c = 0; c < N; ++c) {                                                     \
+            for (size_t r = 0; r < N; ++r) {                                                 \
+                float e = 0.0f;                                                              \
+                for (size_t k = 0; k < N; ++k) e += a.m[k][r]*b.m[c][k];                     \
+                check(#mt"_mul", c*N + r, close_to(ab.m[c][r], e), ab.m[c][r], e);           \
+                check(#mt"_transpose", c*N + r, at.m[c][r] == a.m[r][c], at.m[c][r], a.m[r][c]); \
+                check(#mt"_inverse", c*N + r, close_to(aai.m[c][r], c == r), aai.m[c][r], c == r); \
+            }                                                                                \
+        }                                                                                    \
+        V vs[BATCH_LEN], rs[BATCH_LEN];                                                      \
+        for (size_t j = 0; j < BATCH_LEN; ++j) {                                             \
+            for (size_t k = 0; k < N; ++k) COMP(vs[j], k) = matrix_case(j*N + k);            \
+        }                                                                                    \
+        mt##_mul_##vt##_n(rs, a, vs, BATCH_LEN);                                             \
+        for (size_t j = 0; j < BATCH_LEN; ++j) {                                             \
+            V e = mt##_mul_##vt(a, vs[j]);                                                   \
+            for (size_t r = 0; r < N; ++r) {                                                 \
+                float d = 0.0f;                                                              \
+                for (size_t k = 0; k < N; ++k) d += a.m[k][r]*COMP(vs[j], k);                \
+                check(#mt"_mul_"#vt, j, close_to(COMP(e, r), d), COMP(e, r), d);             \
+                check(#mt"_mul_"#vt"_n", j, same_float(COMP(rs[j], r), COMP(e, r)), COMP(rs[j], r), COMP(e, r)); \
+            }                                                                                \
+        }                                                                                    \
+    }
+
+static void check_matrices(void)
+{
+    CHECK_MATRIX(M2f, V2f, 2, m2f, v2f)
+    CHECK_MATRIX(M3f, V3f, 3, m3f, v3f)
+    CHECK_MATRIX(M4f, V4f, 4, m4f, v4f)
+
+    A2f a = a2f_mul(a2f_translate(v2f(3.0f, -2.0f)), a2f_mul(a2f_rotate(0.7f), a2f_scale(v2f(2.0f, 0.5f))));
+    A2f ai = a2f_inverse(a);
+    V2f ps[BATCH_LEN], rs[BATCH_LEN];
+    for (size_t j = 0; j < BATCH_LEN; ++j) ps[j] = v2f(matrix_case(j), matrix_case(j + 1));
+    a2f_apply_n(rs, a, ps, BATCH_LEN);
+    for (size_t j = 0; j < BATCH_LEN; ++j) {
+        V2f p = a2f_apply(a, ps[j]);
+        V2f back = a2f_apply(ai, p);
+        check("a2f_apply_n", j, same_float(rs[j].x, p.x) && same_float(rs[j].y, p.y), rs[j].x, p.x);
+        check("a2f_inverse", j, close_to(back.x, ps[j].x) && close_to(back.y, ps[j].y), back.x, ps[j].x);
+    }
+}
+
+static double now_secs(void)
+{
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double) ts.tv_sec + (double) ts.tv_nsec * 1e-9;
+}
+
+// Called through a volatile pointer after every repetition, so the compiler
+// has to assume the results are used and cannot drop or merge the repetitions
+static void bench_use(void *results)
+{
+    (void) results;
+}
+static void (*volatile bench_sink)(void *results) = bench_use;
+
+static size_t repetitions = DEFAULT_REPETITIONS;
+
+static void bench_report(const char *op, double secs)
+{
+    double n = (double) repetitions * BENCH_LEN;
+    printf("  %-24s %9.3f ns/op %10.1f Mop/s\n", op, secs / n * 1e9, n / secs * 1e-6);
+}
+
+// Inputs in [0.5, 4), far from the denormals and the overflows
+#define BENCH_LOAD(xs, S, shift)                                                             \
+    for (size_t j = 0; j < BENCH_LEN; ++j) {                                                 \
+        for (size_t k = 0; k < COUNT(xs[j]); ++k) {                                          \
+            COMP(xs[j], k) = (S) (((j + k + (shift)) % 7 + 1) * 0.5);                        \
+        }                                                                                    \
+    }
+
+#define BENCH_LOOP(op, out, body)                                                            \
+    {                                                                                        \
+        double start = now_secs();                                                           \
+        for (size_t rep = 0; rep < repetitions; ++rep) {                                     \
+            for (size_t j = 0; j < BENCH_LEN; ++j) body;                                     \
+            bench_sink(out);                                                                 \
+        }                                                                                    \
+        bench_report(op, now_secs() - start);                                                \
+    }
+
+#define BENCH_BATCH(op, out, call)                                                           \
+    {                                                                                        \
+        double start = now_secs();                                                           \
+        for (size_t rep = 0; rep < repetitions; ++rep) {                                     \
+            call;                                                                            \
+            bench_sink(out);                                                                 \
+        }                                                                                    \
+        bench_report(op, now_secs() - start);                                                \
+    }
+
+#define DEFINE_BENCH_REAL(T, S, N, t, cases)                                                 \
+    static void bench_##t(void)                                                              \
+    {                                                                                        \
+        static T a[BENCH_LEN], b[BENCH_LEN], c[BENCH_LEN], r[BENCH_LEN];                     \
+        static S l[BENCH_LEN];                                                               \
+        BENCH_LOAD(a, S, 0);                                                                 \
+        BENCH_LOAD(b, S, 3);                                                                 \
+        BENCH_LOAD(c, S, 5);                                                                 \
+        printf("%s\n", #T);                                                                  \
+        BENCH_LOOP(#t"_sum", r, r[j] = t##_sum(a[j], b[j]))                                  \
+        BENCH_LOOP(#t"_sub", r, r[j] = t##_sub(a[j], b[j]))                                  \
+        BENCH_LOOP(#t"_mul", r, r[j] = t##_mul(a[j], b[j]))                                  \
+        BENCH_LOOP(#t"_div", r, r[j] = t##_div(a[j], b[j]))                                  \
+        BENCH_LOOP(#t"_sqrt", r, r[j] = t##_sqrt(a[j]))                                      \
+        BENCH_LOOP(#t"_pow", r, r[j] = t##_pow(a[j], b[j]))                                  \
+        BENCH_LOOP(#t"_sin", r, r[j] = t##_sin(a[j]))                                        \
+        BENCH_LOOP(#t"_cos", r, r[j] = t##_cos(a[j]))                                        \
+        BENCH_LOOP(#t"_min", r, r[j] = t##_min(a[j], b[j]))                                  \
+        BENCH_LOOP(#t"_max", r, r[j] = t##_max(a[j], b[j]))                                  \
+        BENCH_LOOP(#t"_lerp", r, r[j] = t##_lerp(a[j], b[j], c[j]))                          \
+        BENCH_LOOP(#t"_floor", r, r[j] = t##_floor(a[j]))                                    \
+        BENCH_LOOP(#t"_ceil", r, r[j] = t##_ceil(a[j]))                                      \
+        BENCH_LOOP(#t"_clamp", r, r[j] = t##_clamp(a[j], b[j], c[j]))                        \
+        BENCH_LOOP(#t"_len", l, l[j] = t##_len(a[j]))                                        \
+        BENCH_BATCH(#t"_sum_n", r, t##_sum_n(r, a, b, BENCH_LEN))                            \
+        BENCH_BATCH(#t"_mul_n", r, t##_mul_n(r, a, b, BENCH_LEN))                            \
+        BENCH_BATCH(#t"_div_n", r, t##_div_n(r, a, b, BENCH_LEN))                            \
+        BENCH_BATCH(#t"_sqrt_n", r, t##_sqrt_n(r, a, BENCH_LEN))                             \
+        BENCH_BATCH(#t"_min_n", r, t##_min_n(r, a, b, BENCH_LEN))                            \
+        BENCH_BATCH(#t"_lerp_n", r, t##_lerp_n(r, a, b, c, BENCH_LEN))                       \
+        BENCH_BATCH(#t"_clamp_n", r, t##_clamp_n(r, a, b, c, BENCH_LEN))                     \
+        BENCH_BATCH(#t"_len_n", l, t##_len_n(l, a, BENCH_LEN))                               \
+    }
+
+#define DEFINE_BENCH_INTEGER(T, S, N, t, cases)                                              \
+    static void bench_##t(void)                                                              \
+    {                                                                                        \
+        static T a[BENCH_LEN], b[BENCH_LEN], c[BENCH_LEN], r[BENCH_LEN];                     \
+        BENCH_LOAD(a, S, 0);                                                                 \
+        BENCH_LOAD(b, S, 3);                                                                 \
+        BENCH_LOAD(c, S, 5);                                                                 \
+        for (size_t j = 0; j < BENCH_LEN; ++j) {                                             \
+            for (size_t k = 0; k < N; ++k) COMP(b[j], k) += 1;                               \
+        }                                                                                    \
+        printf("%s\n", #T);                                                                  \
+        BENCH_LOOP(#t"_sum", r, r[j] = t##_sum(a[j], b[j]))                                  \
+        BENCH_LOOP(#t"_sub", r, r[j] = t##_sub(a[j], b[j]))                                  \
+        BENCH_LOOP(#t"_mul", r, r[j] = t##_mul(a[j], b[j]))                                  \
+        BENCH_LOOP(#t"_div", r, r[j] = t##_div(a[j], b[j]))                                  \
+        BENCH_LOOP(#t"_min", r, r[j] = t##_min(a[j], b[j]))                                  \
+        BENCH_LOOP(#t"_max", r, r[j] = t##_max(a[j], b[j]))                                  \
+        BENCH_LOOP(#t"_clamp", r, r[j] = t##_clamp(a[j], b[j], c[j]))                        \
+        BENCH_BATCH(#t"_sum_n", r, t##_sum_n(r, a, b, BENCH_LEN))                            \
+        BENCH_BATCH(#t"_mul_n", r, t##_mul_n(r, a, b, BENCH_LEN))                            \
+        BENCH_BATCH(#t"_div_n", r, t##_div_n(r, a, b, BENCH_LEN))                            \
+        BENCH_BATCH(#t"_min_n", r, t##_min_n(r, a, b, BENCH_LEN))                            \
+        BENCH_BATCH(#t"_clamp_n", r, t##_clamp_n(r, a, b, c, BENCH_LEN))                     \
+    }
+
+REAL_VECTORS(DEFINE_BENCH_REAL)
+INTEGER_VECTORS(DEFINE_BENCH_INTEGER)
+DEFINE_BENCH_REAL(V3fa, float, 3, v3fa, float_cases)
+DEFINE_BENCH_REAL(V4fa, float, 4, v4fa, float_cases)
+DEFINE_BENCH_REAL(V3da, double, 3, v3da, double_cases)
+DEFINE_BENCH_REAL(V4da, double, 4, v4da, double_cases)
+DEFINE_BENCH_INTEGER(V3ia, int, 3, v3ia, int_cases)
+DEFINE_BENCH_INTEGER(V4ia, int, 4, v4ia, int_cases)
+
+static void bench_fast(void)
+{
+    static float a[BENCH_LEN], b[BENCH_LEN], r[BENCH_LEN];
+    for (size_t j = 0; j < BENCH_LEN; ++j) {
+        a[j] = (float) (j % 97) * 0.25f + 0.125f;
+        b[j] = (float) (j % 13) * 0.25f - 1.5f;
+    }
+    printf("float (libm vs *_fast)\n");
+    BENCH_LOOP("sinf", r, r[j] = sinf(a[j]))
+    BENCH_BATCH("floats_sin_fast_n", r, floats_sin_fast_n(r, a, BENCH_LEN))
+    BENCH_LOOP("cosf", r, r[j] = cosf(a[j]))
+    BENCH_BATCH("floats_cos_fast_n", r, floats_cos_fast_n(r, a, BENCH_LEN))
+    BENCH_LOOP("expf", r, r[j] = expf(b[j]))
+    BENCH_BATCH("floats_exp_fast_n", r, floats_exp_fast_n(r, b, BENCH_LEN))
+    BENCH_LOOP("logf", r, r[j] = logf(a[j]))
+    BENCH_BATCH("floats_log_fast_n", r, floats_log_fast_n(r, a, BENCH_LEN))
+    BENCH_LOOP("powf", r, r[j] = powf(a[j], b[j]))
+    BENCH_BATCH("floats_pow_fast_n", r, floats_pow_fast_n(r, a, b, BENCH_LEN))
+    BENCH_LOOP("1/sqrtf", r, r[j] = 1.0f / sqrtf(a[j]))
+    BENCH_BATCH("floats_rsqrt_fast_n", r, floats_rsqrt_fast_n(r, a, BENCH_LEN))
+}
+
+static void bench_matrices(void)
+{
+    static V4f v[BENCH_LEN], r[BENCH_LEN];
+    static V2f p[BENCH_LEN], q[BENCH_LEN];
+    BENCH_LOAD(v, float, 0);
+    BENCH_LOAD(p, float, 0);
+    M4f m = m4f_ortho(-1.0f, 2.0f, -3.0f, 4.0f, 0.5f, 10.0f);
+    A2f a = a2f_mul(a2f_rotate(0.3f), a2f_scale(v2f(2.0f, 3.0f)));
+    printf("matrices\n");
+    BENCH_LOOP("m4f_mul_v4f", r, r[j] = m4f_mul_v4f(m, v[j]))
+    BENCH_BATCH("m4f_mul_v4f_n", r, m4f_mul_v4f_n(r, m, v, BENCH_LEN))
+    BENCH_LOOP("a2f_apply", q, q[j] = a2f_apply(a, p[j]))
+    BENCH_BATCH("a2f_apply_n", q, a2f_apply_n(q, a, p, BENCH_LEN))
+}
+
+int main(int argc, char **argv)
+{
+    if (argc > 1) {
+        char *end = NULL;
+        long long n = strtoll(argv[1], &end, 10);
+        if (end == argv[1] || *end != '\0' || n < 0) {
+            fprintf(stderr, "Usage: %s [repetitions]\n", argv[0]);
+            fprintf(stderr, "ERROR: invalid amount of repetitions `%s`\n", argv[1]);
+            return 1;
+        }
+        repetitions = (size_t) n;
+    }
+
+    printf("la.h paths: SSE2=%d SSE4.1=%d AVX=%d\n", LA_SSE2, LA_SSE41, LA_AVX);
+
+#define X(T, S, N, t, cases) check_##t();
+    REAL_VECTORS(X)
+    INTEGER_VECTORS(X)
+#undef X
+#define X(T, TA, t, to, from, cases) check_##t##a();
+    ALIGNED_REAL_VECTORS(X)
+    ALIGNED_INTEGER_VECTORS(X)
+#undef X
+    check_fast();
+    check_matrices();
+    if (failures > 0) {
+        fprintf(stderr, "ERROR: %zu checks of la.h failed\n", failures);
+        return 1;
+    }
+    printf("All checks passed\n");
+    if (repetitions == 0) return 0;
+
+#define X(T, S, N, t, cases) bench_##t();
+    REAL_VECTORS(X)
+    INTEGER_VECTORS(X)
+#undef X
+    bench_v3fa();
+    bench_v4fa();
+    bench_v3da();
+    bench_v4da();
+    bench_v3ia();
+    bench_v4ia();
+    bench_fast();
+    bench_matrices();
+
+    return 0;
+}
@@ -3,6 +3,7 @@
 #include <stdlib.h>
 #include <stdarg.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <string.h>
 #include <errno.h>
 #include <math.h>
@@ -19,13 +20,31 @@
 #define DEFAULT_SCREEN_WIDTH 1600
 #define DEFAULT_SCREEN_HEIGHT 900
 #define MANUAL_TIME_STEP 0.1
+// How long to sleep when nothing on the screen has changed
+#define IDLE_WAIT_SECS 0.1
 
 #define COLOR_BLACK_V4F ((V4f){0.0f, 0.0f, 0.0f, 1.0f})
 #define COLOR_RED_V4F ((V4f){1.0f, 0.0f, 0.0f, 1.0f})
 #define COLOR_GREEN_V4F ((V4f){0.0f, 1.0f, 0.0f, 1.0f})
 #define COLOR_BLUE_V4F ((V4f){0.0f, 0.0f, 1.0f, 1.0f})
 
+// The measuring builds run in a hidden window without vsync
+#if defined(BENCH) || defined(STRESS)
+#define HEADLESS
+#endif
+
 #include "glextloader.c"
+#include "grid.c"
+#include "collision.c"
+#include "jobs.c"
+#include "queue.c"
+#include "trace.c"
+#include "timing.c"
+#include "resolution.c"
+#include "input.c"
+#include "graph.c"
+#include "conf.c"
+#include "fingerprint.c"
 
 #define STB_IMAGE_IMPLEMENTATION
 #include "stb_image.h"
@@ -149,25 +168,47 @@ typedef enum {
     RESOLUTION_UNIFORM = 0,
     TIME_UNIFORM,
     MOUSE_UNIFORM,
+    // Part of the input textures that was rendered into
+    TEX_SCALE_UNIFORM,
+    // Maps the vertex positions to NDC
+    TRANSFORM_UNIFORM,
     TEX_UNIFORM,
+    // The rest of the inputs of the post passes
+    TEX1_UNIFORM,
+    TEX2_UNIFORM,
+    TEX3_UNIFORM,
     COUNT_UNIFORMS
 } Uniform;
 
-static_assert(COUNT_UNIFORMS == 4, "Update list of uniform names");
+static_assert(COUNT_UNIFORMS == 9, "Update list of uniform names");
 static const char *uniform_names[COUNT_UNIFORMS] = {
     [RESOLUTION_UNIFORM] = "resolution",
     [TIME_UNIFORM] = "time",
     [MOUSE_UNIFORM] = "mouse",
+    [TEX_SCALE_UNIFORM] = "tex_scale",
+    [TRANSFORM_UNIFORM] = "transform",
     [TEX_UNIFORM] = "tex",
+    [TEX1_UNIFORM] = "tex1",
+    [TEX2_UNIFORM] = "tex2",
+    [TEX3_UNIFORM] = "tex3",
 };
+static_assert(TEX_UNIFORM + GRAPH_INPUTS_CAP == COUNT_UNIFORMS, "Every input of a pass needs a sampler");
 
+// SCENE is always the first program. The post passes follow it in the order
+// they are declared in render.conf, each one reading the output of the previous one.
+#define POST_PASSES_CAP (GRAPH_PASSES_CAP - 1)
 typedef enum {
     PROGRAM_SCENE = 0,
-    PROGRAM_POST0,
-    PROGRAM_POST1,
+    PROGRAM_POST,
+    // Built in pass that brings the output of the passes from the dynamic
+    // resolution to the screen
+    PROGRAM_UPSCALE = PROGRAM_POST + POST_PASSES_CAP,
     COUNT_PROGRAMS
 } Program;
 
+#define UPSCALE_VERT_PATH "shaders/screen.vert"
+#define UPSCALE_FRAG_PATH "shaders/upscale.frag"
+
 typedef enum {
     VA_POS = 0,
     VA_UV,
@@ -175,52 +216,92 @@ typedef enum {
     COUNT_VAS,
 } Vertex_Attrib;
 
+// Aligned to 16 bytes, so `pos` with `uv` and `color` are full SSE registers
+// that are copied into the vertex buffer with aligned stores
 typedef struct {
-    V2f pos;
+    _Alignas(16) V2f pos;
     V2f uv;
     V4f color;
 } Vertex;
+static_assert(sizeof(Vertex) == 32, "Vertex must stay two 16-byte halves");
 
-#define VERTEX_BUF_CAP (8 * 1024)
+#define VERTEX_BUF_INITIAL_CAP (8 * 1024)
 typedef struct {
     bool reload_failed;
+    // Change on every reload, the new programs may get the ids of the old ones
+    size_t program_versions[COUNT_PROGRAMS];
     GLuint vao;
     GLuint vbo;
+    // Capacity of the vbo in vertices
+    size_t vbo_cap;
     GLuint programs[COUNT_PROGRAMS];
     GLint uniforms[COUNT_PROGRAMS][COUNT_UNIFORMS];
     size_t vertex_buf_sz;
-    Vertex vertex_buf[VERTEX_BUF_CAP];
+    size_t vertex_buf_cap;
+    Vertex *vertex_buf;
 } Renderer;
 
 // Global variables (fragile people with CS degree look away)
-static double time = 0.0;
-static bool pause = false;
+static double scene_time = 0.0;
+static bool paused = false;
 static GLuint user_texture = 0;
+static size_t user_texture_version = 0;
 static Renderer global_renderer = {0};
 
+// Reserves `count` vertices at the end of the vertex buffer so they can be
+// filled in later (possibly from several threads at once). The buffer grows
+// as needed, so the pointer is only valid until the next r_reserve().
+Vertex *r_reserve(Renderer *r, size_t count)
+{
+    if (r->vertex_buf_sz + count > r->vertex_buf_cap) {
+        size_t new_cap = r->vertex_buf_cap > 0 ? r->vertex_buf_cap : VERTEX_BUF_INITIAL_CAP;
+        while (new_cap < r->vertex_buf_sz + count) new_cap *= 2;
+        Vertex *new_buf = la_aligned_alloc(_Alignof(Vertex), new_cap * sizeof(*new_buf));
+        if (new_buf == NULL) {
+            fprintf(stderr, "ERROR: could not allocate memory for %zu vertices: %s\n",
+                    new_cap, strerror(errno));
+            exit(1);
+        }
+        if (r->vertex_buf_sz > 0) memcpy(new_buf, r->vertex_buf, r->vertex_buf_sz * sizeof(*new_buf));
+        la_aligned_free(r->vertex_buf);
+        r->vertex_buf = new_buf;
+        r->vertex_buf_cap = new_cap;
+    }
+    Vertex *vertices = &r->vertex_buf[r->vertex_buf_sz];
+    r->vertex_buf_sz += count;
+    return vertices;
+}
+
+void r_clear(Renderer *r)
+{
+    r->vertex_buf_sz = 0;
+}
+
 void r_vertex(Renderer *r, V2f pos, V2f uv, V4f color)
 {
-    assert(r->vertex_buf_sz < VERTEX_BUF_CAP);
-    r->vertex_buf[r->vertex_buf_sz].pos = pos;
-    r->vertex_buf[r->vertex_buf_sz].uv = uv;
-    r->vertex_buf[r->vertex_buf_sz].color = color;
-    r->vertex_buf_sz += 1;
+    *r_reserve(r, 1) = (Vertex) {pos, uv, color};
 }
 
-void r_quad_pp(Renderer *r, V2f p1, V2f p2, V4f color)
+#define QUAD_VERTICES 6
+void quad_pp_vertices(Vertex *vertices, V2f p1, V2f p2, V4f color)
 {
     V2f a = p1;
     V2f b = v2f(p2.x, p1.y);
     V2f c = v2f(p1.x, p2.y);
     V2f d = p2;
 
-    r_vertex(r, a, v2f(0.0f, 0.0f), color);
-    r_vertex(r, b, v2f(1.0f, 0.0f), color);
-    r_vertex(r, c, v2f(0.0f, 1.0f), color);
+    vertices[0] = (Vertex) {a, v2f(0.0f, 0.0f), color};
+    vertices[1] = (Vertex) {b, v2f(1.0f, 0.0f), color};
+    vertices[2] = (Vertex) {c, v2f(0.0f, 1.0f), color};
 
-    r_vertex(r, b, v2f(1.0f, 0.0f), color);
-    r_vertex(r, c, v2f(0.0f, 1.0f), color);
-    r_vertex(r, d, v2f(1.0f, 1.0f), color);
+    vertices[3] = (Vertex) {b, v2f(1.0f, 0.0f), color};
+    vertices[4] = (Vertex) {c, v2f(0.0f, 1.0f), color};
+    vertices[5] = (Vertex) {d, v2f(1.0f, 1.0f), color};
+}
+
+void r_quad_pp(Renderer *r, V2f p1, V2f p2, V4f color)
+{
+    quad_pp_vertices(r_reserve(r, QUAD_VERTICES), p1, p2, color);
 }
 
 void r_quad_cr(Renderer *r, V2f center, V2f radius, V4f color)
@@ -228,12 +309,34 @@ void r_quad_cr(Renderer *r, V2f center, V2f radius, V4f color)
     r_quad_pp(r, v2f_sub(center, radius), v2f_sum(center, radius), color);
 }
 
+// Quad covering the whole screen as a triangle strip. Has the same vertex
+// order as quad.vert, so the post passes can use either of the vertex shaders.
+#define SCREEN_STRIP_VERTICES 4
+void r_screen_strip(Renderer *r, float width, float height)
+{
+    Vertex *vertices = r_reserve(r, SCREEN_STRIP_VERTICES);
+    float w = width * 0.5f;
+    float h = height * 0.5f;
+    vertices[0] = (Vertex) {v2f(-w, -h), v2f(0.0f, 0.0f), COLOR_BLACK_V4F};
+    vertices[1] = (Vertex) {v2f( w, -h), v2f(1.0f, 0.0f), COLOR_BLACK_V4F};
+    vertices[2] = (Vertex) {v2f(-w,  h), v2f(0.0f, 1.0f), COLOR_BLACK_V4F};
+    vertices[3] = (Vertex) {v2f( w,  h), v2f(1.0f, 1.0f), COLOR_BLACK_V4F};
+}
+
 void r_sync_buffers(Renderer *r)
 {
+    stage_begin(STAGE_SYNC_BUFFERS);
+    if (r->vertex_buf_sz > r->vbo_cap) {
+        // Grow the vbo to the capacity of the CPU side buffer, so it does not
+        // have to be reallocated on every new maximum
+        r->vbo_cap = r->vertex_buf_cap;
+        glBufferData(GL_ARRAY_BUFFER, r->vbo_cap * sizeof(Vertex), NULL, GL_DYNAMIC_DRAW);
+    }
     glBufferSubData(GL_ARRAY_BUFFER,
                     0,
                     sizeof(Vertex) * r->vertex_buf_sz,
                     r->vertex_buf);
+    stage_end(STAGE_SYNC_BUFFERS);
 }
 
 void r_sync_uniforms(Renderer *r,
@@ -241,13 +344,23 @@ void r_sync_uniforms(Renderer *r,
                      GLfloat resolution_width, GLfloat resolution_height,
                      GLfloat time,
                      GLfloat mouse_x, GLfloat mouse_y,
+                     GLfloat tex_scale_x, GLfloat tex_scale_y,
+                     A2f view,
                      GLint tex_unit)
 {
-    static_assert(COUNT_UNIFORMS == 4, "Exhaustive uniform handling in ");
+    static_assert(COUNT_UNIFORMS == 9, "Exhaustive uniform handling in ");
     glUniform2f(r->uniforms[program][RESOLUTION_UNIFORM], resolution_width, resolution_height);
     glUniform1f(r->uniforms[program][TIME_UNIFORM], time);
     glUniform2f(r->uniforms[program][MOUSE_UNIFORM], mouse_x, mouse_y);
-    glUniform1i(r->uniforms[program][TEX_UNIFORM], tex_unit);
+    glUniform2f(r->uniforms[program][TEX_SCALE_UNIFORM], tex_scale_x, tex_scale_y);
+    // `view` moves the vertices around the center of the screen, then they are projected to NDC
+    A2f projection = a2f_scale(v2f(2.0f / resolution_width, 2.0f / resolution_height));
+    M3f transform = m3f_a2f(a2f_mul(projection, view));
+    glUniformMatrix3fv(r->uniforms[program][TRANSFORM_UNIFORM], 1, GL_FALSE, &transform.m[0][0]);
+    // The inputs are bound to the consecutive texture units
+    for (Uniform u = TEX_UNIFORM; u <= TEX3_UNIFORM; ++u) {
+        glUniform1i(r->uniforms[program][u], tex_unit + (u - TEX_UNIFORM));
+    }
 }
 
 bool load_shader_program(const char *vertex_file_path,
@@ -271,37 +384,203 @@ bool load_shader_program(const char *vertex_file_path,
     return true;
 }
 
+static const char *render_conf_path = "render.conf";
 static char *render_conf = NULL;
+static Conf render_conf_entries = {0};
 
 typedef struct {
     float x, y, dx, dy;
 } Object;
 
-#define OBJECTS_CAP 1024
-Object objects[OBJECTS_CAP];
+// The grid indexes the objects with uint32_t. The storage itself grows on demand.
+#define OBJECTS_CAP (16 * 1024 * 1024)
+Object *objects = NULL;
 size_t objects_count = 0;
+static size_t objects_capacity = 0;
+
+// Spatial index over the objects used to cull the ones that are outside of the screen
+static Grid objects_grid = {0};
+static uint32_t *visible_objects = NULL;
+static uint32_t *picked_objects = NULL;
+static size_t objects_drawn = 0;
+static size_t objects_culled = 0;
+// Changes whenever the objects may have moved or changed their size, so the
+// vertices of the SCENE pass are not generated again while it stays the same
+static uint64_t scene_version = 0;
 
 static const char *vert_path[COUNT_PROGRAMS] = {0};
 static const char *frag_path[COUNT_PROGRAMS] = {0};
+static size_t post_passes_count = 0;
+static Graph render_graph = {0};
 static const char *texture_path = NULL;
 static float follow_scale = 1.0f;
 static float object_size = 100.0f;
 static float rotate_radius = 500.0f;
 static float rotate_speed = 4.0f;
+static bool collisions = false;
+
+static size_t threads_count = 0;
+static float stats_interval = 0.0f;
+static bool trace_on_exit = false;
+static Resolution resolution = {
+    .min_scale = 0.5f,
+    .scale = 1.0f,
+};
+
+#define TRACE_JSON_PATH "trace.json"
+void trace_dump_at_exit(void)
+{
+    if (trace_on_exit) trace_dump(TRACE_JSON_PATH);
+}
+
+// Makes room for `count` objects. The new objects start at the origin.
+void objects_reserve(size_t count)
+{
+    if (count <= objects_capacity) return;
+
+    size_t new_capacity = objects_capacity > 0 ? objects_capacity : 1024;
+    while (new_capacity < count) new_capacity *= 2;
+    Object *new_objects = realloc(objects, new_capacity * sizeof(*new_objects));
+    uint32_t *new_visible = realloc(visible_objects, new_capacity * sizeof(*new_visible));
+    uint32_t *new_picked = realloc(picked_objects, new_capacity * sizeof(*new_picked));
+    if (new_objects != NULL) objects = new_objects;
+    if (new_visible != NULL) visible_objects = new_visible;
+    if (new_picked != NULL) picked_objects = new_picked;
+    if (new_objects == NULL || new_visible == NULL || new_picked == NULL) {
+        fprintf(stderr, "ERROR: could not allocate memory for %zu objects: %s\n",
+                new_capacity, strerror(errno));
+        exit(1);
+    }
 
-void object_render(Renderer *r, Object *object)
+    memset(&objects[objects_capacity], 0, (new_capacity - objects_capacity) * sizeof(*objects));
+    objects_capacity = new_capacity;
+}
+
+void object_vertices(Vertex *vertices, const Object *object)
 {
-    r_quad_cr(
-        r,
-        v2f(object->x, object->y),
-        v2ff(object_size),
+    V2f center = v2f(object->x, object->y);
+    V2f radius = v2ff(object_size);
+    quad_pp_vertices(
+        vertices,
+        v2f_sub(center, radius),
+        v2f_sum(center, radius),
         COLOR_BLACK_V4F);
 }
 
+#define OBJECTS_RENDER_GRAIN 1024
+static void objects_render_range(void *data, size_t begin, size_t end)
+{
+    Vertex *vertices = data;
+    for (size_t i = begin; i < end; ++i) {
+        object_vertices(&vertices[i * QUAD_VERTICES], &objects[visible_objects[i]]);
+    }
+}
+
+static int compare_object_indices_desc(const void *a, const void *b)
+{
+    uint32_t x = *(const uint32_t*) a;
+    uint32_t y = *(const uint32_t*) b;
+    return (x < y) - (x > y);
+}
+
+void objects_render_visible(Renderer *r, float width, float height)
+{
+    // The grid indexes the centers of the objects, so expand the screen by the object radius
+    float half_width = width * 0.5f + object_size;
+    float half_height = height * 0.5f + object_size;
+    size_t visible_count = grid_query(&objects_grid,
+                                      -half_width, -half_height,
+                                      half_width, half_height,
+                                      visible_objects, objects_capacity);
+
+    // Preserve the original drawing order: the first object is drawn on top of everything
+    qsort(visible_objects, visible_count, sizeof(visible_objects[0]), compare_object_indices_desc);
+    Vertex *vertices = r_reserve(r, visible_count * QUAD_VERTICES);
+    jobs_parallel_for(visible_count, OBJECTS_RENDER_GRAIN, objects_render_range, vertices);
+
+    objects_drawn = visible_count;
+    objects_culled = objects_count - visible_count;
+}
+
+void objects_grid_rebuild(void)
+{
+    grid_reset(&objects_grid, object_size * 2.0f, objects_count);
+    for (size_t i = 0; i < objects_count; ++i) {
+        grid_update(&objects_grid, (uint32_t) i, objects[i].x, objects[i].y);
+    }
+}
+
+static Collision_Pairs collision_pairs = {0};
+static Collision_Stats collision_stats = {0};
+
+// Pushes the overlapping objects apart along the axis of the smallest penetration
+void objects_resolve_collisions(void)
+{
+    double start = glfwGetTime();
+    collision_broad_phase(&objects_grid, &collision_pairs);
+    double broad_end = glfwGetTime();
+    collision_stats.candidates = collision_pairs.count;
+    collision_stats.hits = collision_narrow_phase(&objects_grid, object_size, &collision_pairs);
+    collision_stats.broad_phase_secs = broad_end - start;
+    collision_stats.narrow_phase_secs = glfwGetTime() - broad_end;
+
+    if (paused) return;
+
+    float size = object_size * 2.0f;
+    for (size_t i = 0; i < collision_pairs.count; ++i) {
+        Object *a = &objects[collision_pairs.items[i].a];
+        Object *b = &objects[collision_pairs.items[i].b];
+        float dx = b->x - a->x;
+        float dy = b->y - a->y;
+        float px = size - fabsf(dx);
+        float py = size - fabsf(dy);
+        if (px < py) {
+            float push = (dx < 0.0f ? -px : px) * 0.5f;
+            a->x -= push;
+            b->x += push;
+        } else {
+            float push = (dy < 0.0f ? -py : py) * 0.5f;
+            a->y -= push;
+            b->y += push;
+        }
+    }
+
+    for (size_t i = 0; i < collision_pairs.count; ++i) {
+        uint32_t a = collision_pairs.items[i].a;
+        uint32_t b = collision_pairs.items[i].b;
+        grid_update(&objects_grid, a, objects[a].x, objects[a].y);
+        grid_update(&objects_grid, b, objects[b].x, objects[b].y);
+    }
+}
+
+// Finds the topmost object under the point in scene coordinates. The objects
+// with lower indices are drawn on top. Only the cells around the point are
+// visited, so the cost does not depend on the total amount of objects.
+bool objects_pick(float x, float y, size_t *index)
+{
+    size_t picked_count = grid_query(&objects_grid,
+                                     x - object_size, y - object_size,
+                                     x + object_size, y + object_size,
+                                     picked_objects, objects_capacity);
+    if (picked_count == 0) return false;
+
+    uint32_t topmost = picked_objects[0];
+    for (size_t i = 1; i < picked_count; ++i) {
+        if (picked_objects[i] < topmost) topmost = picked_objects[i];
+    }
+    if (index) *index = topmost;
+    return true;
+}
+
+static bool dragging = false;
+static size_t dragged_object = 0;
+static float drag_offset_x = 0.0f;
+static float drag_offset_y = 0.0f;
+
 void object_update(Object *obj, float delta_time,
                    float target_x, float target_y)
 {
-    if (!pause) {
+    if (!paused) {
         obj->x += delta_time * obj->dx;
         obj->y += delta_time * obj->dy;
         obj->dx = (target_x - obj->x) * follow_scale;
@@ -309,8 +588,159 @@ void object_update(Object *obj, float delta_time,
     }
 }
 
+// Every object follows the previous one, the first one follows the cursor
+void objects_update(float delta_time, float xpos, float ypos)
+{
+    float follow_x = xpos + sin(scene_time * rotate_speed) * rotate_radius;
+    float follow_y = ypos + cos(scene_time * rotate_speed) * rotate_radius;
+
+    object_update(&objects[0], delta_time, follow_x, follow_y);
+    for (size_t i = 1; i < objects_count; ++i) {
+        object_update(&objects[i], delta_time, objects[i - 1].x, objects[i - 1].y);
+    }
+
+    // objects_count may shrink on F5 while dragging
+    if (dragging && dragged_object < objects_count) {
+        Object *obj = &objects[dragged_object];
+        obj->x = xpos + drag_offset_x;
+        obj->y = ypos + drag_offset_y;
+        obj->dx = 0.0f;
+        obj->dy = 0.0f;
+    }
+
+    for (size_t i = 0; i < objects_count; ++i) {
+        grid_update(&objects_grid, (uint32_t) i, objects[i].x, objects[i].y);
+    }
+    // Paused objects only move when one of them is dragged (the collisions are paused too)
+    if (!paused || dragging) scene_version += 1;
+}
+
+typedef enum {
+    PASS_KEY_VERT = 0,
+    PASS_KEY_FRAG,
+    PASS_KEY_INPUT,
+    PASS_KEY_OUTPUT,
+    COUNT_PASS_KEYS
+} Pass_Key;
+
+static_assert(COUNT_PASS_KEYS == 4, "Update list of pass key names");
+static const char *pass_key_names[COUNT_PASS_KEYS] = {
+    [PASS_KEY_VERT] = "vert",
+    [PASS_KEY_FRAG] = "frag",
+    [PASS_KEY_INPUT] = "input",
+    [PASS_KEY_OUTPUT] = "output",
+};
+
+// Parses the keys like `vert[NAME]`
+static bool parse_pass_key(String_View key, Pass_Key *kind, String_View *name)
+{
+    for (Pass_Key k = 0; k < COUNT_PASS_KEYS; ++k) {
+        String_View prefix = sv_from_cstr(pass_key_names[k]);
+        if (key.count < prefix.count + 3 || !sv_starts_with(key, prefix)) continue;
+        if (key.data[prefix.count] != '[' || key.data[key.count - 1] != ']') continue;
+        *kind = k;
+        *name = sv_from_parts(key.data + prefix.count + 1, key.count - prefix.count - 2);
+        return true;
+    }
+    return false;
+}
+
+// SCENE is the scene program, any other name declares a new post pass the
+// first time it is mentioned
+static bool program_by_name(String_View name, Program *program)
+{
+    for (Program p = 0; p < PROGRAM_POST + post_passes_count; ++p) {
+        if (sv_eq(render_graph.passes[p].name, name)) {
+            *program = p;
+            return true;
+        }
+    }
+    if (post_passes_count >= POST_PASSES_CAP) return false;
+    *program = PROGRAM_POST + post_passes_count;
+    render_graph.passes[*program].name = name;
+    post_passes_count += 1;
+    render_graph.passes_count = PROGRAM_POST + post_passes_count;
+    return true;
+}
+
+typedef enum {
+    CONF_KEY_TEXTURE = 0,
+    CONF_KEY_FOLLOW_SCALE,
+    CONF_KEY_OBJECT_SIZE,
+    CONF_KEY_ROTATE_RADIUS,
+    CONF_KEY_ROTATE_SPEED,
+    CONF_KEY_RESOLUTION_BUDGET_MS,
+    CONF_KEY_RESOLUTION_MIN_SCALE,
+    CONF_KEY_STATS_INTERVAL,
+    CONF_KEY_TRACE_ON_EXIT,
+    CONF_KEY_THREADS,
+    CONF_KEY_COLLISIONS,
+    CONF_KEY_OBJECTS_COUNT,
+    COUNT_CONF_KEYS
+} Conf_Key;
+
+static_assert(COUNT_CONF_KEYS == 12, "Update list of conf key names");
+static const char *conf_key_names[COUNT_CONF_KEYS] = {
+    [CONF_KEY_TEXTURE] = "texture",
+    [CONF_KEY_FOLLOW_SCALE] = "follow_scale",
+    [CONF_KEY_OBJECT_SIZE] = "object_size",
+    [CONF_KEY_ROTATE_RADIUS] = "rotate_radius",
+    [CONF_KEY_ROTATE_SPEED] = "rotate_speed",
+    [CONF_KEY_RESOLUTION_BUDGET_MS] = "resolution_budget_ms",
+    [CONF_KEY_RESOLUTION_MIN_SCALE] = "resolution_min_scale",
+    [CONF_KEY_STATS_INTERVAL] = "stats_interval",
+    [CONF_KEY_TRACE_ON_EXIT] = "trace_on_exit",
+    [CONF_KEY_THREADS] = "threads",
+    [CONF_KEY_COLLISIONS] = "collisions",
+    [CONF_KEY_OBJECTS_COUNT] = "objects_count",
+};
+
+// conf_key_names -> Conf_Key, filled on the first lookup
+static SV_Map conf_keys = {0};
+
+static bool conf_key_by_name(String_View name, Conf_Key *key)
+{
+    if (conf_keys.count == 0) {
+        for (Conf_Key k = 0; k < COUNT_CONF_KEYS; ++k) {
+            if (!sv_map_put(&conf_keys, sv_from_cstr(conf_key_names[k]), k)) {
+                fprintf(stderr, "ERROR: could not allocate memory for the config keys\n");
+                exit(1);
+            }
+        }
+    }
+
+    size_t index;
+    if (!sv_map_get(&conf_keys, name, &index)) return false;
+    *key = (Conf_Key) index;
+    return true;
+}
+
+// The paths are passed to fopen(), so they are NULL-terminated right in
+// `render_conf`.
+// SAFETY NOTES: This should not cause any problems because the original string `render_conf`
+// that we are processing the `value` from is mutable, NULL-terminated and we are splitting
+// it by newlines which garantees that there is always a character after
+// the end of `value`.
+//
+// Let's consider an example where `render_conf` is equal to this:
+//
+// ```
+// key = value\n
+// key = value\n
+// key = value\0
+// ```
+//
+// There is always something after `value`. It's either `\n` or `\0`. With all of these
+// invariats in place writing to `value.data[value.count]` should be safe.
+static const char *render_conf_path_cstr(String_View value)
+{
+    ((char*)value.data)[value.count] = '\0';
+    return value.data;
+}
+
 void reload_render_conf(const char *render_conf_path)
 {
+    TRACE_BEGIN("reload_render_conf");
     if (render_conf) free(render_conf);
 
     render_conf = slurp_file_into_malloced_cstr(render_conf_path);
@@ -325,83 +755,255 @@ void reload_render_conf(const char *render_conf_path)
         vert_path[p] = NULL;
         frag_path[p] = NULL;
     }
+    vert_path[PROGRAM_UPSCALE] = UPSCALE_VERT_PATH;
+    frag_path[PROGRAM_UPSCALE] = UPSCALE_FRAG_PATH;
+    graph_reset(&render_graph);
+    render_graph.passes[PROGRAM_SCENE].name = SV("SCENE");
+    render_graph.passes_count = PROGRAM_POST;
+    post_passes_count = 0;
     texture_path = NULL;
-    for (int row = 0; content.count > 0; row++) {
-        String_View line = sv_chop_by_delim(&content, '\n');
-        const char *line_start = line.data;
-        line = sv_trim_left(line);
-
-        if (line.count > 0 && line.data[0] != '#') {
-            String_View key = sv_trim(sv_chop_by_delim(&line, '='));
-            String_View value = sv_trim_left(line);
-
-            ((char*)value.data)[value.count] = '\0';
-            // ^^^SAFETY NOTES: this is needed so we can use `value` as a NULL-terminated C-string.
-            // This should not cause any problems because the original string `render_conf`
-            // that we are processing the `value` from is mutable, NULL-terminated and we are splitting
-            // it by newlines which garantees that there is always a character after
-            // the end of `value`.
-            //
-            // Let's consider an example where `render_conf` is equal to this:
-            //
-            // ```
-            // key = value\n
-            // key = value\n
-            // key = value\0
-            // ```
-            //
-            // There is always something after `value`. It's either `\n` or `\0`. With all of these
-            // invariats in place writing to `value.data[value.count]` should be safe.
-
-            static_assert(COUNT_PROGRAMS == 3, "Exhaustive handling of shader programs in config parsing");
-            if (sv_eq(key, SV("vert[SCENE]"))) {
-                vert_path[PROGRAM_SCENE] = value.data;
-            } else if (sv_eq(key, SV("frag[SCENE]"))) {
-                frag_path[PROGRAM_SCENE] = value.data;
-            } else if (sv_eq(key, SV("vert[POST0]"))) {
-                vert_path[PROGRAM_POST0] = value.data;
-            } else if (sv_eq(key, SV("frag[POST0]"))) {
-                frag_path[PROGRAM_POST0] = value.data;
-            } else if (sv_eq(key, SV("vert[POST1]"))) {
-                vert_path[PROGRAM_POST1] = value.data;
-            } else if (sv_eq(key, SV("frag[POST1]"))) {
-                frag_path[PROGRAM_POST1] = value.data;
-            } else if (sv_eq(key, SV("texture"))) {
-                texture_path = value.data;
-            } else if (sv_eq(key, SV("follow_scale"))) {
-                follow_scale = strtof(value.data, NULL);
-            } else if (sv_eq(key, SV("object_size"))) {
-                object_size = strtof(value.data, NULL);
-            } else if (sv_eq(key, SV("rotate_radius"))) {
-                rotate_radius = strtof(value.data, NULL);
-            } else if (sv_eq(key, SV("rotate_speed"))) {
-                rotate_speed = strtof(value.data, NULL);
-            } else if (sv_eq(key, SV("objects_count"))) {
-                objects_count = strtol(value.data, NULL, 10);
-                if (objects_count > OBJECTS_CAP) {
-                    printf("%s:%d:%ld: WARNING: objects_count overflow\n",
-                           render_conf_path, row, key.data - line_start);
-                    objects_count = OBJECTS_CAP;
-                }
-            } else {
-                printf("%s:%d:%ld: ERROR: unsupported key `"SV_Fmt"`\n",
-                       render_conf_path, row, key.data - line_start,
-                       SV_Arg(key));
+    if (!conf_parse(&render_conf_entries, content)) exit(1);
+    for (size_t i = 0; i < render_conf_entries.entries_count; ++i) {
+        const Conf_Entry *entry = &render_conf_entries.entries[i];
+        String_View key = entry->key;
+        String_View value = entry->value;
+        int row = entry->row;
+        const char *line_start = entry->line_start;
+        bool number_ok = true;
+        int64_t integer;
+        uint64_t count;
+
+        Pass_Key pass_key;
+        String_View pass_name;
+        Program program;
+        Conf_Key conf_key;
+        if (parse_pass_key(key, &pass_key, &pass_name)) {
+            if (!program_by_name(pass_name, &program)) {
+                printf("%s:%d:%ld: ERROR: too many post passes, only %d are supported\n",
+                       render_conf_path, row, key.data - line_start, POST_PASSES_CAP);
                 continue;
             }
 
-            printf(SV_Fmt" = %s\n", SV_Arg(key), value.data);
+            Graph_Pass *pass = &render_graph.passes[program];
+            switch (pass_key) {
+            case PASS_KEY_VERT:
+                vert_path[program] = render_conf_path_cstr(value);
+                break;
+
+            case PASS_KEY_FRAG:
+                frag_path[program] = render_conf_path_cstr(value);
+                break;
+
+            case PASS_KEY_INPUT: {
+                // Space separated list of the resources
+                pass->inputs_count = 0;
+                pass->inputs_declared = true;
+                String_View inputs = value;
+                while (inputs.count > 0) {
+                    String_View input = sv_chop_by_delim(&inputs, ' ');
+                    if (input.count == 0) continue;
+                    if (pass->inputs_count >= GRAPH_INPUTS_CAP) {
+                        printf("%s:%d:%ld: ERROR: too many inputs, only %d are supported\n",
+                               render_conf_path, row, key.data - line_start, GRAPH_INPUTS_CAP);
+                        break;
+                    }
+                    pass->inputs[pass->inputs_count++] = input;
+                }
+            } break;
+
+            case PASS_KEY_OUTPUT:
+                pass->output = value;
+                pass->output_declared = true;
+                break;
+
+            case COUNT_PASS_KEYS:
+            default:
+                assert(0 && "unreachable");
+            }
+        } else if (conf_key_by_name(key, &conf_key)) {
+            switch (conf_key) {
+            case CONF_KEY_TEXTURE:
+                texture_path = render_conf_path_cstr(value);
+                break;
+
+            case CONF_KEY_FOLLOW_SCALE:
+                number_ok = sv_parse_f32(value, &follow_scale);
+                break;
+
+            case CONF_KEY_OBJECT_SIZE:
+                number_ok = sv_parse_f32(value, &object_size);
+                break;
+
+            case CONF_KEY_ROTATE_RADIUS:
+                number_ok = sv_parse_f32(value, &rotate_radius);
+                break;
+
+            case CONF_KEY_ROTATE_SPEED:
+                number_ok = sv_parse_f32(value, &rotate_speed);
+                break;
+
+            case CONF_KEY_RESOLUTION_BUDGET_MS:
+                number_ok = sv_parse_f32(value, &resolution.budget_ms);
+                break;
+
+            case CONF_KEY_RESOLUTION_MIN_SCALE:
+                number_ok = sv_parse_f32(value, &resolution.min_scale);
+                if (resolution.min_scale < RESOLUTION_SCALE_STEP) resolution.min_scale = RESOLUTION_SCALE_STEP;
+                if (resolution.min_scale > 1.0f) resolution.min_scale = 1.0f;
+                break;
+
+            case CONF_KEY_STATS_INTERVAL:
+                number_ok = sv_parse_f32(value, &stats_interval);
+                break;
+
+            case CONF_KEY_TRACE_ON_EXIT:
+                number_ok = sv_parse_i64(value, &integer);
+                if (number_ok) trace_on_exit = integer != 0;
+                break;
+
+            case CONF_KEY_THREADS:
+                number_ok = sv_parse_u64(value, &count);
+                if (number_ok) threads_count = count;
+                break;
+
+            case CONF_KEY_COLLISIONS:
+                number_ok = sv_parse_i64(value, &integer);
+                if (number_ok) collisions = integer != 0;
+                break;
+
+            case CONF_KEY_OBJECTS_COUNT:
+                number_ok = sv_parse_u64(value, &count);
+                if (number_ok) {
+                    if (count > OBJECTS_CAP) {
+                        printf("%s:%d:%ld: WARNING: objects_count overflow\n",
+                               render_conf_path, row, key.data - line_start);
+                        count = OBJECTS_CAP;
+                    }
+                    objects_count = count;
+                    objects_reserve(objects_count);
+                }
+                break;
+
+            case COUNT_CONF_KEYS:
+            default:
+                assert(0 && "unreachable");
+            }
+        } else {
+            printf("%s:%d:%ld: ERROR: unsupported key `"SV_Fmt"`\n",
+                   render_conf_path, row, key.data - line_start,
+                   SV_Arg(key));
+            continue;
         }
+
+        if (!number_ok) {
+            printf("%s:%d:%ld: ERROR: `"SV_Fmt"` is not a valid number\n",
+                   render_conf_path, row, value.data - line_start,
+                   SV_Arg(value));
+            continue;
+        }
+
+        printf(SV_Fmt" = "SV_Fmt"\n", SV_Arg(key), SV_Arg(value));
+    }
+
+    objects_grid_rebuild();
+    // objects_count and object_size may have changed
+    scene_version += 1;
+    TRACE_END();
+}
+
+// Work that is done outside of the GL thread. The tasks go to the background
+// queue of the jobs, so the GL thread never runs them while it waits for the
+// other jobs, unless there are no other workers (`threads = 1`), then they
+// run right away in async_task_submit(). The worker that finishes the task
+// pushes it to `completions` and the GL thread completes it (uploads the
+// results, reports errors, frees the memory) in completions_drain() right
+// before rendering the next frame.
+typedef struct Async_Task Async_Task;
+struct Async_Task {
+    Job job;
+    void (*complete)(Async_Task *task);
+};
+
+#define COMPLETIONS_CAP 256
+static Mpsc_Queue completions = {0};
+static size_t async_tasks_in_flight = 0;
+
+void async_task_submit(Async_Task *task, Job_Func func, void (*complete)(Async_Task *task))
+{
+    task->complete = complete;
+    job_init(&task->job, func, task, NULL);
+    async_tasks_in_flight += 1;
+    jobs_submit_background(&task->job);
+}
+
+void completions_drain(void);
+
+// Must be the last thing the job function of the task does
+void async_task_done(Async_Task *task)
+{
+    // The GL thread never waits on the queue, so it is only full if the
+    // frame is stuck. Back off until it catches up. Without the other workers
+    // the GL thread runs the task itself and makes room by completing the
+    // earlier ones.
+    while (!mpsc_queue_push(&completions, &task)) {
+        if (jobs_worker_index == 0) {
+            completions_drain();
+        } else {
+            jobs_yield();
+        }
+    }
+}
+
+void completions_drain(void)
+{
+    Async_Task *task;
+    while (mpsc_queue_pop(&completions, &task)) {
+        // The task is pushed right before its job is marked as done,
+        // so this never waits for more than a few instructions
+        jobs_wait(&task->job);
+        async_tasks_in_flight -= 1;
+        task->complete(task);
+    }
+}
+
+// Blocks until all of the submitted tasks are completed
+void completions_flush(void)
+{
+    while (async_tasks_in_flight > 0) {
+        completions_drain();
+        if (async_tasks_in_flight > 0) jobs_yield();
+    }
+}
+
+typedef struct {
+    Async_Task task;
+    char *path;
+    int width, height;
+    unsigned char *pixels;
+    int error;
+} User_Texture;
+
+// Decoding does not need the GL context, so it can be done on any worker
+static void user_texture_decode(void *data)
+{
+    User_Texture *texture = data;
+    TRACE_ZONE("user_texture_decode") {
+        texture->pixels = stbi_load(texture->path, &texture->width, &texture->height, NULL, 4);
+        texture->error = texture->pixels == NULL ? errno : 0;
     }
+    async_task_done(&texture->task);
 }
 
-bool reload_user_textures(void)
+bool reload_user_textures(User_Texture *texture)
 {
-    int texture_width, texture_height;
-    unsigned char *texture_pixels = stbi_load(texture_path, &texture_width, &texture_height, NULL, 4);
+    TRACE_BEGIN("reload_user_textures");
+    int texture_width = texture->width;
+    int texture_height = texture->height;
+    unsigned char *texture_pixels = texture->pixels;
     if (texture_pixels == NULL) {
         fprintf(stderr, "ERROR: could not load image %s: %s\n",
-                texture_path, strerror(errno));
+                texture->path, strerror(texture->error));
+        TRACE_END();
         return false;
     }
 
@@ -426,17 +1028,37 @@ bool reload_user_textures(void)
                  texture_pixels);
 
     stbi_image_free(texture_pixels);
+    user_texture_version += 1;
 
     printf("Successfully reloaded textures\n");
+    TRACE_END();
     return true;
 }
 
 bool r_reload_shaders(Renderer *r)
 {
+    TRACE_BEGIN("r_reload_shaders");
     for (Program p = 0; p < COUNT_PROGRAMS; ++p) {
+        r->program_versions[p] += 1;
         glDeleteProgram(r->programs[p]);
+        r->programs[p] = 0;
+    }
+
+    for (Program p = 0; p < COUNT_PROGRAMS; ++p) {
+        if (p >= PROGRAM_POST + post_passes_count && p != PROGRAM_UPSCALE) continue;
+        if (vert_path[p] == NULL || frag_path[p] == NULL) {
+            fprintf(stderr, "ERROR: "SV_Fmt" pass needs both vert["SV_Fmt"] and frag["SV_Fmt"]\n",
+                    SV_Arg(render_graph.passes[p].name),
+                    SV_Arg(render_graph.passes[p].name),
+                    SV_Arg(render_graph.passes[p].name));
+            TRACE_END();
+            return false;
+        }
 
-        if (!load_shader_program(vert_path[p], frag_path[p], &r->programs[p])) return false;
+        if (!load_shader_program(vert_path[p], frag_path[p], &r->programs[p])) {
+            TRACE_END();
+            return false;
+        }
 
         glUseProgram(r->programs[p]);
 
@@ -446,57 +1068,459 @@ bool r_reload_shaders(Renderer *r)
     }
 
     printf("Successfully reloaded the Shaders\n");
+    TRACE_END();
     return true;
 }
 
+// Physical render targets the resources of the render graph are assigned to.
+// They are created on demand and never destroyed, a new graph reuses them.
+//
+// The targets are allocated in RENDER_TARGETS_BUCKET steps, bigger than the
+// framebuffer, and the passes only render into its part of them (see
+// Render_Size). A slightly smaller or bigger window keeps using the same
+// textures. The window resizes are debounced: the targets are reallocated
+// once the framebuffer size has not changed for RENDER_TARGETS_RESIZE_DELAY.
+// Until then a framebuffer that outgrew the targets is upscaled from them.
+typedef struct {
+    GLuint texture;
+    GLuint framebuffer;
+} Render_Target;
+
+// One more than the graph may need for the upscaled output
+#define RENDER_TARGETS_CAP (GRAPH_TARGETS_CAP + 1)
+#define RENDER_TARGETS_BUCKET 256
+#define RENDER_TARGETS_RESIZE_DELAY 0.25
+static Render_Target render_targets[RENDER_TARGETS_CAP] = {0};
+static size_t render_targets_count = 0;
+static int render_targets_width = 0;
+static int render_targets_height = 0;
+// The framebuffer size the targets have to fit and when it was last changed
+static int render_targets_wanted_width = 0;
+static int render_targets_wanted_height = 0;
+static double render_targets_wanted_at = 0.0;
+static size_t render_targets_reallocs = 0;
+// Only the CPU time of the calls, the driver may finish the work later
+static double render_targets_realloc_secs = 0.0;
+
+static int render_targets_bucket(int size)
+{
+    if (size < 1) size = 1;
+    return (size + RENDER_TARGETS_BUCKET - 1) / RENDER_TARGETS_BUCKET * RENDER_TARGETS_BUCKET;
+}
+
+// Immutable storage can not be resized, so with it the texture is recreated
+// and attached to the framebuffer again
+static void render_target_storage(Render_Target *target, int width, int height)
+{
+    glActiveTexture(GL_TEXTURE1);
+    if (target->texture == 0 || glTexStorage2D != NULL) {
+        if (target->texture != 0) glDeleteTextures(1, &target->texture);
+        glGenTextures(1, &target->texture);
+        glBindTexture(GL_TEXTURE_2D, target->texture);
+
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
+    } else {
+        glBindTexture(GL_TEXTURE_2D, target->texture);
+    }
+
+    if (glTexStorage2D != NULL) {
+        glTexStorage2D(GL_TEXTURE_2D, 1, GL_RGBA8, width, height);
+    } else {
+        glTexImage2D(
+            GL_TEXTURE_2D,
+            0,
+            GL_RGBA,
+            width,
+            height,
+            0,
+            GL_RGBA,
+            GL_UNSIGNED_BYTE,
+            NULL);
+    }
+
+    glBindFramebuffer(GL_FRAMEBUFFER, target->framebuffer);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, target->texture, 0);
+}
+
+// Sets the initial size of the targets before any of them is created
+void render_targets_init(int framebuffer_width, int framebuffer_height, double now)
+{
+    render_targets_wanted_width = framebuffer_width;
+    render_targets_wanted_height = framebuffer_height;
+    render_targets_wanted_at = now;
+    render_targets_width = render_targets_bucket(framebuffer_width);
+    render_targets_height = render_targets_bucket(framebuffer_height);
+}
+
+bool render_targets_reserve(size_t count)
+{
+    assert(count <= RENDER_TARGETS_CAP);
+    for (; render_targets_count < count; ++render_targets_count) {
+        Render_Target *target = &render_targets[render_targets_count];
+        glGenFramebuffers(1, &target->framebuffer);
+        render_target_storage(target, render_targets_width, render_targets_height);
+
+        GLenum draw_buffers = GL_COLOR_ATTACHMENT0;
+        glDrawBuffers(1, &draw_buffers);
+
+        GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+        if (status != GL_FRAMEBUFFER_COMPLETE) {
+            fprintf(stderr, "ERROR: Could not complete the framebuffer\n");
+            return false;
+        }
+    }
+    return true;
+}
+
+void render_targets_request(int framebuffer_width, int framebuffer_height, double now)
+{
+    render_targets_wanted_width = framebuffer_width;
+    render_targets_wanted_height = framebuffer_height;
+    render_targets_wanted_at = now;
+}
+
+// Reallocates the targets if the framebuffer has settled on a size that does
+// not fit them or wastes more than a bucket of them. Returns true if it did.
+bool render_targets_update(double now)
+{
+    int width = render_targets_bucket(render_targets_wanted_width);
+    int height = render_targets_bucket(render_targets_wanted_height);
+    bool outgrown = width > render_targets_width || height > render_targets_height;
+    bool wasteful = width + RENDER_TARGETS_BUCKET < render_targets_width ||
+                    height + RENDER_TARGETS_BUCKET < render_targets_height;
+    if (!outgrown && !wasteful) return false;
+    if (now - render_targets_wanted_at < RENDER_TARGETS_RESIZE_DELAY) return false;
+
+    TRACE_BEGIN("render targets realloc");
+    double started = glfwGetTime();
+    render_targets_width = width;
+    render_targets_height = height;
+    for (size_t i = 0; i < render_targets_count; ++i) {
+        render_target_storage(&render_targets[i], width, height);
+    }
+    render_targets_realloc_secs += glfwGetTime() - started;
+    render_targets_reallocs += 1;
+    TRACE_END();
+    return true;
+}
+
+void render_targets_print(void)
+{
+    printf("Render targets: %zu of %dx%d for the %dx%d framebuffer, reallocated %zu times in %.3fms of CPU time\n",
+           render_targets_count, render_targets_width, render_targets_height,
+           render_targets_wanted_width, render_targets_wanted_height,
+           render_targets_reallocs, render_targets_realloc_secs * 1000.0);
+}
+
+// The passes render into the bottom left corner of the targets at the
+// dynamic resolution
+typedef struct {
+    int width, height;
+    int screen_width, screen_height;
+    // Part of the targets that is rendered into
+    float tex_scale_x, tex_scale_y;
+    bool upscaled;
+} Render_Size;
+
+Render_Size render_size(int screen_width, int screen_height, float scale)
+{
+    Render_Size size = {
+        .width = (int) (screen_width * scale),
+        .height = (int) (screen_height * scale),
+        .screen_width = screen_width,
+        .screen_height = screen_height,
+    };
+    if (size.width > render_targets_width) size.width = render_targets_width;
+    if (size.height > render_targets_height) size.height = render_targets_height;
+    if (size.width < 1) size.width = 1;
+    if (size.height < 1) size.height = 1;
+    size.tex_scale_x = (float) size.width / render_targets_width;
+    size.tex_scale_y = (float) size.height / render_targets_height;
+    size.upscaled = size.width != screen_width || size.height != screen_height;
+    return size;
+}
+
+// When the passes are not rendered at the size of the screen, the pass that
+// writes SCREEN writes into the spare target instead, to be upscaled later
+size_t render_graph_output(const Graph_Step *step, const Render_Size *size)
+{
+    if (step->output == GRAPH_SCREEN && size->upscaled) return render_graph.targets_count;
+    return step->output;
+}
+
+void render_graph_bind_output(const Graph_Step *step, const Render_Size *size)
+{
+    size_t target = render_graph_output(step, size);
+    if (target == GRAPH_SCREEN) {
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        glViewport(0, 0, size->screen_width, size->screen_height);
+    } else {
+        glBindFramebuffer(GL_FRAMEBUFFER, render_targets[target].framebuffer);
+        glViewport(0, 0, size->width, size->height);
+    }
+}
+
+// What every render target and the screen contain, as the fingerprint of the
+// pass that drew it. A pass is not drawn again if its output already contains
+// its result. If nothing the screen depends on has changed the frame is not
+// drawn nor swapped at all.
+static uint64_t render_targets_content[RENDER_TARGETS_CAP] = {0};
+static uint64_t screen_content = 0;
+static size_t passes_reused = 0;
+static size_t frames_reused = 0;
+
+// Fingerprint of what the program draws into the output of the given size by
+// itself: its version and the values of only the uniforms it uses (see
+// r_sync_uniforms()). The fingerprints of the inputs are added by the caller.
+uint64_t render_program_fingerprint(const Renderer *r, Program program,
+                                    int output_width, int output_height,
+                                    float width, float height, float time,
+                                    float mouse_x, float mouse_y,
+                                    const Render_Size *size)
+{
+    static_assert(COUNT_UNIFORMS == 9, "Exhaustive uniform handling in render_program_fingerprint()");
+    const GLint *uniforms = r->uniforms[program];
+    uint64_t h = fingerprint_u64(FINGERPRINT_SEED, program);
+    h = fingerprint_u64(h, r->program_versions[program]);
+    h = fingerprint_u64(h, ((uint64_t) output_width << 32) | (uint32_t) output_height);
+    // The transform only depends on the resolution
+    if (uniforms[RESOLUTION_UNIFORM] != -1 || uniforms[TRANSFORM_UNIFORM] != -1) {
+        h = fingerprint_f32(h, width);
+        h = fingerprint_f32(h, height);
+    }
+    if (uniforms[TIME_UNIFORM] != -1) h = fingerprint_f32(h, time);
+    if (uniforms[MOUSE_UNIFORM] != -1) {
+        h = fingerprint_f32(h, mouse_x);
+        h = fingerprint_f32(h, mouse_y);
+    }
+    if (uniforms[TEX_SCALE_UNIFORM] != -1) {
+        h = fingerprint_f32(h, size->tex_scale_x);
+        h = fingerprint_f32(h, size->tex_scale_y);
+    }
+    // SCENE samples the user texture, the post passes sample their inputs
+    if (program == PROGRAM_SCENE && uniforms[TEX_UNIFORM] != -1) {
+        h = fingerprint_u64(h, user_texture_version);
+    }
+    return h;
+}
+
+// Computes the fingerprint of every step into `steps` and returns the one of
+// the screen. The targets are aliased, so the inputs are followed through the
+// targets as they are going to be written during the frame.
+uint64_t render_graph_fingerprints(const Renderer *r, uint64_t scene_vertices,
+                                   float width, float height, float time,
+                                   float mouse_x, float mouse_y,
+                                   const Render_Size *size, uint64_t *steps)
+{
+    uint64_t written[RENDER_TARGETS_CAP] = {0};
+    uint64_t screen = 0;
+    for (size_t s = 0; s < render_graph.steps_count; ++s) {
+        const Graph_Step *step = &render_graph.steps[s];
+        size_t target = render_graph_output(step, size);
+        bool to_screen = target == GRAPH_SCREEN;
+        uint64_t h = render_program_fingerprint(r, step->pass,
+                                                to_screen ? size->screen_width : size->width,
+                                                to_screen ? size->screen_height : size->height,
+                                                width, height, time, mouse_x, mouse_y, size);
+        if (step->pass == PROGRAM_SCENE) h = fingerprint_u64(h, scene_vertices);
+        for (size_t k = 0; k < step->inputs_count; ++k) {
+            h = fingerprint_u64(h, written[step->inputs[k]]);
+        }
+        steps[s] = h;
+
+        if (to_screen) {
+            screen = h;
+        } else {
+            written[target] = h;
+        }
+    }
+    if (size->upscaled) {
+        screen = render_program_fingerprint(r, PROGRAM_UPSCALE, size->screen_width, size->screen_height,
+                                            width, height, time, mouse_x, mouse_y, size);
+        screen = fingerprint_u64(screen, written[render_graph.targets_count]);
+    }
+    return screen;
+}
+
+// The content of the targets is lost when they are reallocated
+void render_targets_forget_content(void)
+{
+    memset(render_targets_content, 0, sizeof(render_targets_content));
+    screen_content = 0;
+}
+
+// Returns true if the output of the step already contains its result,
+// otherwise marks it as containing it
+bool render_graph_reuse(const Graph_Step *step, const Render_Size *size, uint64_t fingerprint)
+{
+    size_t target = render_graph_output(step, size);
+    if (target == GRAPH_SCREEN) return false;
+    if (render_targets_content[target] == fingerprint) {
+        passes_reused += 1;
+        return true;
+    }
+    render_targets_content[target] = fingerprint;
+    return false;
+}
+
+// Draws a full screen pass, the inputs must be already bound starting from GL_TEXTURE1
+void r_post_pass(Renderer *r, Program program,
+                 float width, float height, float time,
+                 float mouse_x, float mouse_y,
+                 const Render_Size *size)
+{
+    glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+    glClear(GL_COLOR_BUFFER_BIT);
+    glUseProgram(r->programs[program]);
+    r_clear(r);
+    r_sync_uniforms(r, program, width, height, time, mouse_x, mouse_y,
+                    size->tex_scale_x, size->tex_scale_y, a2f_id(), 1);
+    r_screen_strip(r, width, height);
+    r_sync_buffers(r);
+    glDrawArrays(GL_TRIANGLE_STRIP, 0, SCREEN_STRIP_VERTICES);
+}
+
 bool r_reload(Renderer *r)
 {
     r->reload_failed = true;
     if (!r_reload_shaders(r)) return false;
+    if (!graph_compile(&render_graph)) return false;
+    // One more target for the output of the passes when it is upscaled to the screen
+    if (!render_targets_reserve(render_graph.targets_count + 1)) return false;
+    graph_print(&render_graph);
     r->reload_failed = false;
 
     return true;
 }
 
-static GLuint scene_framebuffer = {0};
-static GLuint scene_texture = 0;
+static void user_texture_complete(Async_Task *task)
+{
+    User_Texture *texture = (User_Texture*) task;
+    reload_user_textures(texture);
+    free(texture->path);
+    free(texture);
+}
 
-void scene_framebuffer_init(void)
+// Reloads everything render.conf refers to. The texture is decoded on the
+// workers and uploaded on one of the next frames, while the shaders are being
+// compiled on the GL thread.
+void reload_user_assets(Renderer *r)
 {
-    glGenTextures(1, &scene_texture);
-    glActiveTexture(GL_TEXTURE1);
-    glBindTexture(GL_TEXTURE_2D, scene_texture);
+    if (texture_path == NULL) {
+        fprintf(stderr, "ERROR: %s does not set the texture\n", render_conf_path);
+        r_reload(r);
+        return;
+    }
 
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
+    User_Texture *texture = calloc(1, sizeof(*texture));
+    size_t path_size = strlen(texture_path) + 1;
+    // render_conf that owns texture_path may be reloaded before the decoding is finished
+    char *path = malloc(path_size);
+    if (texture == NULL || path == NULL) {
+        fprintf(stderr, "ERROR: could not allocate memory for the texture reload: %s\n",
+                strerror(errno));
+        free(texture);
+        free(path);
+    } else {
+        memcpy(path, texture_path, path_size);
+        texture->path = path;
+        async_task_submit(&texture->task, user_texture_decode, user_texture_complete);
+    }
 
-    glTexImage2D(
-        GL_TEXTURE_2D,
-        0,
-        GL_RGBA,
-        DEFAULT_SCREEN_WIDTH,
-        DEFAULT_SCREEN_HEIGHT,
-        0,
-        GL_RGBA,
-        GL_UNSIGNED_BYTE,
-        NULL);
-
-    glGenFramebuffers(1, &scene_framebuffer);
-    glBindFramebuffer(GL_FRAMEBUFFER, scene_framebuffer);
-    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, scene_texture, 0);
-
-    GLenum draw_buffers = GL_COLOR_ATTACHMENT0;
-    glDrawBuffers(1, &draw_buffers);
-
-    GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
-    if (status != GL_FRAMEBUFFER_COMPLETE) {
-        fprintf(stderr, "ERROR: Could not complete the framebuffer\n");
-        exit(1);
+    r_reload(r);
+}
+
+typedef struct {
+    Async_Task task;
+    const char *path;
+    int width, height;
+    void *pixels;
+    bool ok;
+    int error;
+} Screenshot;
+
+// Only one screenshot is encoded at a time, they all go to the same file
+static bool screenshot_pending = false;
+
+static void screenshot_encode(void *data)
+{
+    Screenshot *screenshot = data;
+    TRACE_ZONE("screenshot_encode") {
+        screenshot->ok = stbi_write_png(screenshot->path,
+                                        screenshot->width, screenshot->height, 4,
+                                        screenshot->pixels, screenshot->width * 4);
+        screenshot->error = screenshot->ok ? 0 : errno;
     }
+    async_task_done(&screenshot->task);
+}
 
-    printf("Successfully created the debug framebuffer\n");
+static void screenshot_complete(Async_Task *task)
+{
+    Screenshot *screenshot = (Screenshot*) task;
+    if (screenshot->ok) {
+        printf("Saved the screenshot at %s\n", screenshot->path);
+    } else {
+        fprintf(stderr, "ERROR: could not save %s: %s\n", screenshot->path, strerror(screenshot->error));
+    }
+    free(screenshot->pixels);
+    free(screenshot);
+    screenshot_pending = false;
+}
+
+void input_event_apply(const Input_Event *event)
+{
+    switch ((Input_Event_Kind) event->kind) {
+    case INPUT_EVENT_RELOAD: {
+        size_t prev_threads_count = threads_count;
+        reload_render_conf(render_conf_path);
+        if (threads_count != prev_threads_count) {
+            completions_flush();
+            jobs_shutdown();
+            jobs_init(threads_count);
+        }
+        reload_user_assets(&global_renderer);
+    } break;
+
+    case INPUT_EVENT_TOGGLE_PAUSE:
+        paused = !paused;
+        break;
+
+    case INPUT_EVENT_STEP_BACK:
+        if (paused) scene_time -= MANUAL_TIME_STEP;
+        break;
+
+    case INPUT_EVENT_STEP_FORTH:
+        if (paused) scene_time += MANUAL_TIME_STEP;
+        break;
+
+    case INPUT_EVENT_MOUSE_PRESS:
+        if (objects_pick(event->x, event->y, &dragged_object)) {
+            dragging = true;
+            drag_offset_x = objects[dragged_object].x - event->x;
+            drag_offset_y = objects[dragged_object].y - event->y;
+            scene_version += 1;
+        }
+        break;
+
+    case INPUT_EVENT_MOUSE_RELEASE:
+        dragging = false;
+        break;
+
+    case COUNT_INPUT_EVENTS:
+    default:
+        fprintf(stderr, "ERROR: unknown input event %u\n", event->kind);
+    }
+}
+
+// Live events go through the recording
+void input_event_handle(Input_Event event)
+{
+    if (input_event_push(event)) {
+        input_event_apply(&event);
+    }
 }
 
 void key_callback(GLFWwindow* window, int key, int scancode, int action, int mods)
@@ -507,57 +1531,105 @@ void key_callback(GLFWwindow* window, int key, int scancode, int action, int mod
 
     if (action == GLFW_PRESS) {
         if (key == GLFW_KEY_F5) {
-            reload_render_conf("render.conf");
-            reload_user_textures();
-            r_reload(&global_renderer);
+            input_event_handle((Input_Event) {.kind = INPUT_EVENT_RELOAD});
         } else if (key == GLFW_KEY_F6) {
 #define SCREENSHOT_PNG_PATH "screenshot.png"
+            if (screenshot_pending) {
+                fprintf(stderr, "WARN: the previous screenshot is still being saved, try again later\n");
+                return;
+            }
             printf("Saving the screenshot at %s\n", SCREENSHOT_PNG_PATH);
             int width, height;
             glfwGetWindowSize(window, &width, &height);
+            Screenshot *screenshot = calloc(1, sizeof(*screenshot));
             void *pixels = malloc(4 * width * height);
-            if (pixels == NULL) {
+            if (screenshot == NULL || pixels == NULL) {
                 fprintf(stderr, "ERROR: could not allocate memory for pixels to make a screenshot: %s\n",
                         strerror(errno));
+                free(screenshot);
+                free(pixels);
                 return;
             }
             glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
-            if (!stbi_write_png(SCREENSHOT_PNG_PATH, width, height, 4, pixels, width * 4)) {
-                fprintf(stderr, "ERROR: could not save %s: %s\n", SCREENSHOT_PNG_PATH, strerror(errno));
+            // PNG encoding is slow, do it on the workers
+            screenshot->path = SCREENSHOT_PNG_PATH;
+            screenshot->width = width;
+            screenshot->height = height;
+            screenshot->pixels = pixels;
+            screenshot_pending = true;
+            async_task_submit(&screenshot->task, screenshot_encode, screenshot_complete);
+        } else if (key == GLFW_KEY_F7) {
+            timing_print();
+            printf("Objects: %zu drawn, %zu culled\n", objects_drawn, objects_culled);
+            jobs_print_stats();
+            graph_print(&render_graph);
+            resolution_print(&resolution);
+            render_targets_print();
+            printf("Reused the results of %zu passes and %zu whole frames\n", passes_reused, frames_reused);
+            if (collisions) {
+                printf("Collisions: %zu candidates, %zu pairs, broad phase %.3fms, narrow phase %.3fms\n",
+                       collision_stats.candidates, collision_stats.hits,
+                       collision_stats.broad_phase_secs * 1000.0,
+                       collision_stats.narrow_phase_secs * 1000.0);
             }
-            free(pixels);
+        } else if (key == GLFW_KEY_F8) {
+            trace_dump(TRACE_JSON_PATH);
         } else if (key == GLFW_KEY_SPACE) {
-            pause = !pause;
+            input_event_handle((Input_Event) {.kind = INPUT_EVENT_TOGGLE_PAUSE});
         } else if (key == GLFW_KEY_Q) {
             exit(1);
         }
 
-        if (pause) {
+        if (paused) {
             if (key == GLFW_KEY_LEFT) {
-                time -= MANUAL_TIME_STEP;
+                input_event_handle((Input_Event) {.kind = INPUT_EVENT_STEP_BACK});
             } else if (key == GLFW_KEY_RIGHT) {
-                time += MANUAL_TIME_STEP;
+                input_event_handle((Input_Event) {.kind = INPUT_EVENT_STEP_FORTH});
             }
         }
     }
 }
 
+// Cursor position relative to the center of the window with Y pointing up
+void cursor_scene_pos(GLFWwindow *window, double *xpos, double *ypos)
+{
+    int width, height;
+    glfwGetWindowSize(window, &width, &height);
+    glfwGetCursorPos(window, xpos, ypos);
+    *xpos = *xpos - width * 0.5f;
+    *ypos = (height - *ypos) - height * 0.5f;
+}
+
+void mouse_button_callback(GLFWwindow* window, int button, int action, int mods)
+{
+    (void) mods;
+
+    if (button != GLFW_MOUSE_BUTTON_LEFT) return;
+
+    if (action == GLFW_PRESS) {
+        double xpos, ypos;
+        cursor_scene_pos(window, &xpos, &ypos);
+        input_event_handle((Input_Event) {
+            .kind = INPUT_EVENT_MOUSE_PRESS,
+            .x = (float) xpos,
+            .y = (float) ypos,
+        });
+    } else if (action == GLFW_RELEASE) {
+        input_event_handle((Input_Event) {.kind = INPUT_EVENT_MOUSE_RELEASE});
+    }
+}
+
 void window_size_callback(GLFWwindow* window, int width, int height)
 {
     (void) window;
-    glViewport(0, 0, width, height);
-    glActiveTexture(GL_TEXTURE1);
-    glBindTexture(GL_TEXTURE_2D, scene_texture);
-    glTexImage2D(
-        GL_TEXTURE_2D,
-        0,
-        GL_RGBA,
-        width,
-        height,
-        0,
-        GL_RGBA,
-        GL_UNSIGNED_BYTE,
-        NULL);
+    render_targets_request(width, height, glfwGetTime());
+}
+
+// The window system lost the content of the window, it has to be drawn again
+void window_refresh_callback(GLFWwindow* window)
+{
+    (void) window;
+    screen_content = 0;
 }
 
 void MessageCallback(GLenum source,
@@ -584,7 +1656,8 @@ void r_init(Renderer *r)
 
     glGenBuffers(1, &r->vbo);
     glBindBuffer(GL_ARRAY_BUFFER, r->vbo);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(r->vertex_buf), r->vertex_buf, GL_DYNAMIC_DRAW);
+    r->vbo_cap = VERTEX_BUF_INITIAL_CAP;
+    glBufferData(GL_ARRAY_BUFFER, r->vbo_cap * sizeof(Vertex), NULL, GL_DYNAMIC_DRAW);
 
     glEnableVertexAttribArray(VA_POS);
     glVertexAttribPointer(VA_POS,
@@ -611,14 +1684,316 @@ void r_init(Renderer *r)
                           (void*) offsetof(Vertex, color));
 }
 
-void r_clear(Renderer *r)
+#ifdef BENCH
+// Deterministic benchmark. Renders a fixed amount of frames into a hidden
+// window with a fixed time step and a scripted cursor path, then reports the
+// frame times as JSON. The preset is a regular render.conf, see the bench/ folder.
+// The hidden window still needs a display (use xvfb-run without one).
+//
+// USAGE: ./bench [preset.conf] [frames] [report.json]
+// Use LIBGL_ALWAYS_SOFTWARE=1 to run it on Mesa llvmpipe.
+#define BENCH_DELTA_TIME (1.0 / 60.0)
+#define BENCH_DEFAULT_FRAMES 1000
+#define BENCH_WARMUP_FRAMES 30
+#define BENCH_DEFAULT_REPORT_PATH "bench.json"
+
+typedef struct {
+    size_t frames;
+    size_t frame;
+    const char *report_path;
+    float *frame_times;
+    double frame_started;
+    double started;
+} Bench;
+
+// Lissajous curve over the whole window, so the objects sweep in and out of the screen
+void bench_cursor_pos(const Bench *bench, int width, int height, double *xpos, double *ypos)
 {
-    r->vertex_buf_sz = 0;
+    double t = bench->frame * BENCH_DELTA_TIME;
+    *xpos = sin(t * 1.3) * width * 0.45;
+    *ypos = cos(t * 0.7) * height * 0.45;
+}
+
+// Returns true when the benchmark is over
+bool bench_frame_end(Bench *bench)
+{
+    double now = glfwGetTime();
+    if (bench->frame == BENCH_WARMUP_FRAMES) {
+        bench->started = now;
+        // The stages of the warmup frames must not get into the report either
+        timing_reset();
+    } else if (bench->frame > BENCH_WARMUP_FRAMES) {
+        bench->frame_times[bench->frame - BENCH_WARMUP_FRAMES - 1] = (float) (now - bench->frame_started);
+    }
+    bench->frame_started = now;
+    bench->frame += 1;
+    return bench->frame > bench->frames + BENCH_WARMUP_FRAMES;
 }
 
-int main(void)
+static void bench_report_percentiles(FILE *f, const float *values)
 {
-    reload_render_conf("render.conf");
+    fprintf(f, "{\"p50\": %.4f, \"p95\": %.4f, \"p99\": %.4f}",
+            values[0] * 1000.0f, values[1] * 1000.0f, values[2] * 1000.0f);
+}
+
+bool bench_report(Bench *bench)
+{
+    static const float ps[] = {0.50f, 0.95f, 0.99f};
+    double total_secs = bench->frame_started - bench->started;
+
+    FILE *f = fopen(bench->report_path, "w");
+    if (f == NULL) {
+        fprintf(stderr, "ERROR: could not open %s: %s\n", bench->report_path, strerror(errno));
+        return false;
+    }
+
+    float frame_ms[3];
+    percentiles(bench->frame_times, bench->frames, ps, frame_ms, 3);
+    float max_frame = bench->frames > 0 ? bench->frame_times[bench->frames - 1] : 0.0f;
+
+    fprintf(f, "{\n");
+    fprintf(f, "  \"preset\": \"%s\",\n", render_conf_path);
+    fprintf(f, "  \"renderer\": \"%s\",\n", (const char *) glGetString(GL_RENDERER));
+    fprintf(f, "  \"frames\": %zu,\n", bench->frames);
+    fprintf(f, "  \"objects_count\": %zu,\n", objects_count);
+    fprintf(f, "  \"total_secs\": %.6f,\n", total_secs);
+    fprintf(f, "  \"fps\": %.3f,\n", total_secs > 0.0 ? bench->frames / total_secs : 0.0);
+    fprintf(f, "  \"frame_ms\": ");
+    bench_report_percentiles(f, frame_ms);
+    fprintf(f, ",\n  \"frame_max_ms\": %.4f,\n", max_frame * 1000.0f);
+    fprintf(f, "  \"stages_ms\": {\n");
+    for (Stage stage = 0; stage < COUNT_STAGES; ++stage) {
+        float values[3];
+        timing_series_percentiles(&timing.cpu[stage], ps, values, 3);
+        fprintf(f, "    \"%s\": ", stage_names[stage]);
+        bench_report_percentiles(f, values);
+        fprintf(f, ",\n");
+    }
+    for (Gpu_Stage stage = 0; stage < COUNT_GPU_STAGES; ++stage) {
+        float values[3];
+        timing_series_percentiles(&timing.gpu[stage], ps, values, 3);
+        fprintf(f, "    \"%s\": ", gpu_stage_names[stage]);
+        bench_report_percentiles(f, values);
+        fprintf(f, "%s\n", stage + 1 < COUNT_GPU_STAGES ? "," : "");
+    }
+    fprintf(f, "  }\n}\n");
+
+    bool ok = !ferror(f);
+    fclose(f);
+    if (!ok) {
+        fprintf(stderr, "ERROR: could not write %s: %s\n", bench->report_path, strerror(errno));
+        return false;
+    }
+
+    printf("%s: %zu frames, %.1f FPS, p50 %.3fms, p99 %.3fms. Report is saved to %s\n",
+           render_conf_path, bench->frames, bench->frames / total_secs,
+           frame_ms[0] * 1000.0f, frame_ms[2] * 1000.0f, bench->report_path);
+    return true;
+}
+#endif // BENCH
+
+#ifdef STRESS
+// Sweeps objects_count and object_size across orders of magnitude and
+// measures every stage of the objects pipeline on its own, to see where each
+// of them stops scaling linearly and which one gives up first. The upload and
+// the draw are finished with glFinish(), so their GPU work is attributed to
+// them instead of leaking into the next stage.
+//
+// USAGE: ./stress [preset.conf] [max_objects] [report.csv]
+#define STRESS_DELTA_TIME (1.0f / 60.0f)
+#define STRESS_DEFAULT_MAX_OBJECTS (10 * 1000 * 1000)
+#define STRESS_DEFAULT_REPORT_PATH "stress.csv"
+#define STRESS_MIN_FRAMES 3
+#define STRESS_MAX_FRAMES 100
+#define STRESS_MIN_SECS 1.0
+
+typedef enum {
+    STRESS_STAGE_UPDATE = 0,
+    STRESS_STAGE_VERTEX_GEN,
+    STRESS_STAGE_UPLOAD,
+    STRESS_STAGE_DRAW,
+    COUNT_STRESS_STAGES
+} Stress_Stage;
+
+static_assert(COUNT_STRESS_STAGES == 4, "Update list of stress stage names");
+static const char *stress_stage_names[COUNT_STRESS_STAGES] = {
+    [STRESS_STAGE_UPDATE] = "update",
+    [STRESS_STAGE_VERTEX_GEN] = "vertex_gen",
+    [STRESS_STAGE_UPLOAD] = "upload",
+    [STRESS_STAGE_DRAW] = "draw",
+};
+
+static const float stress_object_sizes[] = {1.0f, 10.0f, 100.0f};
+
+typedef struct {
+    size_t max_objects;
+    const char *report_path;
+} Stress;
+
+// Scatters the objects over an area twice as big as the screen, so about a
+// quarter of them is visible. Uses its own LCG to get the same layout everywhere.
+static void stress_scatter_objects(float width, float height)
+{
+    uint32_t state = 69;
+    for (size_t i = 0; i < objects_count; ++i) {
+        state = state * 1664525u + 1013904223u;
+        objects[i].x = ((state >> 8) / (float) (1 << 24) - 0.5f) * width * 2.0f;
+        state = state * 1664525u + 1013904223u;
+        objects[i].y = ((state >> 8) / (float) (1 << 24) - 0.5f) * height * 2.0f;
+        objects[i].dx = 0.0f;
+        objects[i].dy = 0.0f;
+    }
+}
+
+bool stress_run(const Stress *stress, Renderer *r, GLFWwindow *window)
+{
+    FILE *f = fopen(stress->report_path, "w");
+    if (f == NULL) {
+        fprintf(stderr, "ERROR: could not open %s: %s\n", stress->report_path, strerror(errno));
+        return false;
+    }
+
+    fprintf(f, "objects_count,object_size,frames,visible");
+    for (Stress_Stage stage = 0; stage < COUNT_STRESS_STAGES; ++stage) {
+        fprintf(f, ",%s_ms,%s_ns_per_object", stress_stage_names[stage], stress_stage_names[stage]);
+    }
+    fprintf(f, ",upload_mb_per_sec,status\n");
+
+    int width, height;
+    glfwGetWindowSize(window, &width, &height);
+    while (glGetError() != GL_NO_ERROR) {}
+
+    bool failed = false;
+    for (size_t count = 10; count <= stress->max_objects && !failed; count *= 10) {
+        for (size_t s = 0; s < sizeof(stress_object_sizes) / sizeof(stress_object_sizes[0]) && !failed; ++s) {
+            objects_count = count;
+            object_size = stress_object_sizes[s];
+            objects_reserve(objects_count);
+            stress_scatter_objects(width, height);
+            objects_grid_rebuild();
+
+            float samples[COUNT_STRESS_STAGES][STRESS_MAX_FRAMES];
+            size_t frames = 0;
+            double started = glfwGetTime();
+            while (!failed && (frames < STRESS_MIN_FRAMES ||
+                               (frames < STRESS_MAX_FRAMES && glfwGetTime() - started < STRESS_MIN_SECS))) {
+                double t0 = glfwGetTime();
+                objects_update(STRESS_DELTA_TIME, 0.0f, 0.0f);
+
+                double t1 = glfwGetTime();
+                glBindFramebuffer(GL_FRAMEBUFFER, 0);
+                glUseProgram(r->programs[PROGRAM_SCENE]);
+                r_clear(r);
+                r_sync_uniforms(r, PROGRAM_SCENE, width, height, scene_time, 0.0f, 0.0f, 1.0f, 1.0f, a2f_id(), 0);
+                objects_render_visible(r, width, height);
+
+                double t2 = glfwGetTime();
+                r_sync_buffers(r);
+                glFinish();
+
+                double t3 = glfwGetTime();
+                glDrawArraysInstanced(GL_TRIANGLES, 0, (GLsizei) r->vertex_buf_sz, 1);
+                glFinish();
+
+                double t4 = glfwGetTime();
+                failed = glGetError() != GL_NO_ERROR;
+                samples[STRESS_STAGE_UPDATE][frames] = (float) (t1 - t0);
+                samples[STRESS_STAGE_VERTEX_GEN][frames] = (float) (t2 - t1);
+                samples[STRESS_STAGE_UPLOAD][frames] = (float) (t3 - t2);
+                samples[STRESS_STAGE_DRAW][frames] = (float) (t4 - t3);
+                frames += 1;
+                scene_time += STRESS_DELTA_TIME;
+                glfwPollEvents();
+            }
+
+            fprintf(f, "%zu,%.1f,%zu,%zu", objects_count, object_size, frames, objects_drawn);
+            float median[COUNT_STRESS_STAGES];
+            static const float p50 = 0.5f;
+            for (Stress_Stage stage = 0; stage < COUNT_STRESS_STAGES; ++stage) {
+                percentiles(samples[stage], frames, &p50, &median[stage], 1);
+                fprintf(f, ",%.4f,%.3f", median[stage] * 1000.0f, median[stage] * 1e9f / objects_count);
+            }
+            double upload_mb = r->vertex_buf_sz * sizeof(Vertex) / (1024.0 * 1024.0);
+            fprintf(f, ",%.1f,%s\n",
+                    median[STRESS_STAGE_UPLOAD] > 0.0f ? upload_mb / median[STRESS_STAGE_UPLOAD] : 0.0,
+                    failed ? "gl_error" : "ok");
+            fflush(f);
+
+            printf("%10zu objects of size %6.1f:", objects_count, object_size);
+            for (Stress_Stage stage = 0; stage < COUNT_STRESS_STAGES; ++stage) {
+                printf(" %s %.3fms", stress_stage_names[stage], median[stage] * 1000.0f);
+            }
+            printf("%s\n", failed ? " (GL error, stopping)" : "");
+        }
+    }
+
+    bool ok = !ferror(f);
+    fclose(f);
+    if (!ok) {
+        fprintf(stderr, "ERROR: could not write %s: %s\n", stress->report_path, strerror(errno));
+        return false;
+    }
+    printf("Scaling curve is saved to %s\n", stress->report_path);
+    return true;
+}
+#endif // STRESS
+
+int main(int argc, char **argv)
+{
+#if defined(STRESS)
+    Stress stress = {
+        .max_objects = STRESS_DEFAULT_MAX_OBJECTS,
+        .report_path = STRESS_DEFAULT_REPORT_PATH,
+    };
+    if (argc > 1) render_conf_path = argv[1];
+    if (argc > 2) stress.max_objects = strtoul(argv[2], NULL, 10);
+    if (argc > 3) stress.report_path = argv[3];
+    if (stress.max_objects > OBJECTS_CAP) {
+        fprintf(stderr, "ERROR: at most %d objects are supported\n", OBJECTS_CAP);
+        exit(1);
+    }
+#elif defined(BENCH)
+    Bench bench = {
+        .frames = BENCH_DEFAULT_FRAMES,
+        .report_path = BENCH_DEFAULT_REPORT_PATH,
+    };
+    if (argc > 1) render_conf_path = argv[1];
+    if (argc > 2) {
+        char *end = NULL;
+        long long frames = strtoll(argv[2], &end, 10);
+        if (end == argv[2] || *end != '\0' || frames < 1) {
+            fprintf(stderr, "Usage: %s [preset.conf] [frames] [report.json]\n", argv[0]);
+            fprintf(stderr, "ERROR: invalid amount of frames `%s`, expected at least 1\n", argv[2]);
+            exit(1);
+        }
+        bench.frames = (size_t) frames;
+    }
+    if (argc > 3) bench.report_path = argv[3];
+    bench.frame_times = malloc(sizeof(*bench.frame_times) * (bench.frames + 1));
+    if (bench.frame_times == NULL) {
+        fprintf(stderr, "ERROR: could not allocate memory for the frame times: %s\n", strerror(errno));
+        exit(1);
+    }
+#else
+    const char *record_path = NULL;
+    const char *replay_path = NULL;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--record") == 0 && i + 1 < argc) {
+            record_path = argv[++i];
+        } else if (strcmp(argv[i], "--replay") == 0 && i + 1 < argc) {
+            replay_path = argv[++i];
+        } else {
+            record_path = replay_path = NULL;
+            break;
+        }
+    }
+    if (argc > 1 && (record_path == NULL) == (replay_path == NULL)) {
+        fprintf(stderr, "Usage: %s [--record <input.rec> | --replay <input.rec>]\n", argv[0]);
+        exit(1);
+    }
+#endif // BENCH
+
+    reload_render_conf(render_conf_path);
 
     if (!glfwInit()) {
         fprintf(stderr, "ERROR: could not initialize GLFW\n");
@@ -628,6 +2003,9 @@ int main(void)
     glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
     glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
     glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+#ifdef HEADLESS
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+#endif // HEADLESS
 
     GLFWwindow * const window = glfwCreateWindow(
                                     DEFAULT_SCREEN_WIDTH,
@@ -646,6 +2024,10 @@ int main(void)
     printf("OpenGL %d.%d\n", gl_ver_major, gl_ver_minor);
 
     glfwMakeContextCurrent(window);
+#ifdef HEADLESS
+    // Do not let vsync cap the measurements
+    glfwSwapInterval(0);
+#endif // HEADLESS
 
     load_gl_extensions();
 
@@ -662,89 +2044,204 @@ int main(void)
     glEnable(GL_BLEND);
     glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
-    scene_framebuffer_init();
-
     Renderer *r = &global_renderer;
 
-    reload_user_textures();
+    trace_init();
+    atexit(trace_dump_at_exit);
+    jobs_init(threads_count);
+    mpsc_queue_init(&completions, COMPLETIONS_CAP, sizeof(Async_Task*));
+    timing_init();
+
+    int framebuffer_width, framebuffer_height;
+    glfwGetFramebufferSize(window, &framebuffer_width, &framebuffer_height);
+    render_targets_init(framebuffer_width, framebuffer_height, glfwGetTime());
 
     r_init(r);
-    r_reload(r);
+    reload_user_assets(r);
 
     glfwSetKeyCallback(window, key_callback);
+    glfwSetMouseButtonCallback(window, mouse_button_callback);
     glfwSetFramebufferSizeCallback(window, window_size_callback);
-
-    time = glfwGetTime();
+    glfwSetWindowRefreshCallback(window, window_refresh_callback);
+
+#ifdef HEADLESS
+    // Every frame has to see exactly the same assets
+    completions_flush();
+    scene_time = 0.0;
+#else
+    scene_time = glfwGetTime();
+    if (replay_path != NULL && !input_replay_start(replay_path, &scene_time)) exit(1);
+    if (record_path != NULL && !input_record_start(record_path, scene_time)) exit(1);
+#endif // HEADLESS
+#ifdef STRESS
+    bool stress_ok = stress_run(&stress, r, window);
+    completions_flush();
+    return stress_ok ? 0 : 1;
+#endif // STRESS
     double prev_time = 0.0;
     double delta_time = 0.0f;
+    double stats_printed_at = glfwGetTime();
     while (!glfwWindowShouldClose(window)) {
+        stage_begin(STAGE_INPUT);
         int width, height;
         glfwGetWindowSize(window, &width, &height);
         double xpos, ypos;
-        glfwGetCursorPos(window, &xpos, &ypos);
-        xpos = xpos - width * 0.5f;
-        ypos = (height - ypos) - height * 0.5f;
+#ifdef BENCH
+        bench_cursor_pos(&bench, width, height, &xpos, &ypos);
+#else
+        cursor_scene_pos(window, &xpos, &ypos);
+#endif // BENCH
+        const Input_Frame *input_frame = input_frame_begin(&(Input_Frame) {
+            .cursor_x = (float) xpos,
+            .cursor_y = (float) ypos,
+            .width = (uint16_t) width,
+            .height = (uint16_t) height,
+        });
+        stage_end(STAGE_INPUT);
+        if (input_frame == NULL) break;
+        if (input_frame->width != width || input_frame->height != height) {
+            // Replaying a session recorded in a window of a different size
+            glfwSetWindowSize(window, input_frame->width, input_frame->height);
+            width = input_frame->width;
+            height = input_frame->height;
+        }
+        xpos = input_frame->cursor_x;
+        ypos = input_frame->cursor_y;
 
-        if (!r->reload_failed) {
-            static_assert(COUNT_PROGRAMS == 3, "Exhaustive handling of shader programs in the event loop");
+        completions_drain();
 
-            glBindFramebuffer(GL_FRAMEBUFFER, scene_framebuffer);
-            {
-                glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
-                glClear(GL_COLOR_BUFFER_BIT);
-                glUseProgram(r->programs[PROGRAM_SCENE]);
-                r_clear(r);
-                r_sync_uniforms(r, PROGRAM_SCENE, width, height, time, xpos, ypos, 0);
-                for (size_t i = objects_count; i > 0; --i) {
-                    object_render(r, &objects[i - 1]);
+        bool presented = true;
+        if (!r->reload_failed) {
+            float gpu_secs;
+            if (timing_gpu_frame(&gpu_secs)) resolution_update(&resolution, gpu_secs);
+            if (render_targets_update(glfwGetTime())) render_targets_forget_content();
+            int screen_width, screen_height;
+            glfwGetFramebufferSize(window, &screen_width, &screen_height);
+            Render_Size size = render_size(screen_width, screen_height, resolution.scale);
+
+            // The SCENE pass is declared first, so if it survived the culling it is the first step
+            bool scene_live = render_graph.steps_count > 0 && render_graph.steps[0].pass == PROGRAM_SCENE;
+            // The culling of the objects depends on the size of the window
+            uint64_t scene_vertices = fingerprint_u64(scene_version, ((uint64_t) width << 32) | (uint32_t) height);
+
+            uint64_t fingerprints[GRAPH_PASSES_CAP];
+            uint64_t screen = render_graph_fingerprints(r, scene_vertices, width, height, scene_time, xpos, ypos,
+                                                        &size, fingerprints);
+            presented = screen != screen_content;
+            screen_content = screen;
+            if (!presented) frames_reused += 1;
+
+            size_t s = 0;
+            if (scene_live) {
+                s += 1;
+                stage_begin(STAGE_SCENE_PASS);
+                if (presented && !render_graph_reuse(&render_graph.steps[0], &size, fingerprints[0])) {
+                    stage_begin(STAGE_VERTEX_GEN);
+                    r_clear(r);
+                    objects_render_visible(r, width, height);
+                    stage_end(STAGE_VERTEX_GEN);
+
+                    gpu_stage_begin(GPU_STAGE_SCENE_PASS);
+                    render_graph_bind_output(&render_graph.steps[0], &size);
+                    glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+                    glClear(GL_COLOR_BUFFER_BIT);
+                    glUseProgram(r->programs[PROGRAM_SCENE]);
+                    r_sync_uniforms(r, PROGRAM_SCENE, width, height, scene_time, xpos, ypos, 1.0f, 1.0f, a2f_id(), 0);
+                    r_sync_buffers(r);
+
+                    glDrawArraysInstanced(GL_TRIANGLES, 0, (GLsizei) r->vertex_buf_sz, 1);
+                    gpu_stage_end(GPU_STAGE_SCENE_PASS);
                 }
-                r_sync_buffers(r);
-
-                glDrawArraysInstanced(GL_TRIANGLES, 0, (GLsizei) r->vertex_buf_sz, 1);
+                stage_end(STAGE_SCENE_PASS);
             }
 
-            glBindFramebuffer(GL_FRAMEBUFFER, 0);
-            {
-                glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
-                glClear(GL_COLOR_BUFFER_BIT);
-
-#if 0
-                glUseProgram(r->programs[PROGRAM_POST0]);
-                r_sync_uniforms(r, PROGRAM_POST0, width, height, time, xpos, ypos, 1);
-                glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
-#endif
+            // Nothing is issued for a reused frame, so the GPU timing only
+            // measures the frames that were drawn
+            if (!presented) s = render_graph.steps_count;
+            stage_begin(STAGE_POST_PASS);
+            if (presented) gpu_stage_begin(GPU_STAGE_POST_PASS);
+            for (; s < render_graph.steps_count; ++s) {
+                const Graph_Step *step = &render_graph.steps[s];
+                if (render_graph_reuse(step, &size, fingerprints[s])) continue;
+                render_graph_bind_output(step, &size);
+                for (size_t k = 0; k < step->inputs_count; ++k) {
+                    glActiveTexture(GL_TEXTURE1 + k);
+                    glBindTexture(GL_TEXTURE_2D, render_targets[step->inputs[k]].texture);
+                }
+                r_post_pass(r, step->pass, width, height, scene_time, xpos, ypos, &size);
+            }
 
-                glUseProgram(r->programs[PROGRAM_POST1]);
-                r_clear(r);
-                r_sync_uniforms(r, PROGRAM_POST1, width, height, time, xpos, ypos, 1);
-                r_quad_cr(r, v2ff(0.0f), v2f(width * 0.5, height * 0.5), COLOR_BLACK_V4F);
-                r_sync_buffers(r);
-                glDrawArraysInstanced(GL_TRIANGLES, 0, (GLsizei) r->vertex_buf_sz, 1);
+            if (presented && size.upscaled) {
+                glBindFramebuffer(GL_FRAMEBUFFER, 0);
+                glViewport(0, 0, size.screen_width, size.screen_height);
+                glActiveTexture(GL_TEXTURE1);
+                glBindTexture(GL_TEXTURE_2D, render_targets[render_graph.targets_count].texture);
+                r_post_pass(r, PROGRAM_UPSCALE, width, height, scene_time, xpos, ypos, &size);
             }
+            if (presented) gpu_stage_end(GPU_STAGE_POST_PASS);
+            stage_end(STAGE_POST_PASS);
         } else {
             glClearColor(1.0f, 0.0f, 0.0f, 1.0f);
             glClear(GL_COLOR_BUFFER_BIT);
+            screen_content = 0;
         }
 
         if (objects_count > 0) {
-            float follow_x = xpos + sin(time * rotate_speed) * rotate_radius;
-            float follow_y = ypos + cos(time * rotate_speed) * rotate_radius;
-
-            object_update(&objects[0], delta_time, follow_x, follow_y);
-            for (size_t i = 1; i < objects_count; ++i) {
-                object_update(&objects[i], delta_time, objects[i - 1].x, objects[i - 1].y);
+            stage_begin(STAGE_OBJECT_UPDATE);
+            objects_update(delta_time, xpos, ypos);
+            stage_end(STAGE_OBJECT_UPDATE);
+
+            if (collisions) {
+                stage_begin(STAGE_COLLISIONS);
+                objects_resolve_collisions();
+                stage_end(STAGE_COLLISIONS);
             }
         }
 
-        glfwSwapBuffers(window);
+        if (presented) {
+            stage_begin(STAGE_SWAP);
+            glfwSwapBuffers(window);
+            stage_end(STAGE_SWAP);
+        } else {
+            // The screen still shows the same frame, sleep until something happens
+            glfwWaitEventsTimeout(IDLE_WAIT_SECS);
+        }
+        stage_begin(STAGE_INPUT);
         glfwPollEvents();
+        const Input_Event *replayed_events = NULL;
+        size_t replayed_events_count = input_replayed_events(&replayed_events);
+        for (size_t i = 0; i < replayed_events_count; ++i) {
+            input_event_apply(&replayed_events[i]);
+        }
+        stage_end(STAGE_INPUT);
+
+        timing_frame_end();
+        trace_collect();
+#ifdef BENCH
+        delta_time = input_frame_end(BENCH_DELTA_TIME);
+        scene_time += delta_time;
+        if (bench_frame_end(&bench)) break;
+        (void) prev_time;
+        (void) stats_printed_at;
+#else
         double cur_time = glfwGetTime();
-        delta_time = cur_time - prev_time;
-        if (!pause) {
-            time += delta_time;
+        if (stats_interval > 0.0f && cur_time - stats_printed_at >= stats_interval) {
+            timing_print();
+            stats_printed_at = cur_time;
+        }
+        delta_time = input_frame_end(cur_time - prev_time);
+        if (!paused) {
+            scene_time += delta_time;
         }
         prev_time = cur_time;
+#endif // BENCH
     }
 
+    completions_flush();
+    input_stop();
+#ifdef BENCH
+    if (!bench_report(&bench)) return 1;
+#endif // BENCH
+
     return 0;
 }
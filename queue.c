@@ -0,0 +1,159 @@
+// Bounded lock-free queues of fixed-size items.
+//
+// Spsc_Queue: single producer, single consumer ring buffer. Both push and pop
+// are wait-free.
+//
+// Mpsc_Queue: multiple producers, single consumer. Every slot carries a
+// sequence number (Dmitry Vyukov's bounded queue), so the producers only
+// contend on a single CAS of the tail and the consumer never waits on
+// anything: pop is wait-free, push is wait-free when uncontended.
+//
+// Neither of the queues ever blocks. push returns false when the queue is
+// full and pop returns false when it is empty.
+
+#include <stddef.h>
+#include <stdatomic.h>
+
+#define QUEUE_CACHE_LINE 64
+
+typedef struct {
+    size_t capacity;
+    size_t item_size;
+    char *items;
+    char pad0[QUEUE_CACHE_LINE];
+    atomic_size_t head;
+    char pad1[QUEUE_CACHE_LINE];
+    atomic_size_t tail;
+} Spsc_Queue;
+
+typedef struct {
+    size_t capacity;
+    size_t item_size;
+    size_t slot_size;
+    char *slots;
+    char pad0[QUEUE_CACHE_LINE];
+    // Only touched by the consumer
+    size_t head;
+    char pad1[QUEUE_CACHE_LINE];
+    atomic_size_t tail;
+} Mpsc_Queue;
+
+static void *queue_alloc(size_t size)
+{
+    void *data = malloc(size);
+    if (data == NULL) {
+        fprintf(stderr, "ERROR: could not allocate %zu bytes for a queue: %s\n",
+                size, strerror(errno));
+        exit(1);
+    }
+    return data;
+}
+
+// `capacity` must be a power of two
+void spsc_queue_init(Spsc_Queue *q, size_t capacity, size_t item_size)
+{
+    assert(capacity > 0 && (capacity & (capacity - 1)) == 0);
+    q->capacity = capacity;
+    q->item_size = item_size;
+    q->items = queue_alloc(capacity * item_size);
+    atomic_init(&q->head, 0);
+    atomic_init(&q->tail, 0);
+}
+
+void spsc_queue_free(Spsc_Queue *q)
+{
+    free(q->items);
+    q->items = NULL;
+}
+
+bool spsc_queue_push(Spsc_Queue *q, const void *item)
+{
+    size_t tail = atomic_load_explicit(&q->tail, memory_order_relaxed);
+    size_t head = atomic_load_explicit(&q->head, memory_order_acquire);
+    if (tail - head >= q->capacity) return false;
+
+    memcpy(q->items + (tail & (q->capacity - 1)) * q->item_size, item, q->item_size);
+    atomic_store_explicit(&q->tail, tail + 1, memory_order_release);
+    return true;
+}
+
+bool spsc_queue_pop(Spsc_Queue *q, void *item)
+{
+    size_t head = atomic_load_explicit(&q->head, memory_order_relaxed);
+    size_t tail = atomic_load_explicit(&q->tail, memory_order_acquire);
+    if (head == tail) return false;
+
+    memcpy(item, q->items + (head & (q->capacity - 1)) * q->item_size, q->item_size);
+    atomic_store_explicit(&q->head, head + 1, memory_order_release);
+    return true;
+}
+
+static atomic_size_t *mpsc_queue_slot_seq(Mpsc_Queue *q, size_t pos)
+{
+    return (atomic_size_t*) (q->slots + (pos & (q->capacity - 1)) * q->slot_size);
+}
+
+static void *mpsc_queue_slot_item(Mpsc_Queue *q, size_t pos)
+{
+    return q->slots + (pos & (q->capacity - 1)) * q->slot_size + sizeof(atomic_size_t);
+}
+
+// `capacity` must be a power of two
+void mpsc_queue_init(Mpsc_Queue *q, size_t capacity, size_t item_size)
+{
+    assert(capacity > 0 && (capacity & (capacity - 1)) == 0);
+    q->capacity = capacity;
+    q->item_size = item_size;
+    // Keep the sequence number of every slot aligned
+    q->slot_size = (sizeof(atomic_size_t) + item_size + sizeof(atomic_size_t) - 1)
+                   / sizeof(atomic_size_t) * sizeof(atomic_size_t);
+    q->slots = queue_alloc(capacity * q->slot_size);
+    for (size_t i = 0; i < capacity; ++i) {
+        atomic_init(mpsc_queue_slot_seq(q, i), i);
+    }
+    q->head = 0;
+    atomic_init(&q->tail, 0);
+}
+
+void mpsc_queue_free(Mpsc_Queue *q)
+{
+    free(q->slots);
+    q->slots = NULL;
+}
+
+bool mpsc_queue_push(Mpsc_Queue *q, const void *item)
+{
+    size_t pos = atomic_load_explicit(&q->tail, memory_order_relaxed);
+    for (;;) {
+        size_t seq = atomic_load_explicit(mpsc_queue_slot_seq(q, pos), memory_order_acquire);
+        ptrdiff_t dif = (ptrdiff_t) seq - (ptrdiff_t) pos;
+        if (dif == 0) {
+            if (atomic_compare_exchange_weak_explicit(&q->tail, &pos, pos + 1,
+                                                      memory_order_relaxed,
+                                                      memory_order_relaxed)) {
+                break;
+            }
+        } else if (dif < 0) {
+            // The consumer has not released this slot yet
+            return false;
+        } else {
+            pos = atomic_load_explicit(&q->tail, memory_order_relaxed);
+        }
+    }
+
+    memcpy(mpsc_queue_slot_item(q, pos), item, q->item_size);
+    atomic_store_explicit(mpsc_queue_slot_seq(q, pos), pos + 1, memory_order_release);
+    return true;
+}
+
+bool mpsc_queue_pop(Mpsc_Queue *q, void *item)
+{
+    size_t pos = q->head;
+    size_t seq = atomic_load_explicit(mpsc_queue_slot_seq(q, pos), memory_order_acquire);
+    if (seq != pos + 1) return false;
+
+    memcpy(item, mpsc_queue_slot_item(q, pos), q->item_size);
+    atomic_store_explicit(mpsc_queue_slot_seq(q, pos), pos + q->capacity, memory_order_release);
+    q->head = pos + 1;
+    return true;
+}
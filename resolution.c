@@ -0,0 +1,70 @@
+// Dynamic resolution scaling.
+//
+// The passes render into the render targets at `scale` of the framebuffer
+// size and the result is upscaled to the screen. resolution_update() compares
+// the GPU time of every measured frame against the budget. The fragment work
+// is proportional to the area, so the linear scale is adjusted by the square
+// root of the time ratio: quickly down when the frame is over budget, slowly
+// up when there is headroom. After every change the controller waits for the
+// timer queries of the frames rendered at the new scale before changing it
+// again.
+
+#define RESOLUTION_SCALE_STEP (1.0f / 64.0f)
+#define RESOLUTION_HEADROOM 0.85f
+#define RESOLUTION_MAX_GROW 1.05f
+#define RESOLUTION_MAX_SHRINK 0.75f
+#define RESOLUTION_COOLDOWN_FRAMES (TIMING_GPU_FRAMES + 2)
+
+typedef struct {
+    // 0 disables the controller
+    float budget_ms;
+    float min_scale;
+    float scale;
+    size_t cooldown;
+    size_t changes;
+    float last_gpu_ms;
+} Resolution;
+
+// Returns true if the scale has changed
+bool resolution_update(Resolution *res, float gpu_secs)
+{
+    if (res->budget_ms <= 0.0f) {
+        res->scale = 1.0f;
+        return false;
+    }
+
+    float gpu_ms = gpu_secs * 1000.0f;
+    res->last_gpu_ms = gpu_ms;
+    if (res->cooldown > 0) {
+        res->cooldown -= 1;
+        return false;
+    }
+    if (gpu_ms <= 0.0f) return false;
+
+    float factor = 1.0f;
+    if (gpu_ms > res->budget_ms) {
+        factor = sqrtf(res->budget_ms / gpu_ms);
+        if (factor < RESOLUTION_MAX_SHRINK) factor = RESOLUTION_MAX_SHRINK;
+    } else if (gpu_ms < res->budget_ms * RESOLUTION_HEADROOM) {
+        factor = sqrtf(res->budget_ms * RESOLUTION_HEADROOM / gpu_ms);
+        if (factor > RESOLUTION_MAX_GROW) factor = RESOLUTION_MAX_GROW;
+    }
+
+    // Quantize, so the targets are not resized by a pixel every frame
+    float scale = roundf(res->scale * factor / RESOLUTION_SCALE_STEP) * RESOLUTION_SCALE_STEP;
+    if (scale < res->min_scale) scale = res->min_scale;
+    if (scale > 1.0f) scale = 1.0f;
+    if (scale == res->scale) return false;
+
+    res->scale = scale;
+    res->cooldown = RESOLUTION_COOLDOWN_FRAMES;
+    res->changes += 1;
+    return true;
+}
+
+void resolution_print(const Resolution *res)
+{
+    if (res->budget_ms <= 0.0f) return;
+    printf("Dynamic resolution: scale %.3f, GPU %.2fms of %.2fms budget, %zu changes\n",
+           res->scale, res->last_gpu_ms, res->budget_ms, res->changes);
+}
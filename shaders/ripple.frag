@@ -8,6 +8,7 @@ uniform vec2 resolution;
 uniform float time;
 uniform vec2 mouse;
 uniform sampler2D tex;
+uniform vec2 tex_scale;
 
 in vec2 uv;
 in vec4 color;
@@ -19,5 +20,5 @@ void main(void) {
 
     vec2 tex_uv = uv + (cPos/cLength)*mix(cos(cLength*12.0-time*4.0)*0.03, 0.0, cLength / 0.25);
 
-    out_color = texture(tex, tex_uv);
+    out_color = texture(tex, tex_uv * tex_scale);
 }
@@ -6,22 +6,17 @@ layout(location = 0) in vec2 ver_pos;
 layout(location = 1) in vec2 ver_uv;
 layout(location = 2) in vec4 ver_color;
 
-uniform vec2 resolution;
+// Screen coordinates (origin in the center of the screen) to NDC
+uniform mat3 transform;
 
 precision mediump float;
 
 out vec2 uv;
 out vec4 color;
 
-vec2 screen_project(vec2 pos)
-{
-    return (pos / resolution) * 2.0 - 1.0;
-}
-
 void main(void)
 {
-    float scale = 300.0;
-    gl_Position = vec4(screen_project(ver_pos + resolution * 0.5), 0.0, 1.0);
+    gl_Position = vec4((transform * vec3(ver_pos, 1.0)).xy, 0.0, 1.0);
     uv = ver_uv;
     color = ver_color;
 }
@@ -4,10 +4,11 @@
 precision mediump float;
 
 uniform sampler2D tex;
+uniform vec2 tex_scale;
 
 in vec2 uv;
 out vec4 out_color;
 
 void main(void) {
-    out_color = texture(tex, uv);
+    out_color = texture(tex, uv * tex_scale);
 }
@@ -0,0 +1,45 @@
+// Upscales the output of the passes rendered at the dynamic resolution to the
+// screen with a Catmull-Rom filter. Takes 9 bilinear samples instead of 16
+// point ones by merging the middle two taps of every row and column.
+#version 330
+
+precision mediump float;
+
+uniform sampler2D tex;
+uniform vec2 tex_scale;
+
+in vec2 uv;
+out vec4 out_color;
+
+vec2 texel;
+
+// Never read outside of the part of the texture that was rendered into
+vec4 sample_rendered(float x, float y)
+{
+    return texture(tex, clamp(vec2(x, y), texel * 0.5, tex_scale - texel * 0.5));
+}
+
+void main(void) {
+    vec2 tex_size = vec2(textureSize(tex, 0));
+    texel = 1.0 / tex_size;
+
+    vec2 sample_pos = uv * tex_scale * tex_size;
+    vec2 pos1 = floor(sample_pos - 0.5) + 0.5;
+    vec2 f = sample_pos - pos1;
+
+    vec2 w0 = f * (-0.5 + f * (1.0 - 0.5 * f));
+    vec2 w1 = 1.0 + f * f * (-2.5 + 1.5 * f);
+    vec2 w2 = f * (0.5 + f * (2.0 - 1.5 * f));
+    vec2 w3 = f * f * (-0.5 + 0.5 * f);
+
+    // The middle two taps are merged into a single bilinear one
+    vec2 w12 = w1 + w2;
+    vec2 p0 = (pos1 - 1.0) * texel;
+    vec2 p12 = (pos1 + w2 / w12) * texel;
+    vec2 p3 = (pos1 + 2.0) * texel;
+
+    out_color =
+        (sample_rendered(p0.x, p0.y) * w0.x + sample_rendered(p12.x, p0.y) * w12.x + sample_rendered(p3.x, p0.y) * w3.x) * w0.y +
+        (sample_rendered(p0.x, p12.y) * w0.x + sample_rendered(p12.x, p12.y) * w12.x + sample_rendered(p3.x, p12.y) * w3.x) * w12.y +
+        (sample_rendered(p0.x, p3.y) * w0.x + sample_rendered(p12.x, p3.y) * w12.x + sample_rendered(p3.x, p3.y) * w3.x) * w3.y;
+}
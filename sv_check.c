@@ -0,0 +1,613 @@
+// Checks of sv.h against the naive implementations.
+//
+// The searches (sv__find(), sv_chop_by_sv() and sv_index_of()) are compared
+// with the plain scans over the needles that cross the 16 and 32-byte blocks
+// of the vectorized loops at every offset, the needles that only match at the
+// first and the last character, the 1-byte and the empty needles, the ones
+// that do not occur at all, and random inputs over a small alphabet. Every
+// input is allocated at its exact size, so running it under AddressSanitizer
+// also catches the reads past the end.
+//
+// The number parsers (sv_parse_u64(), sv_parse_i64(), sv_parse_f32() and
+// sv_parse_f64()) are compared with strtoull(), strtoll(), strtof() and
+// strtod() over the edge cases below, the shortest and longer representations
+// of random floats, long random decimals with random exponents and random
+// strings of the characters a number is made of. sv_to_u64() is compared with
+// strtoull() over its digit prefixes.
+//
+// SV_Map is compared with an array of all the keys over random puts, gets and
+// removes, checked across its growth and rehashes, and checked to reuse the
+// removed slots instead of growing. SV_Interner is checked to give the same id
+// and the same pointer to the same content wherever it comes from, and
+// different pointers to different strings, the empty one included.
+//
+// Any mismatch is reported and sv_check exits with 1.
+//
+// Build it with and without -DSV_SIMD to check all the paths.
+//
+// Usage: ./sv_check
+
+#include <ctype.h>
+#include <errno.h>
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define SV_IMPLEMENTATION
+#include "sv.h"
+
+#define ARRAY_LEN(xs) (sizeof(xs) / sizeof((xs)[0]))
+#define RANDOM_INPUTS 200000
+#define RANDOM_NUMBERS 1000000
+#define MAP_KEYS 5000
+#define MAP_OPERATIONS 1000000
+#define FAILURES_PRINTED 20
+// Longer than two blocks of AVX2, so the needles cross several of them
+#define BOUNDARY_HAYSTACK 100
+#define BOUNDARY_NEEDLE_CAP 40
+
+static size_t failures = 0;
+
+static void fail(const char *name, String_View haystack, String_View needle, size_t got, size_t expected)
+{
+    if (failures < FAILURES_PRINTED) {
+        fprintf(stderr, "FAIL: %s: `"SV_Fmt"` in `"SV_Fmt"`: got %zu, expected %zu\n",
+                name, SV_Arg(needle), SV_Arg(haystack), got, expected);
+    }
+    failures += 1;
+}
+
+static uint64_t random_state = 0x9E3779B97F4A7C15ULL;
+
+static uint64_t random_next(void)
+{
+    random_state ^= random_state << 13;
+    random_state ^= random_state >> 7;
+    random_state ^= random_state << 17;
+    return random_state;
+}
+
+// Copies `data` into a buffer of exactly `count` bytes
+static char *exact_copy(const char *data, size_t count)
+{
+    char *copy = malloc(count > 0 ? count : 1);
+    if (copy == NULL) {
+        fprintf(stderr, "ERROR: could not allocate %zu bytes\n", count);
+        exit(1);
+    }
+    if (count > 0) memcpy(copy, data, count);
+    return copy;
+}
+
+static size_t naive_find(String_View haystack, String_View needle)
+{
+    for (size_t i = 0; i + needle.count <= haystack.count; ++i) {
+        if (memcmp(haystack.data + i, needle.data, needle.count) == 0) return i;
+    }
+    return haystack.count;
+}
+
+// sv_chop_by_sv() only takes the delimiters that end before the end of `sv`
+static String_View naive_chop_by_sv(String_View *sv, String_View delim)
+{
+    for (size_t i = 0; i + delim.count < sv->count; ++i) {
+        if (memcmp(sv->data + i, delim.data, delim.count) == 0) {
+            String_View result = sv_from_parts(sv->data, i);
+            sv->data += i + delim.count;
+            sv->count -= i + delim.count;
+            return result;
+        }
+    }
+    String_View result = *sv;
+    sv->data += sv->count;
+    sv->count = 0;
+    return result;
+}
+
+static void check_search(String_View haystack, String_View needle)
+{
+    char *h = exact_copy(haystack.data, haystack.count);
+    char *n = exact_copy(needle.data, needle.count);
+    String_View hs = sv_from_parts(h, haystack.count);
+    String_View ns = sv_from_parts(n, needle.count);
+
+    size_t expected = naive_find(hs, ns);
+    size_t got = sv__find(hs.data, hs.count, ns.data, ns.count);
+    if (got != expected) fail("sv__find", hs, ns, got, expected);
+
+    // Chop the whole haystack, so the delimiters after the first one are checked too
+    String_View a = hs;
+    String_View b = hs;
+    while (a.count > 0 || b.count > 0) {
+        String_View chunk = sv_chop_by_sv(&a, ns);
+        String_View expected_chunk = naive_chop_by_sv(&b, ns);
+        if (chunk.data != expected_chunk.data || chunk.count != expected_chunk.count ||
+            a.data != b.data || a.count != b.count) {
+            fail("sv_chop_by_sv", hs, ns, chunk.count, expected_chunk.count);
+            break;
+        }
+        // An empty delimiter never moves past the beginning
+        if (ns.count == 0) break;
+    }
+
+    if (ns.count == 1) {
+        size_t index = hs.count;
+        bool found = sv_index_of(hs, ns.data[0], &index);
+        expected = naive_find(hs, ns);
+        if (found != (expected < hs.count) || (found && index != expected)) {
+            fail("sv_index_of", hs, ns, found ? index : hs.count, expected);
+        }
+    }
+
+    free(h);
+    free(n);
+}
+
+// The needle at every offset of a haystack that is longer than two AVX2
+// blocks, so it starts, ends and crosses the block boundaries everywhere
+static void check_boundaries(void)
+{
+    char haystack[BOUNDARY_HAYSTACK];
+    char needle[BOUNDARY_NEEDLE_CAP];
+    for (size_t needle_count = 1; needle_count <= BOUNDARY_NEEDLE_CAP; ++needle_count) {
+        for (size_t j = 0; j < needle_count; ++j) needle[j] = (char) ('a' + j % 26);
+        String_View ns = sv_from_parts(needle, needle_count);
+
+        for (size_t offset = 0; offset + needle_count <= BOUNDARY_HAYSTACK; ++offset) {
+            memset(haystack, '.', sizeof(haystack));
+            memcpy(haystack + offset, needle, needle_count);
+            check_search(sv_from_parts(haystack, sizeof(haystack)), ns);
+            // Right at the end of a shorter haystack
+            check_search(sv_from_parts(haystack, offset + needle_count), ns);
+
+            // Only the first and the last characters match
+            if (needle_count > 2) {
+                haystack[offset + needle_count / 2] = '#';
+                check_search(sv_from_parts(haystack, sizeof(haystack)), ns);
+            }
+        }
+
+        // No match at all
+        memset(haystack, '.', sizeof(haystack));
+        check_search(sv_from_parts(haystack, sizeof(haystack)), ns);
+    }
+}
+
+static void check_edge_cases(void)
+{
+    static const struct { const char *haystack, *needle; } cases[] = {
+        {"", ""},
+        {"", "a"},
+        {"a", ""},
+        {"a", "a"},
+        {"a", "ab"},
+        {"ab", "ab"},
+        {"abab", "ab"},
+        {"aaaa", "aa"},
+        {"aaab", "aab"},
+        {"abc", "c"},
+        {"abc", "d"},
+        {"a = b = c", " = "},
+        {"line\r\nline\r\n", "\r\n"},
+    };
+    for (size_t i = 0; i < ARRAY_LEN(cases); ++i) {
+        check_search(sv_from_cstr(cases[i].haystack), sv_from_cstr(cases[i].needle));
+    }
+}
+
+// Small alphabets, so the partial matches are frequent
+static void check_random(void)
+{
+    char haystack[200];
+    char needle[40];
+    for (size_t i = 0; i < RANDOM_INPUTS; ++i) {
+        size_t haystack_count = random_next() % sizeof(haystack);
+        for (size_t j = 0; j < haystack_count; ++j) haystack[j] = (char) ('a' + random_next() % 3);
+
+        size_t needle_count = random_next() % sizeof(needle);
+        if (needle_count <= haystack_count && random_next() % 2 == 0) {
+            // A needle that occurs at least once
+            size_t at = random_next() % (haystack_count - needle_count + 1);
+            memcpy(needle, haystack + at, needle_count);
+        } else {
+            for (size_t j = 0; j < needle_count; ++j) needle[j] = (char) ('a' + random_next() % 3);
+        }
+        check_search(sv_from_parts(haystack, haystack_count), sv_from_parts(needle, needle_count));
+    }
+}
+
+static void fail_number(const char *name, String_View input, const char *got, const char *expected)
+{
+    if (failures < FAILURES_PRINTED) {
+        fprintf(stderr, "FAIL: %s: `"SV_Fmt"`: got %s, expected %s\n", name, SV_Arg(input), got, expected);
+    }
+    failures += 1;
+}
+
+// What the C library parses besides the format of sv.h: the leading whitespace,
+// the hexadecimal numbers and nan(...)
+static bool libc_only(const char *cstr)
+{
+    return isspace((unsigned char) cstr[0]) || strpbrk(cstr, "xX(") != NULL;
+}
+
+static bool all_digits(const char *cstr)
+{
+    if (*cstr == '\0') return false;
+    for (; *cstr != '\0'; ++cstr) {
+        if (!isdigit((unsigned char) *cstr)) return false;
+    }
+    return true;
+}
+
+static void check_integer(const char *cstr)
+{
+    // Every parser gets a copy of exactly the size of the number without the NULL
+    String_View input = sv_from_parts(exact_copy(cstr, strlen(cstr)), strlen(cstr));
+    char got[64], expected[64];
+
+    char *end = NULL;
+    errno = 0;
+    unsigned long long u = strtoull(cstr, &end, 10);
+    bool u_ok = all_digits(cstr + (cstr[0] == '+')) && errno != ERANGE;
+    uint64_t u_result = 0;
+    bool u_got = sv_parse_u64(input, &u_result);
+    if (u_got != u_ok || (u_ok && u_result != u)) {
+        snprintf(got, sizeof(got), u_got ? "%llu" : "false", (unsigned long long) u_result);
+        snprintf(expected, sizeof(expected), u_ok ? "%llu" : "false", u);
+        fail_number("sv_parse_u64", input, got, expected);
+    }
+
+    errno = 0;
+    long long i = strtoll(cstr, &end, 10);
+    bool i_ok = all_digits(cstr + (cstr[0] == '+' || cstr[0] == '-')) && errno != ERANGE;
+    int64_t i_result = 0;
+    bool i_got = sv_parse_i64(input, &i_result);
+    if (i_got != i_ok || (i_ok && i_result != i)) {
+        snprintf(got, sizeof(got), i_got ? "%lld" : "false", (long long) i_result);
+        snprintf(expected, sizeof(expected), i_ok ? "%lld" : "false", i);
+        fail_number("sv_parse_i64", input, got, expected);
+    }
+
+    // sv_to_u64() takes the digits up to the first character that is not one
+    size_t prefix = 0;
+    while (isdigit((unsigned char) cstr[prefix])) prefix += 1;
+    errno = 0;
+    u = prefix > 0 ? strtoull(cstr, NULL, 10) : 0;
+    if (errno != ERANGE && sv_to_u64(input) != u) {
+        snprintf(got, sizeof(got), "%llu", (unsigned long long) sv_to_u64(input));
+        snprintf(expected, sizeof(expected), "%llu", u);
+        fail_number("sv_to_u64", input, got, expected);
+    }
+
+    free((char*) input.data);
+}
+
+// The infinities are only accepted when they are written as such
+static bool is_infinity_literal(const char *cstr)
+{
+    return strpbrk(cstr, "iI") != NULL;
+}
+
+static void check_float(const char *cstr)
+{
+    String_View input = sv_from_parts(exact_copy(cstr, strlen(cstr)), strlen(cstr));
+    char got[64], expected[64];
+
+    char *end = NULL;
+    double d = strtod(cstr, &end);
+    bool valid = end != cstr && *end == '\0' && !libc_only(cstr);
+    bool d_ok = valid && (!isinf(d) || is_infinity_literal(cstr));
+    double d_result = 0.0;
+    bool d_got = sv_parse_f64(input, &d_result);
+    if (d_got != d_ok || (d_ok && memcmp(&d_result, &d, sizeof(d)) != 0 && !(isnan(d_result) && isnan(d)))) {
+        snprintf(got, sizeof(got), d_got ? "%.17g" : "false", d_result);
+        snprintf(expected, sizeof(expected), d_ok ? "%.17g" : "false", d);
+        fail_number("sv_parse_f64", input, got, expected);
+    }
+
+    float f = strtof(cstr, NULL);
+    bool f_ok = valid && (!isinf(f) || is_infinity_literal(cstr));
+    float f_result = 0.0f;
+    bool f_got = sv_parse_f32(input, &f_result);
+    if (f_got != f_ok || (f_ok && memcmp(&f_result, &f, sizeof(f)) != 0 && !(isnan(f_result) && isnan(f)))) {
+        snprintf(got, sizeof(got), f_got ? "%.9g" : "false", f_result);
+        snprintf(expected, sizeof(expected), f_ok ? "%.9g" : "false", f);
+        fail_number("sv_parse_f32", input, got, expected);
+    }
+
+    free((char*) input.data);
+}
+
+static void check_number_edge_cases(void)
+{
+    static const char *integers[] = {
+        "", "+", "-", "0", "-0", "+0", "+5", "-1", "1 ", " 1", "1e3", "0x10", "--1", "+-1", "12345678",
+        "123456789012345678", "000000000000000000000000000012",
+        "18446744073709551615", "18446744073709551616", "99999999999999999999", "184467440737095516150",
+        "9223372036854775807", "9223372036854775808", "-9223372036854775808", "-9223372036854775809",
+    };
+    static const char *floats[] = {
+        "", "+", "-", ".", "e5", "1e", "1e+", "1..2", "1e5.5", "--1", "+-1", "1 ", " 1", "1x", "0x10",
+        "4.2e1f", "infin", "nan(1)",
+        "0", "-0", "+0", "1", "1.", "-.5", ".5", "1e-5", "1E5", "0.1", "3.14159",
+        "inf", "-Infinity", "INF", "nan", "NaN", "-nan",
+        "1e308", "1.7976931348623157e308", "1.7976931348623158e308", "1.7976931348623159e308", "1e309",
+        "4.9e-324", "2.4703282292062327e-324", "2.4703282292062328e-324", "1e-400",
+        "2.2250738585072011e-308", "2.2250738585072012e-308",
+        "3.4028235e38", "3.4028236e38", "3.40282357e38", "1.4e-45", "7e-46",
+        "9007199254740993", "9007199254740992.5", "0.30000000000000004441", "16777217",
+        "1.00000005960464477539062500000001", "123456789012345678901234567890",
+        "0.000000000000000000000000000000001", "1e99999999999", "1e-99999999999",
+        "00000000000000000000000000001.5000000000000000000000000000",
+    };
+    for (size_t i = 0; i < ARRAY_LEN(integers); ++i) check_integer(integers[i]);
+    for (size_t i = 0; i < ARRAY_LEN(floats); ++i) check_float(floats[i]);
+}
+
+static void check_number_random(void)
+{
+    static const char alphabet[] = "0123456789+-.eEinfa";
+    char buffer[128];
+    for (size_t i = 0; i < RANDOM_NUMBERS; ++i) {
+        size_t n = 0;
+        switch (random_next() % 5) {
+        case 0: {
+            // Any finite double with 1 to 20 significant digits
+            uint64_t bits = random_next();
+            double x;
+            memcpy(&x, &bits, sizeof(x));
+            if (!isfinite(x)) continue;
+            snprintf(buffer, sizeof(buffer), "%.*g", (int) (random_next() % 20) + 1, x);
+        } break;
+        case 1: {
+            uint32_t bits = (uint32_t) random_next();
+            float x;
+            memcpy(&x, &bits, sizeof(x));
+            if (!isfinite(x)) continue;
+            snprintf(buffer, sizeof(buffer), "%.*g", (int) (random_next() % 12) + 1, x);
+        } break;
+        case 2: {
+            // Up to 30 digits before and 25 after the point, more than the 19 that fit
+            if (random_next() % 2) buffer[n++] = '-';
+            for (size_t j = random_next() % 30 + 1; j > 0; --j) buffer[n++] = (char) ('0' + random_next() % 10);
+            if (random_next() % 2) {
+                buffer[n++] = '.';
+                for (size_t j = random_next() % 25; j > 0; --j) buffer[n++] = (char) ('0' + random_next() % 10);
+            }
+            buffer[n] = '\0';
+            if (random_next() % 2) {
+                snprintf(buffer + n, sizeof(buffer) - n, "e%d", (int) (random_next() % 700) - 350);
+            }
+        } break;
+        case 3: {
+            // Integers of all the magnitudes
+            snprintf(buffer, sizeof(buffer), random_next() % 2 ? "%llu" : "-%llu",
+                     (unsigned long long) (random_next() >> random_next() % 64));
+        } break;
+        default: {
+            for (size_t j = random_next() % 12; j > 0; --j) buffer[n++] = alphabet[random_next() % (sizeof(alphabet) - 1)];
+            buffer[n] = '\0';
+        }
+        }
+        check_integer(buffer);
+        check_float(buffer);
+    }
+}
+
+static void fail_map(const char *name, size_t index, const char *what)
+{
+    if (failures < FAILURES_PRINTED) {
+        fprintf(stderr, "FAIL: %s: %zu: %s\n", name, index, what);
+    }
+    failures += 1;
+}
+
+static char map_key_data[MAP_KEYS][16];
+static String_View map_keys[MAP_KEYS];
+
+static void map_keys_init(void)
+{
+    for (size_t i = 0; i < MAP_KEYS; ++i) {
+        int n = snprintf(map_key_data[i], sizeof(map_key_data[i]), "key%zu", i);
+        map_keys[i] = sv_from_parts(map_key_data[i], (size_t) n);
+    }
+}
+
+// Every key of `present` has its value in `values`, the others are not in the map
+static void check_map_contents(const char *name, const SV_Map *map, const bool *present, const size_t *values)
+{
+    size_t count = 0;
+    for (size_t i = 0; i < MAP_KEYS; ++i) {
+        size_t value = 0;
+        bool found = sv_map_get(map, map_keys[i], &value);
+        if (found != present[i]) fail_map(name, i, found ? "found a missing key" : "lost the key");
+        else if (found && value != values[i]) fail_map(name, i, "wrong value");
+        count += present[i];
+    }
+    if (map->count != count) fail_map(name, map->count, "wrong count");
+}
+
+static void check_map_growth(void)
+{
+    static bool present[MAP_KEYS];
+    static size_t values[MAP_KEYS];
+    memset(present, 0, sizeof(present));
+    SV_Map map = {0};
+    size_t capacity = 0;
+    for (size_t i = 0; i < MAP_KEYS; ++i) {
+        if (!sv_map_put(&map, map_keys[i], i * 3)) exit(1);
+        present[i] = true;
+        values[i] = i * 3;
+        // All the keys right after every rehash
+        if (map.capacity != capacity) {
+            capacity = map.capacity;
+            if (map.count * 2 > map.capacity) fail_map("growth", i, "more than half of the slots occupied");
+            check_map_contents("growth", &map, present, values);
+        }
+    }
+    // Replacing the values does not add any keys
+    for (size_t i = 0; i < MAP_KEYS; ++i) {
+        if (!sv_map_put(&map, map_keys[i], i)) exit(1);
+        values[i] = i;
+    }
+    if (map.capacity != capacity) fail_map("growth", capacity, "grew on replacing the values");
+    check_map_contents("growth", &map, present, values);
+
+    sv_map_clear(&map);
+    memset(present, 0, sizeof(present));
+    check_map_contents("clear", &map, present, values);
+    sv_map_free(&map);
+}
+
+static void check_map_removed(void)
+{
+    SV_Map map = {0};
+    size_t value = 0;
+    if (sv_map_remove(&map, map_keys[0])) fail_map("remove", 0, "removed from an empty map");
+
+    // The same key goes back into its removed slot
+    if (!sv_map_put(&map, map_keys[0], 1)) exit(1);
+    if (!sv_map_remove(&map, map_keys[0])) fail_map("remove", 0, "did not remove the key");
+    if (sv_map_remove(&map, map_keys[0])) fail_map("remove", 0, "removed the key twice");
+    if (sv_map_get(&map, map_keys[0], &value)) fail_map("remove", 0, "found the removed key");
+    if (map.count != 0 || map.removed != 1) fail_map("remove", 0, "wrong count of the removed slots");
+    if (!sv_map_put(&map, map_keys[0], 2)) exit(1);
+    if (map.count != 1 || map.removed != 0) fail_map("remove", 0, "did not reuse the removed slot");
+    if (!sv_map_get(&map, map_keys[0], &value) || value != 2) fail_map("remove", 0, "lost the key put again");
+
+    // A few keys at a time and many removes never make the map grow,
+    // the removed slots are reused or rehashed away at the same capacity
+    size_t capacity = map.capacity;
+    for (size_t i = 1; i < MAP_KEYS; ++i) {
+        if (!sv_map_put(&map, map_keys[i], i)) exit(1);
+        if (i > 2 && !sv_map_remove(&map, map_keys[i - 2])) fail_map("remove", i - 2, "did not remove the key");
+        if ((map.count + map.removed) * 2 > map.capacity) fail_map("remove", i, "more than half of the slots used");
+    }
+    if (map.capacity != capacity) fail_map("remove", map.capacity, "grew with the removed slots");
+    for (size_t i = 0; i < MAP_KEYS; ++i) {
+        bool expected = i == 0 || i >= MAP_KEYS - 2;
+        if (sv_map_get(&map, map_keys[i], &value) != expected) fail_map("remove", i, "wrong key after the removes");
+    }
+    sv_map_free(&map);
+}
+
+static void check_map_random(void)
+{
+    static bool present[MAP_KEYS];
+    static size_t values[MAP_KEYS];
+    memset(present, 0, sizeof(present));
+    SV_Map map = {0};
+    // Few keys, so the slots are removed and reused all the time
+    size_t keys = 200;
+    for (size_t i = 0; i < MAP_OPERATIONS; ++i) {
+        size_t k = random_next() % keys;
+        size_t value = 0;
+        switch (random_next() % 3) {
+        case 0:
+            if (!sv_map_put(&map, map_keys[k], i)) exit(1);
+            present[k] = true;
+            values[k] = i;
+            break;
+        case 1:
+            if (sv_map_remove(&map, map_keys[k]) != present[k]) fail_map("random", k, "wrong result of the remove");
+            present[k] = false;
+            break;
+        default:
+            if (sv_map_get(&map, map_keys[k], &value) != present[k]) fail_map("random", k, "wrong result of the get");
+            else if (present[k] && value != values[k]) fail_map("random", k, "wrong value");
+        }
+        if (i % 100000 == 0) check_map_contents("random", &map, present, values);
+        // Then all the keys and back
+        if (i == MAP_OPERATIONS / 3) keys = MAP_KEYS;
+        if (i == MAP_OPERATIONS * 2 / 3) keys = 200;
+    }
+    check_map_contents("random", &map, present, values);
+    sv_map_free(&map);
+}
+
+// The empty string takes no room in the chunks but still gets a pointer of its own
+static void check_interner_empty(void)
+{
+    SV_Interner interner = {0};
+    String_View strings[] = {SV(""), SV("a"), SV(""), SV("bc"), SV("")};
+    size_t ids[ARRAY_LEN(strings)];
+    for (size_t i = 0; i < ARRAY_LEN(strings); ++i) {
+        if (!sv_intern(&interner, strings[i], &ids[i])) exit(1);
+    }
+    if (ids[0] != ids[2] || ids[0] != ids[4]) fail_map("sv_intern empty", ids[2], "another id for the empty string");
+    if (interner.count != 3) fail_map("sv_intern empty", interner.count, "wrong count of the strings");
+    for (size_t i = 0; i < interner.count; ++i) {
+        for (size_t j = i + 1; j < interner.count; ++j) {
+            if (interner.strings[i].data == interner.strings[j].data) {
+                fail_map("sv_intern empty", j, "the same pointer for different strings");
+            }
+        }
+    }
+    sv_interner_free(&interner);
+}
+
+static void check_interner(void)
+{
+    SV_Interner interner = {0};
+    static size_t ids[MAP_KEYS];
+    static const char *pointers[MAP_KEYS];
+    for (size_t i = 0; i < MAP_KEYS; ++i) {
+        if (!sv_intern(&interner, map_keys[i], &ids[i])) exit(1);
+        if (ids[i] != i) fail_map("sv_intern", i, "the ids are not consecutive");
+        String_View interned = interner.strings[ids[i]];
+        if (interned.data == map_keys[i].data || !sv_eq(interned, map_keys[i])) {
+            fail_map("sv_intern", i, "not a copy of the string");
+        }
+        pointers[i] = interned.data;
+    }
+
+    // The same content from another buffer, after the map and the chunks grew
+    for (size_t i = 0; i < MAP_KEYS; ++i) {
+        char *copy = exact_copy(map_keys[i].data, map_keys[i].count);
+        size_t id = 0;
+        if (!sv_intern(&interner, sv_from_parts(copy, map_keys[i].count), &id)) exit(1);
+        if (id != ids[i]) fail_map("sv_intern", i, "another id for the same content");
+        if (interner.strings[id].data != pointers[i]) fail_map("sv_intern", i, "another pointer for the same content");
+        free(copy);
+    }
+    if (interner.count != MAP_KEYS) fail_map("sv_intern", interner.count, "interned the same content twice");
+
+    // The empty string and the ones longer than a chunk
+    static char long_string[SV__INTERNER_CHUNK_CAPACITY * 2];
+    memset(long_string, 'a', sizeof(long_string));
+    String_View special[] = {SV(""), sv_from_parts(long_string, sizeof(long_string))};
+    for (size_t i = 0; i < ARRAY_LEN(special); ++i) {
+        size_t a = 0, b = 0;
+        if (!sv_intern(&interner, special[i], &a) || !sv_intern(&interner, special[i], &b)) exit(1);
+        if (a != b || !sv_eq(interner.strings[a], special[i])) fail_map("sv_intern", i, "wrong special string");
+    }
+    sv_interner_free(&interner);
+}
+
+int main(void)
+{
+    printf("sv.h paths: SSE2=%d AVX2=%d\n", SV_SSE2, SV_AVX2);
+
+    check_edge_cases();
+    check_boundaries();
+    check_random();
+    check_number_edge_cases();
+    check_number_random();
+    map_keys_init();
+    check_map_growth();
+    check_map_removed();
+    check_map_random();
+    check_interner();
+    check_interner_empty();
+
+    if (failures > 0) {
+        fprintf(stderr, "ERROR: %zu checks of sv.h failed\n", failures);
+        return 1;
+    }
+    printf("All checks passed\n");
+    return 0;
+}
@@ -0,0 +1,251 @@
+// Per-stage frame timing.
+//
+// CPU stages are measured with glfwGetTime() and accumulated over the frame,
+// so a stage that runs several times per frame (like r_sync_buffers) reports
+// its total. Stages may be nested: the SCENE and POST passes include the
+// vertex generation and the buffer syncing that happen inside of them.
+//
+// GPU passes are bracketed with GL_TIME_ELAPSED queries. The queries of every
+// frame go into their own slot of a ring, and a slot is only read back when
+// the ring wraps around to it TIMING_GPU_FRAMES frames later. If the result is
+// still not available by then, the sample is dropped instead of stalling.
+//
+// Every series keeps the last TIMING_SAMPLES_CAP samples for the percentiles.
+
+typedef enum {
+    STAGE_INPUT = 0,
+    STAGE_OBJECT_UPDATE,
+    STAGE_COLLISIONS,
+    STAGE_VERTEX_GEN,
+    STAGE_SYNC_BUFFERS,
+    STAGE_SCENE_PASS,
+    STAGE_POST_PASS,
+    STAGE_SWAP,
+    STAGE_FRAME,
+    COUNT_STAGES
+} Stage;
+
+static_assert(COUNT_STAGES == 9, "Update list of stage names");
+static const char *stage_names[COUNT_STAGES] = {
+    [STAGE_INPUT] = "input",
+    [STAGE_OBJECT_UPDATE] = "object_update",
+    [STAGE_COLLISIONS] = "collisions",
+    [STAGE_VERTEX_GEN] = "vertex generation",
+    [STAGE_SYNC_BUFFERS] = "r_sync_buffers",
+    [STAGE_SCENE_PASS] = "SCENE pass",
+    [STAGE_POST_PASS] = "POST pass",
+    [STAGE_SWAP] = "swap",
+    [STAGE_FRAME] = "frame",
+};
+
+typedef enum {
+    GPU_STAGE_SCENE_PASS = 0,
+    GPU_STAGE_POST_PASS,
+    COUNT_GPU_STAGES
+} Gpu_Stage;
+
+static_assert(COUNT_GPU_STAGES == 2, "Update list of GPU stage names");
+static const char *gpu_stage_names[COUNT_GPU_STAGES] = {
+    [GPU_STAGE_SCENE_PASS] = "SCENE pass (GPU)",
+    [GPU_STAGE_POST_PASS] = "POST pass (GPU)",
+};
+
+#define TIMING_SAMPLES_CAP 512
+#define TIMING_GPU_FRAMES 4
+
+typedef struct {
+    float samples[TIMING_SAMPLES_CAP];
+    size_t count;
+    size_t next;
+} Timing_Series;
+
+typedef struct {
+    Timing_Series cpu[COUNT_STAGES];
+    double cpu_started[COUNT_STAGES];
+    double cpu_accum[COUNT_STAGES];
+
+    bool gpu_enabled;
+    Timing_Series gpu[COUNT_GPU_STAGES];
+    GLuint gpu_queries[TIMING_GPU_FRAMES][COUNT_GPU_STAGES];
+    bool gpu_issued[TIMING_GPU_FRAMES][COUNT_GPU_STAGES];
+    size_t gpu_dropped;
+    // GPU time of the most recent frame whose queries were all collected
+    float gpu_frame;
+    bool gpu_frame_fresh;
+
+    size_t frame;
+    double frame_started;
+} Timing;
+
+static Timing timing = {0};
+
+void timing_series_push(Timing_Series *series, float sample)
+{
+    series->samples[series->next] = sample;
+    series->next = (series->next + 1) % TIMING_SAMPLES_CAP;
+    if (series->count < TIMING_SAMPLES_CAP) series->count += 1;
+}
+
+static int compare_floats(const void *a, const void *b)
+{
+    float x = *(const float*) a;
+    float y = *(const float*) b;
+    return (x > y) - (x < y);
+}
+
+// `ps` are the requested percentiles in [0, 1], `out` gets the values in the same order.
+// Sorts `samples` in place.
+void percentiles(float *samples, size_t count, const float *ps, float *out, size_t n)
+{
+    qsort(samples, count, sizeof(samples[0]), compare_floats);
+    for (size_t i = 0; i < n; ++i) {
+        out[i] = count > 0 ? samples[(size_t) (ps[i] * (count - 1) + 0.5f)] : 0.0f;
+    }
+}
+
+void timing_series_percentiles(const Timing_Series *series, const float *ps, float *out, size_t n)
+{
+    float sorted[TIMING_SAMPLES_CAP];
+    memcpy(sorted, series->samples, series->count * sizeof(sorted[0]));
+    percentiles(sorted, series->count, ps, out, n);
+}
+
+// Must be called after the GL extensions are loaded
+void timing_init(void)
+{
+    timing.gpu_enabled = glGenQueries != NULL && glGetQueryObjectui64v != NULL;
+    if (timing.gpu_enabled) {
+        glGenQueries(TIMING_GPU_FRAMES * COUNT_GPU_STAGES, &timing.gpu_queries[0][0]);
+    } else {
+        fprintf(stderr, "WARN: GPU timing is disabled, timer queries are not supported\n");
+    }
+    timing.frame_started = glfwGetTime();
+}
+
+// Every stage is also a zone of the trace
+void stage_begin(Stage stage)
+{
+    TRACE_BEGIN(stage_names[stage]);
+    timing.cpu_started[stage] = glfwGetTime();
+}
+
+void stage_end(Stage stage)
+{
+    timing.cpu_accum[stage] += glfwGetTime() - timing.cpu_started[stage];
+    TRACE_END();
+}
+
+void gpu_stage_begin(Gpu_Stage stage)
+{
+    if (!timing.gpu_enabled) return;
+    size_t slot = timing.frame % TIMING_GPU_FRAMES;
+    glBeginQuery(GL_TIME_ELAPSED, timing.gpu_queries[slot][stage]);
+    timing.gpu_issued[slot][stage] = true;
+}
+
+void gpu_stage_end(Gpu_Stage stage)
+{
+    (void) stage;
+    if (!timing.gpu_enabled) return;
+    glEndQuery(GL_TIME_ELAPSED);
+}
+
+// Collects the results of the oldest slot right before it is reused
+static void timing_collect_gpu(size_t slot)
+{
+    float gpu_frame = 0.0f;
+    bool complete = true;
+    bool issued = false;
+    for (Gpu_Stage stage = 0; stage < COUNT_GPU_STAGES; ++stage) {
+        if (!timing.gpu_issued[slot][stage]) continue;
+        timing.gpu_issued[slot][stage] = false;
+        issued = true;
+
+        GLuint query = timing.gpu_queries[slot][stage];
+        GLint available = 0;
+        glGetQueryObjectiv(query, GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available) {
+            timing.gpu_dropped += 1;
+            complete = false;
+            continue;
+        }
+
+        GLuint64 elapsed_ns = 0;
+        glGetQueryObjectui64v(query, GL_QUERY_RESULT, &elapsed_ns);
+        timing_series_push(&timing.gpu[stage], (float) (elapsed_ns * 1e-9));
+        gpu_frame += (float) (elapsed_ns * 1e-9);
+    }
+
+    // The frames that did not draw anything say nothing about the GPU load
+    if (complete && issued) {
+        timing.gpu_frame = gpu_frame;
+        timing.gpu_frame_fresh = true;
+    }
+}
+
+// GPU time of all the passes of a recent frame (TIMING_GPU_FRAMES frames
+// late). Returns false if there is no new measurement since the last call.
+bool timing_gpu_frame(float *secs)
+{
+    if (!timing.gpu_frame_fresh) return false;
+    timing.gpu_frame_fresh = false;
+    *secs = timing.gpu_frame;
+    return true;
+}
+
+void timing_frame_end(void)
+{
+    double now = glfwGetTime();
+    timing.cpu_accum[STAGE_FRAME] = now - timing.frame_started;
+    timing.frame_started = now;
+
+    for (Stage stage = 0; stage < COUNT_STAGES; ++stage) {
+        timing_series_push(&timing.cpu[stage], (float) timing.cpu_accum[stage]);
+        timing.cpu_accum[stage] = 0.0;
+    }
+
+    timing.frame += 1;
+    if (timing.gpu_enabled) {
+        timing_collect_gpu(timing.frame % TIMING_GPU_FRAMES);
+    }
+}
+
+// Forgets all the samples, including the GPU queries that are still in flight
+void timing_reset(void)
+{
+    memset(timing.cpu, 0, sizeof(timing.cpu));
+    memset(timing.gpu, 0, sizeof(timing.gpu));
+    memset(timing.gpu_issued, 0, sizeof(timing.gpu_issued));
+    timing.gpu_dropped = 0;
+    timing.gpu_frame_fresh = false;
+}
+
+static void timing_print_series(const char *name, const Timing_Series *series)
+{
+    static const float ps[] = {0.50f, 0.95f, 0.99f};
+    float values[3];
+    timing_series_percentiles(series, ps, values, 3);
+    printf("  %-20s %9.3f %9.3f %9.3f\n", name, values[0] * 1000.0f, values[1] * 1000.0f, values[2] * 1000.0f);
+}
+
+void timing_print(void)
+{
+    const Timing_Series *frame = &timing.cpu[STAGE_FRAME];
+    float p50;
+    static const float median = 0.5f;
+    timing_series_percentiles(frame, &median, &p50, 1);
+    printf("Frame timing over the last %zu frames: %.1f FPS (median)\n",
+           frame->count, p50 > 0.0f ? 1.0f / p50 : 0.0f);
+    printf("  %-20s %9s %9s %9s\n", "stage (ms)", "p50", "p95", "p99");
+    for (Stage stage = 0; stage < COUNT_STAGES; ++stage) {
+        timing_print_series(stage_names[stage], &timing.cpu[stage]);
+    }
+    if (timing.gpu_enabled) {
+        for (Gpu_Stage stage = 0; stage < COUNT_GPU_STAGES; ++stage) {
+            timing_print_series(gpu_stage_names[stage], &timing.gpu[stage]);
+        }
+        if (timing.gpu_dropped > 0) {
+            printf("  %zu GPU samples were not ready in time and dropped\n", timing.gpu_dropped);
+        }
+    }
+}
@@ -0,0 +1,175 @@
+// Timeline of instrumented zones exported in the Chrome trace format.
+// Open the dumped file in chrome://tracing or https://ui.perfetto.dev/
+//
+// Every thread records the begin/end events of its zones into its own
+// Spsc_Queue, so recording is a timer read and a couple of stores without any
+// locks or allocations. The GL thread moves the recorded events into a
+// big ring of the most recent events in trace_collect() every frame, and
+// trace_dump() writes that ring out as JSON.
+//
+// USAGE:
+//   TRACE_ZONE("name") {
+//       ...
+//   }
+// or TRACE_BEGIN("name") and TRACE_END() on the same thread when the zone can
+// not be a block. Do not return out of TRACE_ZONE, the zone would never end.
+// The names must outlive the trace (use string literals).
+
+// The job workers record into the slots of their indices, so the restarted
+// workers reuse them. Any other thread takes one of the remaining slots.
+#define TRACE_THREADS_CAP (JOBS_WORKERS_CAP + 16)
+#define TRACE_THREAD_EVENTS_CAP (16 * 1024)
+#define TRACE_EVENTS_CAP (256 * 1024)
+
+typedef struct {
+    const char *name;
+    uint64_t timestamp;
+    uint32_t tid;
+    char phase;
+} Trace_Event;
+
+typedef struct {
+    Spsc_Queue threads[TRACE_THREADS_CAP];
+    atomic_bool threads_ready[TRACE_THREADS_CAP];
+    // Threads other than the job workers
+    atomic_size_t other_threads_count;
+    atomic_size_t dropped;
+
+    // Owned by the thread that calls trace_collect() and trace_dump()
+    Trace_Event *events;
+    size_t events_count;
+    size_t events_next;
+    uint64_t timer_start;
+    // Set once before any other thread is started
+    bool initialized;
+} Trace;
+
+static Trace trace = {0};
+static _Thread_local Spsc_Queue *trace_thread = NULL;
+static _Thread_local uint32_t trace_tid = 0;
+
+static void trace_thread_attach(size_t tid);
+
+// Must be called once from the GL thread before any zone is recorded.
+// The GL thread becomes the thread 0 of the trace.
+void trace_init(void)
+{
+    trace.events = malloc(TRACE_EVENTS_CAP * sizeof(*trace.events));
+    if (trace.events == NULL) {
+        fprintf(stderr, "ERROR: could not allocate memory for the trace: %s\n", strerror(errno));
+        exit(1);
+    }
+    trace.timer_start = glfwGetTimerValue();
+    // The job workers are not started yet, but the GL thread is always the worker 0
+    trace_thread_attach(0);
+    trace.initialized = true;
+}
+
+// The previous thread of a reused slot has exited (it was joined before the
+// new one was created), so the new one simply continues its queue.
+static void trace_thread_attach(size_t tid)
+{
+    Spsc_Queue *q = &trace.threads[tid];
+    if (!atomic_load_explicit(&trace.threads_ready[tid], memory_order_relaxed)) {
+        spsc_queue_init(q, TRACE_THREAD_EVENTS_CAP, sizeof(Trace_Event));
+        // Publish the initialized queue to trace_collect()
+        atomic_store_explicit(&trace.threads_ready[tid], true, memory_order_release);
+    }
+    trace_thread = q;
+    trace_tid = (uint32_t) tid;
+}
+
+static bool trace_thread_register(void)
+{
+    size_t tid;
+    if (jobs_worker_index >= 0) {
+        tid = (size_t) jobs_worker_index;
+    } else {
+        tid = JOBS_WORKERS_CAP + atomic_fetch_add(&trace.other_threads_count, 1);
+        if (tid >= TRACE_THREADS_CAP) {
+            atomic_fetch_sub(&trace.other_threads_count, 1);
+            return false;
+        }
+    }
+    trace_thread_attach(tid);
+    return true;
+}
+
+static void trace_record(const char *name, char phase)
+{
+    if (!trace.initialized) return;
+    if (trace_thread == NULL && !trace_thread_register()) return;
+    Trace_Event event = {
+        .name = name,
+        .timestamp = glfwGetTimerValue(),
+        .tid = trace_tid,
+        .phase = phase,
+    };
+    if (!spsc_queue_push(trace_thread, &event)) {
+        atomic_fetch_add_explicit(&trace.dropped, 1, memory_order_relaxed);
+    }
+}
+
+#define TRACE_BEGIN(name) trace_record((name), 'B')
+#define TRACE_END() trace_record(NULL, 'E')
+#define TRACE_ZONE(name) \
+    for (int trace_zone_once = (TRACE_BEGIN(name), 0); !trace_zone_once; trace_zone_once = (TRACE_END(), 1))
+
+// Moves the events recorded by all of the threads into the ring of the most recent events
+void trace_collect(void)
+{
+    for (size_t i = 0; i < TRACE_THREADS_CAP; ++i) {
+        if (!atomic_load_explicit(&trace.threads_ready[i], memory_order_acquire)) continue;
+        Spsc_Queue *q = &trace.threads[i];
+        while (spsc_queue_pop(q, &trace.events[trace.events_next])) {
+            trace.events_next = (trace.events_next + 1) % TRACE_EVENTS_CAP;
+            if (trace.events_count < TRACE_EVENTS_CAP) trace.events_count += 1;
+        }
+    }
+}
+
+bool trace_dump(const char *file_path)
+{
+    trace_collect();
+
+    FILE *f = fopen(file_path, "w");
+    if (f == NULL) {
+        fprintf(stderr, "ERROR: could not open %s: %s\n", file_path, strerror(errno));
+        return false;
+    }
+
+    double usecs_per_tick = 1e6 / (double) glfwGetTimerFrequency();
+    size_t first = (trace.events_next + TRACE_EVENTS_CAP - trace.events_count) % TRACE_EVENTS_CAP;
+
+    fprintf(f, "{\"traceEvents\":[\n");
+    for (size_t i = 0; i < trace.events_count; ++i) {
+        const Trace_Event *e = &trace.events[(first + i) % TRACE_EVENTS_CAP];
+        double ts = (double) (e->timestamp - trace.timer_start) * usecs_per_tick;
+        if (e->phase == 'B') {
+            fprintf(f, "{\"name\":\"%s\",\"ph\":\"B\",\"ts\":%.3f,\"pid\":0,\"tid\":%u},\n", e->name, ts, e->tid);
+        } else {
+            fprintf(f, "{\"ph\":\"E\",\"ts\":%.3f,\"pid\":0,\"tid\":%u},\n", ts, e->tid);
+        }
+    }
+    bool first_name = true;
+    for (size_t tid = 0; tid < TRACE_THREADS_CAP; ++tid) {
+        if (!atomic_load_explicit(&trace.threads_ready[tid], memory_order_acquire)) continue;
+        const char *name = tid == 0 ? "main" : tid < JOBS_WORKERS_CAP ? "worker" : "thread";
+        fprintf(f, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":%zu,\"args\":{\"name\":\"%s %zu\"}}\n",
+                first_name ? "" : ",", tid, name, tid);
+        first_name = false;
+    }
+    fprintf(f, "]}\n");
+
+    bool ok = !ferror(f);
+    if (!ok) {
+        fprintf(stderr, "ERROR: could not write %s: %s\n", file_path, strerror(errno));
+    }
+    fclose(f);
+
+    size_t dropped = atomic_load(&trace.dropped);
+    printf("Dumped %zu trace events to %s", trace.events_count, file_path);
+    if (dropped > 0) printf(" (%zu events were dropped)", dropped);
+    printf("\n");
+    return ok;
+}